@@ -35,9 +35,8 @@ class OTFFTBenchmarkConan(ConanFile):
         # FFTW as the primary/standard FFT library - always required
         self.requires("fftw/3.3.10")
         
-        # OTFFT - required on x86_64, will be dynamically detected by CMake
-        if self.settings.arch == "x86_64":
-            self.requires("otfft/11.5@")
+        # OTFFT - x86 SSE/AVX or armv8 NEON kernels, detected by CMake
+        self.requires("otfft/11.5@")
         
         # Other FFT libraries for comparison
         self.requires("kissfft/131.1.0")
@@ -12,11 +12,48 @@
 #include <sstream>
 #include <sys/utsname.h>
 #include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#ifdef __linux__
+#include <sched.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 // OTFFT headers (now optional)
 #ifdef HAVE_OTFFT
 #include "otfft.h"
 #include "otfft_fwd.h"
+#include "otfft_ext/fft_float.h"
+#include "otfft_ext/batch.h"
+#include "otfft_ext/cpu_dispatch.h"
+#include "otfft_ext/plan_cache.h"
+#include "otfft_ext/stft.h"
+#include "otfft_ext/convolution.h"
+#include "otfft_ext/fft_nd.h"
+#include "otfft_ext/split.h"
+#include "otfft_ext/real_compact.h"
+#include "otfft_ext/workspace.h"
+#include "otfft_ext/parallel.h"
+#include "otfft_ext/mixed_radix.h"
+#include "otfft_ext/partial.h"
+#include "otfft_ext/sliding_dft.h"
+#include "otfft_ext/fixed.h"
+#include "otfft_ext/wisdom.h"
+#include "otfft_ext/out_of_core.h"
+#include "otfft_ext/pipeline.h"
+#include "otfft_ext/dct.h"
 #endif
 
 // FFTW3 headers (primary/standard FFT library)
@@ -47,6 +84,211 @@
 
 using namespace std;
 
+// Number of same-size transforms per call in the batched tests
+static const int BATCH_COUNT = 64;
+
+// STFT tests: frames per call, with a hop of a quarter frame
+static const int STFT_FRAMES = 16;
+
+// Sliding DFT tests: hops (spectra) per call
+static const int SDFT_HOPS = 16;
+
+// Convolution tests: samples per call and partition size of the FFT engine
+static const int CONV_CHUNK = 8192;
+static const int CONV_BLOCK = 1024;
+
+// Chunk of the sequential file copy in the out-of-core table
+static const size_t OOC_CHUNK = size_t(4) << 20;
+
+// Rows of the DCT/DST table, in OTFFT::R2RKind order, then the MDCT of N
+// coefficients from 2N samples
+static const char* const R2R_LABELS[] = {"DCT-I", "DCT-II", "DCT-III", "DCT-IV",
+                                         "DST-I", "DST-II", "DST-III", "DST-IV", "MDCT"};
+static const int R2R_ROWS = 9;
+static const int R2R_MDCT = 8;
+
+// Points of a DCT/DST table row: the type I transforms run at N+1 (DCT)
+// and N-1 (DST), the lengths whose real FFT has N points
+static int r2r_length(int size, int kind) {
+    return kind == 0 ? size + 1 : kind == 4 ? size - 1 : size;
+}
+
+// Periodic Hann window, as used by default by the extension STFT
+static vector<double> stft_window(int n) {
+    vector<double> w(n);
+    for (int j = 0; j < n; ++j) w[j] = 0.5 - 0.5 * cos(2.0 * M_PI * j / n);
+    return w;
+}
+
+// Input and output files of the out-of-core table
+static string ooc_path(const string& dir, int size, const char* ext) {
+    ostringstream path;
+    path << dir << "/otfft_bench_" << size << "." << ext;
+    return path.str();
+}
+
+// A FILE* closed when it goes out of scope, also when a short read or
+// write throws
+typedef unique_ptr<FILE, int (*)(FILE*)> FilePtr;
+
+static FilePtr open_file(const string& path, const char* mode) {
+    FilePtr f(fopen(path.c_str(), mode), fclose);
+    if (!f) throw runtime_error("cannot open " + path);
+    return f;
+}
+
+static void write_ooc_input(const string& path, int size) {
+    vector<double> chunk;
+    FilePtr f = open_file(path, "wb");
+    for (long long i = 0; i < size; i += (long long)(OOC_CHUNK / 16)) {
+        const long long n = min<long long>(OOC_CHUNK / 16, size - i);
+        chunk.resize(2 * n);
+        for (long long j = 0; j < n; ++j) {
+            chunk[2 * j] = sin(0.37 * (i + j));
+            chunk[2 * j + 1] = cos(0.011 * (i + j));
+        }
+        if (fwrite(chunk.data(), 16, size_t(n), f.get()) != size_t(n)) throw runtime_error("cannot write " + path);
+    }
+}
+
+// Hardware event counts of the calling thread from Linux perf_event_open.
+// Every event gets its own counter, so a PMU without one of them still
+// gives the others, and counts are scaled up when the kernel multiplexes
+// them. Only user space is counted, which perf_event_paranoid 2 (the usual
+// default) allows. Events that cannot be opened (no PMU in a VM or
+// container, a stricter paranoid setting, another OS) read as NaN.
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, DTLB_MISSES, BRANCH_MISSES, EVENTS };
+    
+    PerfCounters() : error_(0) {
+        for (int e = 0; e < EVENTS; ++e) fd_[e] = open_event(Event(e));
+    }
+    
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int e = 0; e < EVENTS; ++e) {
+            if (fd_[e] >= 0) close(fd_[e]);
+        }
+#endif
+    }
+    
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    
+    bool available() const {
+        for (int e = 0; e < EVENTS; ++e) {
+            if (fd_[e] >= 0) return true;
+        }
+        return false;
+    }
+    
+    // errno of the first event that could not be opened, 0 if none failed
+    // or there is no perf_event_open
+    int error() const { return error_; }
+    
+    void start() {
+#ifdef __linux__
+        for (int e = 0; e < EVENTS; ++e) {
+            if (fd_[e] < 0) continue;
+            ioctl(fd_[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    
+    // Counts since start(), NaN for the events not counted
+    void stop(double* counts) {
+        for (int e = 0; e < EVENTS; ++e) {
+            counts[e] = NAN;
+#ifdef __linux__
+            if (fd_[e] < 0) continue;
+            ioctl(fd_[e], PERF_EVENT_IOC_DISABLE, 0);
+            // value, time enabled, time running
+            unsigned long long v[3];
+            if (read(fd_[e], v, sizeof(v)) == ssize_t(sizeof(v)) && v[2] > 0) {
+                counts[e] = double(v[0]) * (double(v[1]) / double(v[2]));
+            }
+#endif
+        }
+    }
+    
+    // JSON and CSV field name
+    static const char* name(Event e) {
+        static const char* const names[] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"
+        };
+        return names[e];
+    }
+    
+private:
+    int fd_[EVENTS];
+    int error_;
+    
+    int open_event(Event e) {
+#ifdef __linux__
+        perf_event_attr attr = perf_event_attr();
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        switch (e) {
+        case CYCLES: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case INSTRUCTIONS: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case LLC_MISSES: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case BRANCH_MISSES: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        default:
+            // Read misses of the L1 data cache or the data TLB
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = (e == L1D_MISSES ? PERF_COUNT_HW_CACHE_L1D : PERF_COUNT_HW_CACHE_DTLB) |
+                          (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        }
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const int fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0 && !error_) error_ = errno;
+        return fd;
+#else
+        (void)e;
+        return -1;
+#endif
+    }
+};
+
+// Statistic the tables report for each benchmark
+enum TableStat { STAT_MEAN, STAT_MIN, STAT_MEDIAN, STAT_P99 };
+
+// Per-call times in microseconds over the samples of one run. Each sample
+// is the average of one batch of back-to-back calls. With --counters, also
+// the hardware events per call over all samples.
+struct BenchmarkStats {
+    int iterations;
+    int samples;
+    double mean_us;
+    double min_us;
+    double median_us;
+    double p99_us;
+    double stddev_us;
+    double counters[PerfCounters::EVENTS];  // NaN when not counted
+    
+    BenchmarkStats() : iterations(0), samples(0), mean_us(0), min_us(0), median_us(0), p99_us(0), stddev_us(0) {
+        for (int e = 0; e < PerfCounters::EVENTS; ++e) counters[e] = NAN;
+    }
+    
+    // Instructions per cycle
+    double ipc() const { return counters[PerfCounters::INSTRUCTIONS] / counters[PerfCounters::CYCLES]; }
+    
+    double value(TableStat stat) const {
+        switch (stat) {
+        case STAT_MIN: return min_us;
+        case STAT_MEDIAN: return median_us;
+        case STAT_P99: return p99_us;
+        default: return mean_us;
+        }
+    }
+};
+
 // Abstract base class for FFT benchmarks
 class FFTBenchmark {
 protected:
@@ -54,8 +296,17 @@ protected:
     double min_duration_seconds_;
     string name_;
     int actual_iterations_;  // Store actual number of iterations performed
+    BenchmarkStats stats_;
     
 public:
+    // Shared by all benchmarks; set from the command line
+    static double warmup_seconds;
+    static TableStat table_stat;
+    static bool use_counters;
+    
+    // Fewest samples per run, however long a single call takes
+    static const int MIN_SAMPLES = 10;
+    
     FFTBenchmark(const string& name, int size, double min_duration_seconds = 1.0) 
         : name_(name), size_(size), min_duration_seconds_(min_duration_seconds), actual_iterations_(0) {}
     
@@ -70,36 +321,105 @@ public:
     // Cleanup (not timed)
     virtual void cleanup() = 0;
     
-    // Run the benchmark and return average time in microseconds
-    // Runs for at least min_duration_seconds
+    // False if the library cannot transform this size; the table then
+    // shows n/a instead of running it
+    virtual bool supported() const { return true; }
+    
+    // Run the benchmark and return the table statistic (the mean unless
+    // --stat says otherwise) of the time per call in microseconds.
+    // After warmup_seconds of untimed calls, calls are timed in batches of
+    // about a thousandth of min_duration_seconds each, until the batches
+    // add up to min_duration_seconds and there are at least MIN_SAMPLES.
+    // With use_counters the hardware counters run over the timed batches.
     double run() {
         setup();
         
-        int iterations = 0;
+        // Warmup: caches, page faults and clock ramp-up stay out of the
+        // samples, and the average call time sizes the batches
+        int warmup_calls = 0;
         auto start = chrono::high_resolution_clock::now();
-        auto elapsed = chrono::duration<double>(0);
-        
-        // Run for at least the minimum duration
+        chrono::duration<double> elapsed(0);
         do {
             execute();
-            iterations++;
+            warmup_calls++;
             elapsed = chrono::high_resolution_clock::now() - start;
-        } while (elapsed.count() < min_duration_seconds_);
+        } while (elapsed.count() < warmup_seconds);
+        
+        // Batches of at least 20 us keep clock overhead out of the samples
+        const double call_seconds = elapsed.count() / warmup_calls;
+        const double batch_seconds = max(min_duration_seconds_ / 1000.0, 20e-6);
+        const int batch = int(max(1.0, min(batch_seconds / call_seconds, 1e6)));
+        
+        unique_ptr<PerfCounters> counters;
+        if (use_counters) {
+            counters.reset(new PerfCounters());
+            counters->start();
+        }
+        
+        vector<double> samples;
+        int iterations = 0;
+        double total_us = 0.0;
+        do {
+            auto t0 = chrono::high_resolution_clock::now();
+            for (int i = 0; i < batch; ++i) execute();
+            auto t1 = chrono::high_resolution_clock::now();
+            const double us = chrono::duration<double, micro>(t1 - t0).count();
+            samples.push_back(us / batch);
+            total_us += us;
+            iterations += batch;
+        } while (total_us < 1e6 * min_duration_seconds_ || samples.size() < size_t(MIN_SAMPLES));
+        
+        double counts[PerfCounters::EVENTS];
+        if (counters) counters->stop(counts);
         
-        auto end = chrono::high_resolution_clock::now();
         cleanup();
         
         actual_iterations_ = iterations;
-        chrono::duration<double, micro> duration = end - start;
-        return duration.count() / iterations;
+        stats_ = summarize(samples, total_us / iterations, iterations);
+        if (counters) {
+            for (int e = 0; e < PerfCounters::EVENTS; ++e) stats_.counters[e] = counts[e] / iterations;
+        }
+        return stats_.value(table_stat);
     }
     
     string getName() const { return name_; }
     int getSize() const { return size_; }
     int getActualIterations() const { return actual_iterations_; }
+    const BenchmarkStats& getStats() const { return stats_; }
+    
+    // Nearest-rank percentiles over the sorted samples; stddev is the
+    // sample standard deviation of the samples
+    static BenchmarkStats summarize(vector<double> samples, double mean_us, int iterations) {
+        sort(samples.begin(), samples.end());
+        const size_t n = samples.size();
+        BenchmarkStats st;
+        st.iterations = iterations;
+        st.samples = int(n);
+        st.mean_us = mean_us;
+        st.min_us = samples[0];
+        st.median_us = n % 2 ? samples[n / 2] : 0.5 * (samples[n / 2 - 1] + samples[n / 2]);
+        st.p99_us = samples[size_t(ceil(0.99 * n)) - 1];
+        double mean = 0.0, var = 0.0;
+        for (size_t i = 0; i < n; ++i) mean += samples[i];
+        mean /= n;
+        for (size_t i = 0; i < n; ++i) var += (samples[i] - mean) * (samples[i] - mean);
+        st.stddev_us = n > 1 ? sqrt(var / (n - 1)) : 0.0;
+        return st;
+    }
 };
 
+double FFTBenchmark::warmup_seconds = 0.1;
+TableStat FFTBenchmark::table_stat = STAT_MEAN;
+bool FFTBenchmark::use_counters = false;
+
 #ifdef HAVE_OTFFT
+// Sizes the extension transforms run: no prime factor above 7, and even
+// with N/2 such a size for the real ones
+static bool ext_supports(int size, bool is_real) {
+    if (is_real) return size % 2 == 0 && OTFFT::detail::is_smooth(size / 2);
+    return OTFFT::detail::is_smooth(size);
+}
+
 // OTFFT Complex FFT Benchmark
 class OTFFTComplexBenchmark : public FFTBenchmark {
 private:
@@ -129,580 +449,2983 @@ public:
     }
 };
 
-// OTFFT Real FFT Benchmark
-class OTFFTRealBenchmark : public FFTBenchmark {
+// OTFFT extension measuring planner: the fastest of upstream's transform and
+// the extension kernel variants for the size, measured in setup() unless
+// the wisdom already holds the size
+class OTFFTTunedBenchmark : public FFTBenchmark {
 private:
-    vector<double> data_;
-    vector<OTFFT::complex_t> spectrum_;
-    OTFFT::RealFFTPtr rfft_;
+    vector<OTFFT::complex_t> data_;
+    OTFFT::TunedFFTPtr fft_;
     
 public:
-    OTFFTRealBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("OTFFT", size, min_duration) {}
+    OTFFTTunedBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTtuned", size, min_duration) {}
     
     void setup() override {
         data_.resize(size_);
-        spectrum_.resize(size_);
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
         }
-        rfft_ = OTFFT::Factory::createRealFFT(size_);
+        fft_ = OTFFT::FactoryExt::createTunedFFT(size_);
     }
     
     void execute() override {
-        rfft_->fwd(data_.data(), spectrum_.data());
+        fft_->fwd(data_.data());
     }
     
     void cleanup() override {
-        rfft_.reset();
+        fft_.reset();
         data_.clear();
-        spectrum_.clear();
     }
 };
-#endif // HAVE_OTFFT
 
-#ifdef HAVE_FFTW3
-// FFTW3 Complex FFT Benchmark
-class FFTW3ComplexBenchmark : public FFTBenchmark {
+// OTFFT extension complex FFT of any size: mixed-radix Stockham passes for
+// 7-smooth sizes, Bluestein for the others
+class OTFFTMixedRadixBenchmark : public FFTBenchmark {
 private:
-    fftw_complex* in_;
-    fftw_complex* out_;
-    fftw_plan plan_;
+    vector<OTFFT::complex_t> data_;
+    OTFFT::MixedRadixFFTPtr fft_;
     
 public:
-    FFTW3ComplexBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("FFTW3", size, min_duration), in_(nullptr), out_(nullptr), plan_(nullptr) {}
+    OTFFTMixedRadixBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTmix", size, min_duration) {}
     
     void setup() override {
-        in_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_);
-        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_);
-        
+        data_.resize(size_);
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            in_[i][0] = sin(t) + 0.5 * sin(5.0 * t);
-            in_[i][1] = 0.0;
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
         }
-        
-        plan_ = fftw_plan_dft_1d(size_, in_, out_, FFTW_FORWARD, FFTW_MEASURE);
+        fft_ = OTFFT::FactoryExt::createMixedRadixFFT(size_);
     }
     
     void execute() override {
-        fftw_execute(plan_);
+        fft_->fwd(data_.data());
     }
     
     void cleanup() override {
-        if (plan_) fftw_destroy_plan(plan_);
-        if (in_) fftw_free(in_);
-        if (out_) fftw_free(out_);
+        fft_.reset();
+        data_.clear();
     }
 };
 
-// FFTW3 Real FFT Benchmark
-class FFTW3RealBenchmark : public FFTBenchmark {
+// OTFFT extension FixedFFT<N>: a codelet compiled for one size, called
+// through a pointer here so that one column can cover the powers of two up
+// to 64 (inlined at the call site, it would not even pay that call)
+class OTFFTFixedBenchmark : public FFTBenchmark {
 private:
-    double* in_;
-    fftw_complex* out_;
-    fftw_plan plan_;
+    typedef void (*fixed_fn)(const OTFFT::complex_t* x, OTFFT::complex_t* y);
+    
+    vector<OTFFT::complex_t> data_;
+    vector<OTFFT::complex_t> out_;
+    
+    static fixed_fn lookup(int size) {
+        switch (size) {
+        case 2: return &OTFFT::FixedFFT<2>::fwd<OTFFT::complex_t>;
+        case 4: return &OTFFT::FixedFFT<4>::fwd<OTFFT::complex_t>;
+        case 8: return &OTFFT::FixedFFT<8>::fwd<OTFFT::complex_t>;
+        case 16: return &OTFFT::FixedFFT<16>::fwd<OTFFT::complex_t>;
+        case 32: return &OTFFT::FixedFFT<32>::fwd<OTFFT::complex_t>;
+        case 64: return &OTFFT::FixedFFT<64>::fwd<OTFFT::complex_t>;
+        default: return nullptr;
+        }
+    }
     
 public:
-    FFTW3RealBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("FFTW3", size, min_duration), in_(nullptr), out_(nullptr), plan_(nullptr) {}
+    OTFFTFixedBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTfix", size, min_duration) {}
+    
+    bool supported() const override { return lookup(size_) != nullptr; }
     
     void setup() override {
-        in_ = (double*)fftw_malloc(sizeof(double) * size_);
-        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (size_/2 + 1));
-        
+        data_.resize(size_);
+        out_.resize(size_);
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            in_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
         }
-        
-        plan_ = fftw_plan_dft_r2c_1d(size_, in_, out_, FFTW_MEASURE);
     }
     
     void execute() override {
-        fftw_execute(plan_);
+        lookup(size_)(data_.data(), out_.data());
     }
     
     void cleanup() override {
-        if (plan_) fftw_destroy_plan(plan_);
-        if (in_) fftw_free(in_);
-        if (out_) fftw_free(out_);
+        data_.clear();
+        out_.clear();
     }
 };
-#endif
 
-#ifdef HAVE_MKL
-// Intel MKL Complex FFT Benchmark
-class MKLComplexBenchmark : public FFTBenchmark {
+// OTFFT Real FFT Benchmark: N/2+1 output bins, like FFTW's r2c and the
+// other libraries in the table
+class OTFFTRealBenchmark : public FFTBenchmark {
 private:
-    vector<complex<double>> data_;
-    DFTI_DESCRIPTOR_HANDLE handle_;
+    vector<double> data_;
+    vector<OTFFT::complex_t> spectrum_;
+    OTFFT::CompactRealFFTPtr rfft_;
     
 public:
-    MKLComplexBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("MKL", size, min_duration), handle_(nullptr) {}
+    OTFFTRealBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTFFT", size, min_duration) {}
+    
+    bool supported() const override { return ext_supports(size_, true); }
     
     void setup() override {
         data_.resize(size_);
+        spectrum_.resize(size_/2 + 1);
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            data_[i] = complex<double>(sin(t) + 0.5 * sin(5.0 * t), 0.0);
+            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
         }
-        
-        DftiCreateDescriptor(&handle_, DFTI_DOUBLE, DFTI_COMPLEX, 1, size_);
-        DftiSetValue(handle_, DFTI_PLACEMENT, DFTI_INPLACE);
-        DftiCommitDescriptor(handle_);
+        rfft_ = OTFFT::FactoryExt::createCompactRealFFT(size_);
     }
     
     void execute() override {
-        DftiComputeForward(handle_, data_.data());
+        rfft_->fwd(data_.data(), spectrum_.data());
     }
     
     void cleanup() override {
-        if (handle_) DftiFreeDescriptor(&handle_);
+        rfft_.reset();
         data_.clear();
+        spectrum_.clear();
     }
 };
 
-// Intel MKL Real FFT Benchmark
-class MKLRealBenchmark : public FFTBenchmark {
+// OTFFT single-precision Complex FFT Benchmark
+class OTFFTFloatComplexBenchmark : public FFTBenchmark {
 private:
-    vector<double> data_;
-    DFTI_DESCRIPTOR_HANDLE handle_;
+    vector<OTFFT::complexf_t> data_;
+    OTFFT::ComplexFFTfPtr fft_;
     
 public:
-    MKLRealBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("MKL", size, min_duration), handle_(nullptr) {}
+    OTFFTFloatComplexBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTFFTf", size, min_duration) {}
+    
+    bool supported() const override { return ext_supports(size_, false); }
     
     void setup() override {
-        data_.resize(size_ + 2, 0.0);
+        data_.resize(size_);
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i] = OTFFT::complexf_t(sin(t) + 0.5 * sin(5.0 * t), 0.0f);
         }
-        
-        DftiCreateDescriptor(&handle_, DFTI_DOUBLE, DFTI_REAL, 1, size_);
-        DftiSetValue(handle_, DFTI_PLACEMENT, DFTI_INPLACE);
-        DftiSetValue(handle_, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-        DftiCommitDescriptor(handle_);
+        fft_ = OTFFT::FactoryExt::createComplexFFTf(size_);
     }
     
     void execute() override {
-        DftiComputeForward(handle_, data_.data());
+        fft_->fwd(data_.data());
     }
     
     void cleanup() override {
-        if (handle_) DftiFreeDescriptor(&handle_);
+        fft_.reset();
         data_.clear();
     }
 };
-#endif
 
-#ifdef HAVE_KISSFFT
-// KissFFT Complex FFT Benchmark
-class KissFFTComplexBenchmark : public FFTBenchmark {
+// OTFFT single-precision Real FFT Benchmark, N/2+1 output bins
+class OTFFTFloatRealBenchmark : public FFTBenchmark {
 private:
-    vector<kiss_fft_cpx> in_;
-    vector<kiss_fft_cpx> out_;
-    kiss_fft_cfg cfg_;
+    vector<float> data_;
+    vector<OTFFT::complexf_t> spectrum_;
+    OTFFT::CompactRealFFTfPtr rfft_;
     
 public:
-    KissFFTComplexBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("Kiss", size, min_duration), cfg_(nullptr) {}
+    OTFFTFloatRealBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTFFTf", size, min_duration) {}
+    
+    bool supported() const override { return ext_supports(size_, true); }
     
     void setup() override {
-        in_.resize(size_);
-        out_.resize(size_);
-        
+        data_.resize(size_);
+        spectrum_.resize(size_/2 + 1);
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            in_[i].r = sin(t) + 0.5 * sin(5.0 * t);
-            in_[i].i = 0.0;
+            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
         }
-        
-        cfg_ = kiss_fft_alloc(size_, 0, nullptr, nullptr);
+        rfft_ = OTFFT::FactoryExt::createCompactRealFFTf(size_);
     }
     
     void execute() override {
-        kiss_fft(cfg_, in_.data(), out_.data());
+        rfft_->fwd(data_.data(), spectrum_.data());
     }
     
     void cleanup() override {
-        if (cfg_) kiss_fft_free(cfg_);
-        in_.clear();
-        out_.clear();
+        rfft_.reset();
+        data_.clear();
+        spectrum_.clear();
     }
 };
-
-// KissFFT Real FFT Benchmark
-class KissFFTRealBenchmark : public FFTBenchmark {
+// OTFFT Complex FFT, one Factory object called once per transform
+class OTFFTLoopComplexBenchmark : public FFTBenchmark {
 private:
-    vector<kiss_fft_scalar> in_;
-    vector<kiss_fft_cpx> out_;
-    kiss_fftr_cfg cfg_;
+    vector<OTFFT::complex_t> data_;
+    OTFFT::ComplexFFTPtr fft_;
+    int count_;
     
 public:
-    KissFFTRealBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("Kiss", size, min_duration), cfg_(nullptr) {}
+    OTFFTLoopComplexBenchmark(int size, int count, double min_duration = 1.0) 
+        : FFTBenchmark("OTFFT", size, min_duration), count_(count) {}
     
     void setup() override {
-        in_.resize(size_);
-        out_.resize(size_/2 + 1);
-        
-        for (int i = 0; i < size_; ++i) {
+        data_.resize(size_ * count_);
+        for (int i = 0; i < size_ * count_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            in_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
         }
-        
-        cfg_ = kiss_fftr_alloc(size_, 0, nullptr, nullptr);
+        fft_ = OTFFT::Factory::createComplexFFT(size_);
     }
     
     void execute() override {
-        kiss_fftr(cfg_, in_.data(), out_.data());
+        for (int b = 0; b < count_; ++b) {
+            fft_->fwd(data_.data() + b * size_);
+        }
     }
     
     void cleanup() override {
-        if (cfg_) kiss_fftr_free(cfg_);
-        in_.clear();
-        out_.clear();
+        fft_.reset();
+        data_.clear();
     }
 };
-#endif
 
-#ifdef HAVE_PFFFT
-// PFFFT Complex FFT Benchmark
-class PFFFFTComplexBenchmark : public FFTBenchmark {
+// OTFFT batched Complex FFT Benchmark
+class OTFFTBatchComplexBenchmark : public FFTBenchmark {
 private:
-    vector<float> data_;
-    vector<float> work_;
-    PFFFT_Setup* setup_;
+    vector<OTFFT::complex_t> data_;
+    OTFFT::BatchComplexFFTPtr fft_;
+    int count_;
     
 public:
-    PFFFFTComplexBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("PFFFT", size, min_duration), setup_(nullptr) {}
+    OTFFTBatchComplexBenchmark(int size, int count, double min_duration = 1.0) 
+        : FFTBenchmark("OTbatch", size, min_duration), count_(count) {}
     
     void setup() override {
-        data_.resize(size_ * 2);
-        work_.resize(size_ * 2);
-        
-        for (int i = 0; i < size_; ++i) {
+        data_.resize(size_ * count_);
+        for (int i = 0; i < size_ * count_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            data_[i * 2] = sin(t) + 0.5 * sin(5.0 * t);
-            data_[i * 2 + 1] = 0.0;
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
         }
-        
-        setup_ = pffft_new_setup(size_, PFFFT_COMPLEX);
+        fft_ = OTFFT::FactoryExt::createBatchComplexFFT(size_);
     }
     
     void execute() override {
-        pffft_transform_ordered(setup_, data_.data(), data_.data(), work_.data(), PFFFT_FORWARD);
+        fft_->fwd(count_, data_.data(), 1, size_);
     }
     
     void cleanup() override {
-        if (setup_) pffft_destroy_setup(setup_);
+        fft_.reset();
         data_.clear();
-        work_.clear();
     }
 };
 
-// PFFFT Real FFT Benchmark
-class PFFFFTRealBenchmark : public FFTBenchmark {
+// OTFFT Real FFT, one Factory object called once per transform
+class OTFFTLoopRealBenchmark : public FFTBenchmark {
 private:
-    vector<float> data_;
-    vector<float> work_;
-    PFFFT_Setup* setup_;
+    vector<double> data_;
+    vector<OTFFT::complex_t> spectrum_;
+    OTFFT::RealFFTPtr rfft_;
+    int count_;
     
 public:
-    PFFFFTRealBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("PFFFT", size, min_duration), setup_(nullptr) {}
+    OTFFTLoopRealBenchmark(int size, int count, double min_duration = 1.0) 
+        : FFTBenchmark("OTFFT", size, min_duration), count_(count) {}
     
     void setup() override {
-        data_.resize(size_);
-        work_.resize(size_);
-        
-        for (int i = 0; i < size_; ++i) {
+        data_.resize(size_ * count_);
+        spectrum_.resize(size_ * count_);
+        for (int i = 0; i < size_ * count_; ++i) {
             double t = 2.0 * M_PI * i / size_;
             data_[i] = sin(t) + 0.5 * sin(5.0 * t);
         }
-        
-        setup_ = pffft_new_setup(size_, PFFFT_REAL);
+        rfft_ = OTFFT::Factory::createRealFFT(size_);
     }
     
     void execute() override {
-        pffft_transform_ordered(setup_, data_.data(), data_.data(), work_.data(), PFFFT_FORWARD);
+        for (int b = 0; b < count_; ++b) {
+            rfft_->fwd(data_.data() + b * size_, spectrum_.data() + b * size_);
+        }
     }
     
     void cleanup() override {
-        if (setup_) pffft_destroy_setup(setup_);
+        rfft_.reset();
         data_.clear();
-        work_.clear();
+        spectrum_.clear();
     }
 };
-#endif
 
-#ifdef HAVE_POCKETFFT
-// PocketFFT Complex FFT Benchmark
-class PocketFFTComplexBenchmark : public FFTBenchmark {
+// OTFFT batched Real FFT Benchmark (N/2+1 bins per transform)
+class OTFFTBatchRealBenchmark : public FFTBenchmark {
 private:
-    vector<complex<double>> data_;
-    pocketfft::shape_t shape_;
-    pocketfft::stride_t stride_;
-    pocketfft::shape_t axes_;
+    vector<double> data_;
+    vector<OTFFT::complex_t> spectrum_;
+    OTFFT::BatchRealFFTPtr rfft_;
+    int count_;
     
 public:
-    PocketFFTComplexBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("Pocket", size, min_duration) {}
+    OTFFTBatchRealBenchmark(int size, int count, double min_duration = 1.0) 
+        : FFTBenchmark("OTbatch", size, min_duration), count_(count) {}
     
     void setup() override {
-        data_.resize(size_);
-        
-        for (int i = 0; i < size_; ++i) {
+        data_.resize(size_ * count_);
+        spectrum_.resize((size_/2 + 1) * count_);
+        for (int i = 0; i < size_ * count_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            data_[i] = complex<double>(sin(t) + 0.5 * sin(5.0 * t), 0.0);
+            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
         }
-        
-        shape_ = {static_cast<size_t>(size_)};
-        stride_ = {static_cast<ptrdiff_t>(sizeof(complex<double>))};
-        axes_ = {0};
+        rfft_ = OTFFT::FactoryExt::createBatchRealFFT(size_);
     }
     
     void execute() override {
-        pocketfft::c2c(shape_, stride_, stride_, axes_, pocketfft::FORWARD, 
-                       data_.data(), data_.data(), 1.0);
+        rfft_->fwd(count_, data_.data(), 1, size_, spectrum_.data(), 1, size_/2 + 1);
     }
     
     void cleanup() override {
+        rfft_.reset();
         data_.clear();
+        spectrum_.clear();
+    }
+};
+// OTFFT plan creation: one Factory object created and destroyed per call
+class OTFFTPlanBenchmark : public FFTBenchmark {
+private:
+    bool is_real_;
+    
+public:
+    OTFFTPlanBenchmark(int size, bool is_real, double min_duration = 1.0) 
+        : FFTBenchmark("OTFFT", size, min_duration), is_real_(is_real) {}
+    
+    void setup() override {}
+    
+    void execute() override {
+        if (is_real_) OTFFT::Factory::createRealFFT(size_);
+        else OTFFT::Factory::createComplexFFT(size_);
     }
+    
+    void cleanup() override {}
 };
 
-// PocketFFT Real FFT Benchmark
-class PocketFFTRealBenchmark : public FFTBenchmark {
+// OTFFT single-precision plan creation, with or without the plan cache.
+// Without it the cache is cleared before every call, so each call builds
+// the twiddle tables from scratch.
+class OTFFTFloatPlanBenchmark : public FFTBenchmark {
 private:
-    vector<double> data_;
-    vector<complex<double>> out_;
-    pocketfft::shape_t shape_;
-    pocketfft::stride_t stride_in_;
-    pocketfft::stride_t stride_out_;
-    pocketfft::shape_t axes_;
+    bool is_real_;
+    bool cached_;
     
 public:
-    PocketFFTRealBenchmark(int size, double min_duration = 1.0) 
-        : FFTBenchmark("Pocket", size, min_duration) {}
+    OTFFTFloatPlanBenchmark(int size, bool is_real, bool cached, double min_duration = 1.0) 
+        : FFTBenchmark(cached ? "OTcache" : "OTFFTf", size, min_duration), is_real_(is_real), cached_(cached) {}
+    
+    void setup() override {
+        OTFFT::PlanCache::instance().clear();
+    }
+    
+    void execute() override {
+        if (!cached_) OTFFT::PlanCache::instance().clear();
+        if (is_real_) OTFFT::FactoryExt::createRealFFTf(size_);
+        else OTFFT::FactoryExt::createComplexFFTf(size_);
+    }
+    
+    void cleanup() override {
+        OTFFT::PlanCache::instance().clear();
+    }
+};
+// OTFFT single-precision FFT with the kernel set forced to one ISA level
+class OTFFTIsaBenchmark : public FFTBenchmark {
+private:
+    bool is_real_;
+    OTFFT::IsaLevel level_;
+    vector<float> real_;
+    vector<OTFFT::complexf_t> data_;
+    OTFFT::ComplexFFTfPtr fft_;
+    OTFFT::RealFFTfPtr rfft_;
+    
+public:
+    OTFFTIsaBenchmark(int size, bool is_real, OTFFT::IsaLevel level, double min_duration = 1.0) 
+        : FFTBenchmark(OTFFT::CpuDispatch::name(level), size, min_duration), is_real_(is_real), level_(level) {}
     
     void setup() override {
+        real_.resize(size_);
         data_.resize(size_);
-        out_.resize(size_/2 + 1);
-        
         for (int i = 0; i < size_; ++i) {
             double t = 2.0 * M_PI * i / size_;
-            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            real_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i] = OTFFT::complexf_t(real_[i], 0.0f);
         }
-        
-        shape_ = {static_cast<size_t>(size_)};
-        stride_in_ = {static_cast<ptrdiff_t>(sizeof(double))};
-        stride_out_ = {static_cast<ptrdiff_t>(sizeof(complex<double>))};
-        axes_ = {0};
+        OTFFT::CpuDispatch::force(level_);
+        if (is_real_) rfft_ = OTFFT::FactoryExt::createRealFFTf(size_);
+        else fft_ = OTFFT::FactoryExt::createComplexFFTf(size_);
+        OTFFT::CpuDispatch::reset();
     }
     
     void execute() override {
-        pocketfft::r2c(shape_, stride_in_, stride_out_, axes_, pocketfft::FORWARD,
-                       data_.data(), out_.data(), 1.0);
+        if (is_real_) rfft_->fwd(real_.data(), data_.data());
+        else fft_->fwd(data_.data());
     }
     
     void cleanup() override {
+        fft_.reset();
+        rfft_.reset();
+        real_.clear();
         data_.clear();
-        out_.clear();
     }
 };
-#endif
 
-// Function to get the system architecture using the uname() system call
-std::string get_architecture() {
-    struct utsname buffer;
-    if (uname(&buffer) != 0) {
-        throw std::runtime_error("Failed to call uname()");
-    }
-    return buffer.machine;
-}
+// OTFFT extension transform forced to the AVX-512 kernels; double precision
+// goes through the batch API with a count of one
+class OTFFTAvx512Benchmark : public FFTBenchmark {
+private:
+    bool is_real_;
+    bool is_float_;
+    vector<double> real_;
+    vector<OTFFT::complex_t> data_;
+    vector<float> realf_;
+    vector<OTFFT::complexf_t> dataf_;
+    OTFFT::BatchComplexFFTPtr fft_;
+    OTFFT::BatchRealFFTPtr rfft_;
+    OTFFT::ComplexFFTfPtr fftf_;
+    OTFFT::RealFFTfPtr rfftf_;
 
-// Function to get the CPU model name by reading /proc/cpuinfo
-std::string get_cpu_model() {
-    std::ifstream cpuinfo("/proc/cpuinfo");
-    std::string line;
+public:
+    OTFFTAvx512Benchmark(int size, bool is_real, bool is_float, double min_duration = 1.0)
+        : FFTBenchmark(is_float ? "OTf512" : "OT512", size, min_duration), is_real_(is_real), is_float_(is_float) {}
 
-    if (!cpuinfo.is_open()) {
-        throw std::runtime_error("Could not open /proc/cpuinfo");
-    }
+    bool supported() const override { return ext_supports(size_, is_real_); }
 
-    // Loop through the file line by line
-    while (std::getline(cpuinfo, line)) {
-        // Look for the line that specifies the human-readable model name
-        if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
-            // Find the colon and take the rest of the string as the model name
-            size_t colon_pos = line.find(':');
-            if (colon_pos != std::string::npos) {
-                // Trim leading whitespace and return the model name (only needs to be read once)
-                std::string model = line.substr(colon_pos + 1);
-                // Trim leading whitespace
-                size_t first_char = model.find_first_not_of(" \t");
-                if (first_char != std::string::npos) {
-                    return model.substr(first_char);
-                }
-            }
+    void setup() override {
+        real_.resize(size_);
+        data_.resize(size_);
+        realf_.resize(size_);
+        dataf_.resize(size_);
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            real_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i] = OTFFT::complex_t(real_[i], 0.0);
+            realf_[i] = float(real_[i]);
+            dataf_[i] = OTFFT::complexf_t(realf_[i], 0.0f);
         }
+        OTFFT::CpuDispatch::force(OTFFT::ISA_AVX512);
+        if (is_float_ && is_real_) rfftf_ = OTFFT::FactoryExt::createRealFFTf(size_);
+        else if (is_float_) fftf_ = OTFFT::FactoryExt::createComplexFFTf(size_);
+        else if (is_real_) rfft_ = OTFFT::FactoryExt::createBatchRealFFT(size_);
+        else fft_ = OTFFT::FactoryExt::createBatchComplexFFT(size_);
+        OTFFT::CpuDispatch::reset();
     }
 
-    return "Model name not found in /proc/cpuinfo";
-}
+    void execute() override {
+        if (is_float_ && is_real_) rfftf_->fwd(realf_.data(), dataf_.data());
+        else if (is_float_) fftf_->fwd(dataf_.data());
+        else if (is_real_) rfft_->fwd(1, real_.data(), 1, size_, data_.data(), 1, size_);
+        else fft_->fwd(1, data_.data(), 1, size_);
+    }
 
-// Benchmark result holder
-struct BenchmarkResult {
-    string library;
-    double time_us;
-    double ratio;  // Relative to baseline (OTFFT)
-    
-    BenchmarkResult(const string& lib, double time, double base_time) 
-        : library(lib), time_us(time) {
-        ratio = time_us / base_time;
+    void cleanup() override {
+        fft_.reset();
+        rfft_.reset();
+        fftf_.reset();
+        rfftf_.reset();
+        real_.clear();
+        data_.clear();
+        realf_.clear();
+        dataf_.clear();
     }
 };
 
-// Benchmark runner and table formatter
-class BenchmarkRunner {
+// Hand-rolled STFT around the upstream RealFFT: shift the history by one
+// hop, append the new samples, window into a temporary, transform
+class OTFFTLoopSTFTBenchmark : public FFTBenchmark {
 private:
-    vector<unique_ptr<FFTBenchmark>> benchmarks_;
-    double min_duration_seconds_;
-    static const int LABEL_WIDTH = 15;
-    static const int COL_SIZE_WIDTH = 5;
-    static const int TIME_WIDTH = 7;
-    static const int RATIO_WIDTH = 6;
+    int hop_;
+    vector<double> signal_;
+    vector<double> history_;
+    vector<double> window_;
+    vector<double> frame_;
+    vector<OTFFT::complex_t> spectrum_;
+    OTFFT::RealFFTPtr rfft_;
     
-    void create_benchmarks(int size, bool is_real) {
-        benchmarks_.clear();
-        
-        // FFTW3 is the primary/baseline library
-#ifdef HAVE_FFTW3
-        if (is_real) benchmarks_.push_back(unique_ptr<FFTBenchmark>(new FFTW3RealBenchmark(size, min_duration_seconds_)));
-        else benchmarks_.push_back(unique_ptr<FFTBenchmark>(new FFTW3ComplexBenchmark(size, min_duration_seconds_)));
-#endif
-#ifdef HAVE_OTFFT
-        if (is_real) benchmarks_.push_back(unique_ptr<FFTBenchmark>(new OTFFTRealBenchmark(size, min_duration_seconds_)));
-        else benchmarks_.push_back(unique_ptr<FFTBenchmark>(new OTFFTComplexBenchmark(size, min_duration_seconds_)));
-#endif
-#ifdef HAVE_KISSFFT
-        if (is_real) benchmarks_.push_back(unique_ptr<FFTBenchmark>(new KissFFTRealBenchmark(size, min_duration_seconds_)));
-        else benchmarks_.push_back(unique_ptr<FFTBenchmark>(new KissFFTComplexBenchmark(size, min_duration_seconds_)));
-#endif
-#ifdef HAVE_PFFFT
-        if (is_real) benchmarks_.push_back(unique_ptr<FFTBenchmark>(new PFFFFTRealBenchmark(size, min_duration_seconds_)));
-        else benchmarks_.push_back(unique_ptr<FFTBenchmark>(new PFFFFTComplexBenchmark(size, min_duration_seconds_)));
-#endif
-#ifdef HAVE_POCKETFFT
-        if (is_real) benchmarks_.push_back(unique_ptr<FFTBenchmark>(new PocketFFTRealBenchmark(size, min_duration_seconds_)));
-        else benchmarks_.push_back(unique_ptr<FFTBenchmark>(new PocketFFTComplexBenchmark(size, min_duration_seconds_)));
-#endif
-#ifdef HAVE_MKL
-        if (is_real) benchmarks_.push_back(unique_ptr<FFTBenchmark>(new MKLRealBenchmark(size, min_duration_seconds_)));
-        else benchmarks_.push_back(unique_ptr<FFTBenchmark>(new MKLComplexBenchmark(size, min_duration_seconds_)));
-#endif
+public:
+    OTFFTLoopSTFTBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("OTloop", size, min_duration), hop_(size / 4) {}
+    
+    void setup() override {
+        signal_.resize(size_t(STFT_FRAMES) * hop_);
+        for (size_t i = 0; i < signal_.size(); ++i) signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+        history_.assign(size_, 0.0);
+        window_ = stft_window(size_);
+        frame_.resize(size_);
+        spectrum_.resize(size_);
+        rfft_ = OTFFT::Factory::createRealFFT(size_);
     }
     
-    int calculate_table_width() const {
-        int width = LABEL_WIDTH + COL_SIZE_WIDTH + 3;  // Label + Size + separators
-        width += TIME_WIDTH + 2;  // Baseline library time + separators
-        
-        // Each additional library adds: time + ratio + separators
-        for (size_t i = 1; i < benchmarks_.size(); ++i) {
-            width += TIME_WIDTH + RATIO_WIDTH + 4;
+    void execute() override {
+        for (int f = 0; f < STFT_FRAMES; ++f) {
+            std::copy(history_.begin() + hop_, history_.end(), history_.begin());
+            std::copy(signal_.begin() + f * hop_, signal_.begin() + (f + 1) * hop_, history_.end() - hop_);
+            for (int j = 0; j < size_; ++j) frame_[j] = history_[j] * window_[j];
+            rfft_->fwd(frame_.data(), spectrum_.data());
         }
-        
-        return width;
     }
     
-    void print_banner() const {
-        int width = calculate_table_width();
-        cout << string(width, '=') << endl;
-        cout << setw(width/2 + 20) << "FFT Performance Comparison Benchmark" << endl;
-        cout << string(width, '=') << endl;
-        
-        // Print compiler information
-        cout << "Compiler: ";
-#if defined(__GNUC__) && !defined(__clang__)
-        cout << "GCC " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
-#elif defined(__clang__)
-        cout << "Clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
-#elif defined(_MSC_VER)
-        cout << "MSVC " << _MSC_VER;
-#else
-        cout << "Unknown";
-#endif
-        cout << " CPU: " << get_architecture() << " " << get_cpu_model();
-        cout << endl;
-        
-        cout << "Comparing:";
-        for (const auto& bench : benchmarks_) {
-            cout << " " << bench->getName();
-            if (bench != benchmarks_.back()) cout << " |";
-        }
-        cout << endl;
-        cout << "Min test duration: " << min_duration_seconds_ << " second(s)" << endl;
-        cout << "Times shown in microseconds (μs)" << endl;
-        cout << string(width, '=') << endl;
+    void cleanup() override {
+        rfft_.reset();
+        signal_.clear();
+        history_.clear();
+        frame_.clear();
+        spectrum_.clear();
     }
+};
+
+// Extension STFT fed one chunk of STFT_FRAMES hops per call
+class OTFFTSTFTBenchmark : public FFTBenchmark {
+private:
+    bool is_float_;
+    int hop_;
+    vector<double> signal_;
+    vector<float> signalf_;
+    vector<OTFFT::complex_t> frames_;
+    vector<OTFFT::complexf_t> framesf_;
+    OTFFT::STFTPtr stft_;
+    OTFFT::STFTfPtr stftf_;
     
-    void print_table_header() const {
-        cout << left << setw(LABEL_WIDTH) << "Test Type";
-        cout << right << setw(COL_SIZE_WIDTH) << "Size" << " |";
-        
-        // First library (baseline - typically FFTW3)
-        cout << right << setw(TIME_WIDTH) << benchmarks_[0]->getName() << " |";
-        
-        // Other libraries with ratio column
-        for (size_t i = 1; i < benchmarks_.size(); ++i) {
-            cout << right << setw(TIME_WIDTH) << benchmarks_[i]->getName() << " |";
-            cout << right << setw(RATIO_WIDTH) << "Ratio" << " |";
+public:
+    OTFFTSTFTBenchmark(int size, bool is_float, double min_duration = 1.0) 
+        : FFTBenchmark(is_float ? "OTstftf" : "OTstft", size, min_duration), is_float_(is_float), hop_(size / 4) {}
+    
+    void setup() override {
+        signal_.resize(size_t(STFT_FRAMES) * hop_);
+        signalf_.resize(signal_.size());
+        for (size_t i = 0; i < signal_.size(); ++i) {
+            signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+            signalf_[i] = float(signal_[i]);
         }
-        cout << endl;
-        
-        cout << string(calculate_table_width(), '-') << endl;
+        frames_.resize(size_t(STFT_FRAMES) * (size_ / 2 + 1));
+        framesf_.resize(frames_.size());
+        if (is_float_) stftf_ = OTFFT::FactoryExt::createSTFTf(size_, hop_);
+        else stft_ = OTFFT::FactoryExt::createSTFT(size_, hop_);
     }
     
-    void print_results_row(const string& label, int size, const vector<BenchmarkResult>& results) const {
-        cout << left << setw(LABEL_WIDTH) << label;
-        cout << right << setw(COL_SIZE_WIDTH) << size << " |";
-        
-        // First library (baseline) time
-        cout << fixed << setprecision(2) << setw(TIME_WIDTH) << results[0].time_us << " |";
-        
-        // Other libraries with ratio
-        for (size_t i = 1; i < results.size(); ++i) {
-            cout << fixed << setprecision(2) << setw(TIME_WIDTH) << results[i].time_us << " |";
-            cout << fixed << setprecision(2) << setw(RATIO_WIDTH-1) << results[i].ratio << "x |";
-        }
-        cout << endl;
+    void execute() override {
+        if (is_float_) stftf_->process(signalf_.data(), int(signalf_.size()), framesf_.data());
+        else stft_->process(signal_.data(), int(signal_.size()), frames_.data());
+    }
+    
+    void cleanup() override {
+        stft_.reset();
+        stftf_.reset();
+        signal_.clear();
+        signalf_.clear();
+        frames_.clear();
+        framesf_.clear();
     }
+};
+
+// Extension partitioned overlap-save convolution, CONV_CHUNK samples per call
+class OTFFTConvolutionBenchmark : public FFTBenchmark {
+private:
+    bool is_float_;
+    vector<double> signal_;
+    vector<double> output_;
+    vector<float> signalf_;
+    vector<float> outputf_;
+    OTFFT::ConvolutionPtr conv_;
+    OTFFT::ConvolutionfPtr convf_;
     
 public:
-    BenchmarkRunner(double min_duration_seconds = 1.0) : min_duration_seconds_(min_duration_seconds) {}
+    // size is the number of filter taps
+    OTFFTConvolutionBenchmark(int size, bool is_float, double min_duration = 1.0) 
+        : FFTBenchmark(is_float ? "OTconvf" : "OTconv", size, min_duration), is_float_(is_float) {}
     
-    void run_complex_benchmarks(const vector<int>& sizes) {
-        // Create benchmarks once for banner and header
-        create_benchmarks(sizes[0], false);
-        print_banner();
-        cout << "\n========== COMPLEX FFT TESTS ==========" << endl;
+    void setup() override {
+        vector<double> h(size_);
+        vector<float> hf(size_);
+        for (int k = 0; k < size_; ++k) {
+            h[k] = exp(-4.0 * k / size_) * sin(0.1 * k);
+            hf[k] = float(h[k]);
+        }
+        signal_.resize(CONV_CHUNK);
+        signalf_.resize(CONV_CHUNK);
+        for (int i = 0; i < CONV_CHUNK; ++i) {
+            signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+            signalf_[i] = float(signal_[i]);
+        }
+        output_.resize(CONV_CHUNK);
+        outputf_.resize(CONV_CHUNK);
+        if (is_float_) convf_ = OTFFT::FactoryExt::createConvolutionf(hf.data(), size_, CONV_BLOCK);
+        else conv_ = OTFFT::FactoryExt::createConvolution(h.data(), size_, CONV_BLOCK);
+    }
+    
+    void execute() override {
+        if (is_float_) convf_->process(signalf_.data(), CONV_CHUNK, outputf_.data());
+        else conv_->process(signal_.data(), CONV_CHUNK, output_.data());
+    }
+    
+    void cleanup() override {
+        conv_.reset();
+        convf_.reset();
+        signal_.clear();
+        output_.clear();
+        signalf_.clear();
+        outputf_.clear();
+    }
+};
+// Extension 2D transform of size x size values. The in-place complex
+// transform restarts from the input each call, like FFTW's out-of-place
+// plan, so repeated 1/N scaling cannot drift into denormals.
+class OTFFT2DBenchmark : public FFTBenchmark {
+private:
+    bool is_real_;
+    bool is_float_;
+    vector<double> input_;
+    vector<float> inputf_;
+    vector<OTFFT::complex_t> data_;
+    vector<OTFFT::complexf_t> dataf_;
+    OTFFT::ComplexFFTNDPtr fft_;
+    OTFFT::ComplexFFTNDfPtr fftf_;
+    OTFFT::RealFFTNDPtr rfft_;
+    OTFFT::RealFFTNDfPtr rfftf_;
+    
+public:
+    OTFFT2DBenchmark(int size, bool is_real, bool is_float, double min_duration = 1.0) 
+        : FFTBenchmark(is_float ? "OTndf" : "OTnd", size, min_duration), is_real_(is_real), is_float_(is_float) {}
+    
+    void setup() override {
+        const size_t n = size_t(size_) * size_;
+        const size_t bins = size_t(size_) * (is_real_ ? size_/2 + 1 : size_);
+        input_.resize(n);
+        inputf_.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            input_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * (i % size_));
+            inputf_[i] = float(input_[i]);
+        }
+        data_.resize(is_float_ ? 0 : bins);
+        dataf_.resize(is_float_ ? bins : 0);
+        if (is_real_ && is_float_) rfftf_ = OTFFT::FactoryExt::createRealFFT2Df(size_, size_);
+        else if (is_real_) rfft_ = OTFFT::FactoryExt::createRealFFT2D(size_, size_);
+        else if (is_float_) fftf_ = OTFFT::FactoryExt::createComplexFFT2Df(size_, size_);
+        else fft_ = OTFFT::FactoryExt::createComplexFFT2D(size_, size_);
+    }
+    
+    void execute() override {
+        if (is_real_ && is_float_) {
+            rfftf_->fwd(inputf_.data(), dataf_.data());
+        } else if (is_real_) {
+            rfft_->fwd(input_.data(), data_.data());
+        } else if (is_float_) {
+            for (size_t i = 0; i < dataf_.size(); ++i) dataf_[i] = OTFFT::complexf_t(inputf_[i], 0.0f);
+            fftf_->fwd(dataf_.data());
+        } else {
+            for (size_t i = 0; i < data_.size(); ++i) data_[i] = OTFFT::complex_t(input_[i], 0.0);
+            fft_->fwd(data_.data());
+        }
+    }
+    
+    void cleanup() override {
+        fft_.reset();
+        fftf_.reset();
+        rfft_.reset();
+        rfftf_.reset();
+        input_.clear();
+        inputf_.clear();
+        data_.clear();
+        dataf_.clear();
+    }
+};
+// Split-complex input and output: OTFFT's interleaved transform with the
+// interleave/deinterleave copies a split-format caller pays ("OTilv"), or
+// the native split kernels ("OTsplit", "OTsplf" in single precision)
+class OTFFTSplitBenchmark : public FFTBenchmark {
+private:
+    enum Mode { INTERLEAVED, SPLIT, SPLIT_FLOAT };
+    Mode mode_;
+    vector<double> re_, im_, outRe_, outIm_;
+    vector<float> ref_, imf_, outRef_, outImf_;
+    vector<OTFFT::complex_t> data_;
+    OTFFT::ComplexFFTPtr fft_;
+    OTFFT::SplitComplexFFTPtr split_;
+    OTFFT::SplitComplexFFTfPtr splitf_;
+    
+    static const char* name_for(bool split, bool is_float) {
+        return !split ? "OTilv" : is_float ? "OTsplf" : "OTsplit";
+    }
+    
+public:
+    OTFFTSplitBenchmark(int size, bool split, bool is_float, double min_duration = 1.0) 
+        : FFTBenchmark(name_for(split, is_float), size, min_duration),
+          mode_(!split ? INTERLEAVED : is_float ? SPLIT_FLOAT : SPLIT) {}
+    
+    void setup() override {
+        re_.resize(size_);
+        im_.resize(size_);
+        outRe_.resize(size_);
+        outIm_.resize(size_);
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            re_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            im_[i] = 0.25 * cos(3.0 * t);
+        }
+        if (mode_ == SPLIT_FLOAT) {
+            ref_.assign(re_.begin(), re_.end());
+            imf_.assign(im_.begin(), im_.end());
+            outRef_.resize(size_);
+            outImf_.resize(size_);
+            splitf_ = OTFFT::FactoryExt::createSplitComplexFFTf(size_);
+        } else if (mode_ == SPLIT) {
+            split_ = OTFFT::FactoryExt::createSplitComplexFFT(size_);
+        } else {
+            data_.resize(size_);
+            fft_ = OTFFT::Factory::createComplexFFT(size_);
+        }
+    }
+    
+    void execute() override {
+        if (mode_ == SPLIT_FLOAT) {
+            splitf_->fwd(ref_.data(), imf_.data(), outRef_.data(), outImf_.data());
+        } else if (mode_ == SPLIT) {
+            split_->fwd(re_.data(), im_.data(), outRe_.data(), outIm_.data());
+        } else {
+            for (int i = 0; i < size_; ++i) data_[i] = OTFFT::complex_t(re_[i], im_[i]);
+            fft_->fwd(data_.data());
+            for (int i = 0; i < size_; ++i) {
+                outRe_[i] = data_[i].Re;
+                outIm_[i] = data_[i].Im;
+            }
+        }
+    }
+    
+    void cleanup() override {
+        fft_.reset();
+        split_.reset();
+        splitf_.reset();
+        re_.clear();
+        im_.clear();
+        outRe_.clear();
+        outIm_.clear();
+        ref_.clear();
+        imf_.clear();
+        outRef_.clear();
+        outImf_.clear();
+        data_.clear();
+    }
+};
+// Six-step parallel complex FFT on a work-stealing pool of the given
+// number of threads; each call is a fwd+inv pair so the data stays in range
+class OTFFTParallelBenchmark : public FFTBenchmark {
+private:
+    int threads_;
+    vector<OTFFT::complex_t> data_;
+    unique_ptr<OTFFT::WorkStealingPool> pool_;
+    OTFFT::ParallelComplexFFTPtr fft_;
+    
+    static string name_for(int threads) {
+        ostringstream name;
+        name << threads << " thr";
+        return name.str();
+    }
+    
+public:
+    OTFFTParallelBenchmark(int size, int threads, double min_duration = 1.0) 
+        : FFTBenchmark(name_for(threads), size, min_duration), threads_(threads) {}
+    
+    void setup() override {
+        data_.resize(size_);
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
+        }
+        pool_.reset(new OTFFT::WorkStealingPool(threads_));
+        fft_ = OTFFT::FactoryExt::createParallelComplexFFT(size_, pool_.get());
+        fft_->fwd(data_.data());  // first touch of the per-thread scratch
+        fft_->inv(data_.data());
+    }
+    
+    void execute() override {
+        fft_->fwd(data_.data());
+        fft_->inv(data_.data());
+    }
+    
+    void cleanup() override {
+        fft_.reset();
+        pool_.reset();
+        data_.clear();
+    }
+};
+
+// Partial-output FFT of a list of bins, by the given method (PARTIAL_AUTO
+// lets the cost estimate pick). The bins are the first harmonics of a
+// fundamental spread over the lower half of the spectrum, as a monitor of
+// a line frequency would ask for.
+class OTFFTPartialBenchmark : public FFTBenchmark {
+private:
+    int bins_;
+    OTFFT::PartialMethod method_;
+    vector<OTFFT::complex_t> data_;
+    vector<OTFFT::complex_t> out_;
+    OTFFT::PartialFFTPtr fft_;
+    
+    static const char* name_for(OTFFT::PartialMethod method) {
+        switch (method) {
+        case OTFFT::PARTIAL_GOERTZEL: return "Goertz";
+        case OTFFT::PARTIAL_PRUNED: return "Pruned";
+        case OTFFT::PARTIAL_FULL: return "Full";
+        default: return "Auto";
+        }
+    }
+    
+public:
+    OTFFTPartialBenchmark(int size, int bins, OTFFT::PartialMethod method, double min_duration = 1.0) 
+        : FFTBenchmark(name_for(method), size, min_duration), bins_(bins), method_(method) {}
+    
+    static vector<int> harmonics(int size, int count) {
+        const int fundamental = max(1, size / 2 / count);
+        vector<int> bins(count);
+        for (int j = 0; j < count; ++j) bins[j] = int((long long)(j + 1) * fundamental % size);
+        return bins;
+    }
+    
+    // No pruning factor for sizes with only prime factors above 7
+    bool supported() const override {
+        if (method_ != OTFFT::PARTIAL_PRUNED) return true;
+        for (int p = 2; p <= 7; ++p) {
+            if (size_ % p == 0 && size_ > p) return true;
+        }
+        return false;
+    }
+    
+    // The method PARTIAL_AUTO picks for this size and bin count
+    OTFFT::PartialMethod chosen() const {
+        const vector<int> bins = harmonics(size_, bins_);
+        return OTFFT::FactoryExt::createPartialFFT(size_, bins.data(), bins_, method_)->method();
+    }
+    
+    void setup() override {
+        data_.resize(size_);
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = OTFFT::complex_t(sin(t) + 0.5 * sin(5.0 * t), 0.0);
+        }
+        out_.resize(bins_);
+        const vector<int> bins = harmonics(size_, bins_);
+        fft_ = OTFFT::FactoryExt::createPartialFFT(size_, bins.data(), bins_, method_);
+    }
+    
+    void execute() override {
+        fft_->fwd(data_.data(), out_.data());
+    }
+    
+    void cleanup() override {
+        fft_.reset();
+        data_.clear();
+        out_.clear();
+    }
+};
+
+// A full real FFT per hop, as a trigger detector without a sliding DFT would
+// run it: shift the history by one hop, append the new samples, transform
+// (the extension's N/2+1-bin real FFT)
+class OTFFTHopFFTBenchmark : public FFTBenchmark {
+private:
+    int hop_;
+    vector<double> signal_;
+    vector<double> history_;
+    vector<double> frame_;
+    vector<OTFFT::complex_t> spectrum_;
+    OTFFT::CompactRealFFTPtr rfft_;
+    
+public:
+    OTFFTHopFFTBenchmark(int size, int hop, double min_duration = 1.0) 
+        : FFTBenchmark("FFT/hop", size, min_duration), hop_(hop) {}
+    
+    void setup() override {
+        signal_.resize(size_t(SDFT_HOPS) * hop_);
+        for (size_t i = 0; i < signal_.size(); ++i) signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+        history_.assign(size_, 0.0);
+        frame_.resize(size_);
+        spectrum_.resize(size_ / 2 + 1);
+        rfft_ = OTFFT::FactoryExt::createCompactRealFFT(size_);
+    }
+    
+    void execute() override {
+        for (int f = 0; f < SDFT_HOPS; ++f) {
+            std::copy(history_.begin() + hop_, history_.end(), history_.begin());
+            std::copy(signal_.begin() + f * hop_, signal_.begin() + (f + 1) * hop_, history_.end() - hop_);
+            frame_ = history_;
+            rfft_->fwd(frame_.data(), spectrum_.data());
+        }
+    }
+    
+    void cleanup() override {
+        rfft_.reset();
+        signal_.clear();
+        history_.clear();
+        frame_.clear();
+        spectrum_.clear();
+    }
+};
+
+// Extension sliding DFT fed one hop at a time, the spectrum of each hop
+// written over the previous one. bins = 0 takes all N/2+1 bins, otherwise
+// that many bins spread over the lower half.
+class OTFFTSlidingBenchmark : public FFTBenchmark {
+private:
+    int hop_;
+    bool is_float_;
+    int bins_;
+    vector<double> signal_;
+    vector<float> signalf_;
+    vector<OTFFT::complex_t> spectrum_;
+    vector<OTFFT::complexf_t> spectrumf_;
+    OTFFT::SlidingDFTPtr sdft_;
+    OTFFT::SlidingDFTfPtr sdftf_;
+    
+    static string name_for(bool is_float, int bins) {
+        if (!bins) return is_float ? "OTsdftf" : "OTsdft";
+        ostringstream name;
+        name << "OTsd" << bins << (is_float ? "f" : "");
+        return name.str();
+    }
+    
+public:
+    OTFFTSlidingBenchmark(int size, int hop, bool is_float, int bins, double min_duration = 1.0) 
+        : FFTBenchmark(name_for(is_float, bins), size, min_duration), hop_(hop), is_float_(is_float), bins_(bins) {}
+    
+    void setup() override {
+        signal_.resize(size_t(SDFT_HOPS) * hop_);
+        signalf_.resize(signal_.size());
+        for (size_t i = 0; i < signal_.size(); ++i) {
+            signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+            signalf_[i] = float(signal_[i]);
+        }
+        vector<int> bins;
+        for (int j = 0; j < bins_; ++j) bins.push_back(int((long long)(j + 1) * (size_ / 2) / (bins_ + 1)));
+        if (is_float_) {
+            sdftf_ = bins_ ? OTFFT::FactoryExt::createSlidingDFTf(size_, bins.data(), bins_, hop_)
+                           : OTFFT::FactoryExt::createSlidingDFTf(size_, hop_);
+            spectrumf_.resize(sdftf_->bins());
+        } else {
+            sdft_ = bins_ ? OTFFT::FactoryExt::createSlidingDFT(size_, bins.data(), bins_, hop_)
+                          : OTFFT::FactoryExt::createSlidingDFT(size_, hop_);
+            spectrum_.resize(sdft_->bins());
+        }
+    }
+    
+    void execute() override {
+        for (int f = 0; f < SDFT_HOPS; ++f) {
+            if (is_float_) sdftf_->process(signalf_.data() + f * hop_, hop_, spectrumf_.data());
+            else sdft_->process(signal_.data() + f * hop_, hop_, spectrum_.data());
+        }
+    }
+    
+    void cleanup() override {
+        sdft_.reset();
+        sdftf_.reset();
+        signal_.clear();
+        signalf_.clear();
+        spectrum_.clear();
+        spectrumf_.clear();
+    }
+};
+
+#ifdef OTFFT_EXT_HAS_OUT_OF_CORE
+// OTFFT extension out-of-core FFT from one file of size_ complex doubles to
+// another, through mmap and a scratch file (two passes over the data)
+class OTFFTOutOfCoreBenchmark : public FFTBenchmark {
+private:
+    string in_path_;
+    string out_path_;
+    OTFFT::OutOfCoreFFTPtr fft_;
+    
+public:
+    OTFFTOutOfCoreBenchmark(int size, const string& dir, double min_duration = 1.0) 
+        : FFTBenchmark("OTooc", size, min_duration),
+          in_path_(ooc_path(dir, size, "in")), out_path_(ooc_path(dir, size, "out")) {}
+    
+    void setup() override {
+        write_ooc_input(in_path_, size_);
+        fft_ = OTFFT::FactoryExt::createOutOfCoreFFT(size_);
+    }
+    
+    void execute() override {
+        fft_->fwd(in_path_, out_path_);
+    }
+    
+    void cleanup() override {
+        fft_.reset();
+        remove(in_path_.c_str());
+        remove(out_path_.c_str());
+    }
+};
+#endif // OTFFT_EXT_HAS_OUT_OF_CORE
+
+// Reference for the out-of-core table: read the whole file, transform it
+// in memory with the parallel FFT, write it back out
+class OTFFTInMemoryFileBenchmark : public FFTBenchmark {
+private:
+    string in_path_;
+    string out_path_;
+    vector<OTFFT::complex_t> data_;
+    OTFFT::ParallelComplexFFTPtr fft_;
+    
+public:
+    OTFFTInMemoryFileBenchmark(int size, const string& dir, double min_duration = 1.0) 
+        : FFTBenchmark("OTinmem", size, min_duration),
+          in_path_(ooc_path(dir, size, "in")), out_path_(ooc_path(dir, size, "out")) {}
+    
+    void setup() override {
+        write_ooc_input(in_path_, size_);
+        data_.resize(size_);
+        fft_ = OTFFT::FactoryExt::createParallelComplexFFT(size_);
+    }
+    
+    void execute() override {
+        const size_t bytes = size_t(size_) * sizeof(OTFFT::complex_t);
+        {
+            FilePtr in = open_file(in_path_, "rb");
+            if (fread(data_.data(), 1, bytes, in.get()) != bytes) throw runtime_error("cannot read " + in_path_);
+        }
+        fft_->fwd(data_.data());
+        FilePtr out = open_file(out_path_, "wb");
+        if (fwrite(data_.data(), 1, bytes, out.get()) != bytes) throw runtime_error("cannot write " + out_path_);
+    }
+    
+    void cleanup() override {
+        fft_.reset();
+        data_.clear();
+        remove(in_path_.c_str());
+        remove(out_path_.c_str());
+    }
+};
+
+// OTFFT extension DCT/DST (R2R_LABELS order) of size_ points, or the MDCT
+// of size_ coefficients
+class OTFFTR2RBenchmark : public FFTBenchmark {
+private:
+    int kind_;
+    vector<double> in_;
+    vector<double> out_;
+    OTFFT::R2RTransformPtr r2r_;
+    OTFFT::MDCTPtr mdct_;
+    
+public:
+    OTFFTR2RBenchmark(int size, int kind, double min_duration = 1.0) 
+        : FFTBenchmark("OTr2r", size, min_duration), kind_(kind) {}
+    
+    bool supported() const override {
+        return kind_ == 0 ? ext_supports(size_ - 1, true) : kind_ == 4 ? ext_supports(size_ + 1, true)
+                                                           : ext_supports(size_, true);
+    }
+    
+    void setup() override {
+        in_.resize(kind_ == R2R_MDCT ? 2 * size_ : size_);
+        out_.resize(size_);
+        for (size_t i = 0; i < in_.size(); ++i) in_[i] = sin(0.37 * i) + 0.1 * (i % 7);
+        if (kind_ == R2R_MDCT) mdct_ = OTFFT::FactoryExt::createMDCT(size_);
+        else r2r_ = OTFFT::FactoryExt::createR2R(size_, OTFFT::R2RKind(kind_));
+    }
+    
+    void execute() override {
+        if (mdct_) mdct_->fwd(in_.data(), out_.data());
+        else r2r_->execute(in_.data(), out_.data());
+    }
+    
+    void cleanup() override {
+        r2r_.reset();
+        mdct_.reset();
+        in_.clear();
+        out_.clear();
+    }
+};
+
+// Reference for the pipeline table: the same ring of blocks and the same
+// transforms, handed over under a mutex, with the transform and consumer
+// threads sleeping on condition variables while there is nothing to do
+class MutexFFTPipeline : public OTFFT::FFTPipeline {
+private:
+    int n_;
+    OTFFT::PipelineTransform transform_;
+    int capacity_;
+    int cpu_;
+    vector<double> inputs_;
+    vector<OTFFT::complex_t> outputs_;
+    vector<OTFFT::PipelineBlock> blocks_;
+    OTFFT::CompactRealFFTPtr rfft_;
+    OTFFT::MixedRadixFFTPtr fft_;
+    mutable mutex mutex_;
+    condition_variable work_;
+    condition_variable done_;
+    unsigned long long submitted_, transformed_, released_, overruns_;
+    bool stop_;
+    atomic<bool> pinned_;
+    thread worker_;
+    
+    void worker() {
+        pinned_ = cpu_ >= 0 && OTFFT::detail::pin_current_thread(cpu_);
+        unique_lock<mutex> lock(mutex_);
+        while (true) {
+            work_.wait(lock, [this]() { return stop_ || transformed_ < submitted_; });
+            if (stop_) return;
+            const size_t s = size_t(transformed_ % capacity_);
+            lock.unlock();
+            double* x = inputs_.data() + s * input_length();
+            OTFFT::complex_t* y = outputs_.data() + s * n_;
+            if (rfft_) {
+                rfft_->fwd(x, y);
+            } else {
+                for (int i = 0; i < n_; ++i) y[i] = OTFFT::complex_t(x[2 * i], x[2 * i + 1]);
+                fft_->fwd(y);
+            }
+            lock.lock();
+            blocks_[s].transformed_ns = OTFFT::detail::steady_ns();
+            ++transformed_;
+            done_.notify_one();
+        }
+    }
+    
+public:
+    MutexFFTPipeline(OTFFT::PipelineTransform transform, int n, int capacity, int cpu)
+        : n_(n), transform_(transform), capacity_(capacity), cpu_(cpu), submitted_(0), transformed_(0),
+          released_(0), overruns_(0), stop_(false), pinned_(false) {
+        inputs_.resize(size_t(capacity) * input_length());
+        outputs_.resize(size_t(capacity) * n);
+        blocks_.resize(capacity);
+        if (transform == OTFFT::PIPELINE_REAL) rfft_ = OTFFT::FactoryExt::createCompactRealFFT(n);
+        else fft_ = OTFFT::FactoryExt::createMixedRadixFFT(n);
+        worker_ = thread(&MutexFFTPipeline::worker, this);
+    }
+    
+    ~MutexFFTPipeline() {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_.notify_one();
+        worker_.join();
+    }
+    
+    int size() const override { return n_; }
+    OTFFT::PipelineTransform transform() const override { return transform_; }
+    int capacity() const override { return capacity_; }
+    int input_length() const override { return transform_ == OTFFT::PIPELINE_REAL ? n_ : 2 * n_; }
+    int bins() const override { return transform_ == OTFFT::PIPELINE_REAL ? n_ / 2 + 1 : n_; }
+    bool pinned() const override { return pinned_; }
+    
+    double* acquire_input() override {
+        lock_guard<mutex> lock(mutex_);
+        if (submitted_ - released_ == (unsigned long long)capacity_) {
+            ++overruns_;
+            return nullptr;
+        }
+        return inputs_.data() + size_t(submitted_ % capacity_) * input_length();
+    }
+    
+    void submit_input() override {
+        {
+            lock_guard<mutex> lock(mutex_);
+            OTFFT::PipelineBlock& b = blocks_[submitted_ % capacity_];
+            b.sequence = submitted_;
+            b.submitted_ns = OTFFT::detail::steady_ns();
+            ++submitted_;
+        }
+        work_.notify_one();
+    }
+    
+    unsigned long long overruns() const override {
+        lock_guard<mutex> lock(mutex_);
+        return overruns_;
+    }
+    
+    const OTFFT::complex_t* acquire_spectrum(OTFFT::PipelineBlock* info) override {
+        lock_guard<mutex> lock(mutex_);
+        if (released_ == transformed_) return nullptr;
+        const size_t s = size_t(released_ % capacity_);
+        if (info) *info = blocks_[s];
+        return outputs_.data() + s * n_;
+    }
+    
+    const OTFFT::complex_t* wait_spectrum(OTFFT::PipelineBlock* info) override {
+        unique_lock<mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return released_ < transformed_; });
+        const size_t s = size_t(released_ % capacity_);
+        if (info) *info = blocks_[s];
+        return outputs_.data() + s * n_;
+    }
+    
+    void release_spectrum() override {
+        lock_guard<mutex> lock(mutex_);
+        ++released_;
+    }
+};
+
+#endif // HAVE_OTFFT
+
+// Raw sequential bandwidth for the out-of-core table: the input file copied
+// to the output in OOC_CHUNK pieces, one read and one write of the data
+class SequentialCopyBenchmark : public FFTBenchmark {
+private:
+    string in_path_;
+    string out_path_;
+    vector<char> chunk_;
+    
+public:
+    SequentialCopyBenchmark(int size, const string& dir, double min_duration = 1.0) 
+        : FFTBenchmark("Copy", size, min_duration),
+          in_path_(ooc_path(dir, size, "in")), out_path_(ooc_path(dir, size, "out")) {}
+    
+    void setup() override {
+        write_ooc_input(in_path_, size_);
+        chunk_.resize(OOC_CHUNK);
+    }
+    
+    void execute() override {
+        FilePtr in = open_file(in_path_, "rb");
+        FilePtr out = open_file(out_path_, "wb");
+        size_t got;
+        while ((got = fread(chunk_.data(), 1, chunk_.size(), in.get())) > 0) {
+            if (fwrite(chunk_.data(), 1, got, out.get()) != got) throw runtime_error("cannot write " + out_path_);
+        }
+    }
+    
+    void cleanup() override {
+        chunk_.clear();
+        remove(in_path_.c_str());
+        remove(out_path_.c_str());
+    }
+};
+
+// Direct time-domain FIR filter, CONV_CHUNK samples per call: each output
+// is a dot product of the reversed taps with the input history
+class DirectConvolutionBenchmark : public FFTBenchmark {
+private:
+    vector<double> taps_;     // reversed
+    vector<double> history_;  // size_-1 previous samples, then the chunk
+    vector<double> signal_;
+    vector<double> output_;
+    
+public:
+    DirectConvolutionBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("Direct", size, min_duration) {}
+    
+    void setup() override {
+        taps_.resize(size_);
+        for (int k = 0; k < size_; ++k) taps_[size_ - 1 - k] = exp(-4.0 * k / size_) * sin(0.1 * k);
+        history_.assign(size_ - 1 + CONV_CHUNK, 0.0);
+        signal_.resize(CONV_CHUNK);
+        for (int i = 0; i < CONV_CHUNK; ++i) signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+        output_.resize(CONV_CHUNK);
+    }
+    
+    void execute() override {
+        std::copy(signal_.begin(), signal_.end(), history_.begin() + size_ - 1);
+        for (int t = 0; t < CONV_CHUNK; ++t) {
+            const double* x = history_.data() + t;
+            double acc = 0.0;
+            for (int k = 0; k < size_; ++k) acc += taps_[k] * x[k];
+            output_[t] = acc;
+        }
+        std::copy(history_.end() - (size_ - 1), history_.end(), history_.begin());
+    }
+    
+    void cleanup() override {
+        taps_.clear();
+        history_.clear();
+        signal_.clear();
+        output_.clear();
+    }
+};
+
+#ifdef HAVE_FFTW3
+// FFTW3 Complex FFT Benchmark
+// Column name per planner flag: FFTW_MEASURE is the plain "FFTW3" of all
+// tables, the other modes only show up in the plan lifecycle tables
+static string fftw_name(unsigned flags) {
+    if (flags == FFTW_ESTIMATE) return "FFTWest";
+    if (flags == FFTW_PATIENT) return "FFTWpat";
+    return "FFTW3";
+}
+
+class FFTW3ComplexBenchmark : public FFTBenchmark {
+private:
+    unsigned flags_;
+    fftw_complex* in_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+    
+public:
+    FFTW3ComplexBenchmark(int size, double min_duration = 1.0, unsigned flags = FFTW_MEASURE) 
+        : FFTBenchmark(fftw_name(flags), size, min_duration), flags_(flags), in_(nullptr), out_(nullptr), plan_(nullptr) {}
+    
+    void setup() override {
+        in_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_);
+        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_);
+        
+        // Planning may overwrite the arrays, so fill them afterwards
+        plan_ = fftw_plan_dft_1d(size_, in_, out_, FFTW_FORWARD, flags_);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            in_[i][0] = sin(t) + 0.5 * sin(5.0 * t);
+            in_[i][1] = 0.0;
+        }
+    }
+    
+    void execute() override {
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (in_) fftw_free(in_);
+        if (out_) fftw_free(out_);
+    }
+};
+
+// FFTW3 Real FFT Benchmark
+class FFTW3RealBenchmark : public FFTBenchmark {
+private:
+    unsigned flags_;
+    double* in_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+    
+public:
+    FFTW3RealBenchmark(int size, double min_duration = 1.0, unsigned flags = FFTW_MEASURE) 
+        : FFTBenchmark(fftw_name(flags), size, min_duration), flags_(flags), in_(nullptr), out_(nullptr), plan_(nullptr) {}
+    
+    void setup() override {
+        in_ = (double*)fftw_malloc(sizeof(double) * size_);
+        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (size_/2 + 1));
+        
+        // Planning may overwrite the arrays, so fill them afterwards
+        plan_ = fftw_plan_dft_r2c_1d(size_, in_, out_, flags_);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            in_[i] = sin(t) + 0.5 * sin(5.0 * t);
+        }
+    }
+    
+    void execute() override {
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (in_) fftw_free(in_);
+        if (out_) fftw_free(out_);
+    }
+};
+// Hand-rolled STFT around an FFTW3 r2c plan, same bookkeeping as OTloop
+class FFTW3LoopSTFTBenchmark : public FFTBenchmark {
+private:
+    int hop_;
+    vector<double> signal_;
+    vector<double> history_;
+    vector<double> window_;
+    double* frame_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+    
+public:
+    FFTW3LoopSTFTBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("FFTW3", size, min_duration), hop_(size / 4), frame_(nullptr), out_(nullptr), plan_(nullptr) {}
+    
+    void setup() override {
+        signal_.resize(size_t(STFT_FRAMES) * hop_);
+        for (size_t i = 0; i < signal_.size(); ++i) signal_[i] = sin(0.01 * i) + 0.5 * sin(0.37 * i);
+        history_.assign(size_, 0.0);
+        window_ = stft_window(size_);
+        frame_ = (double*)fftw_malloc(sizeof(double) * size_);
+        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (size_/2 + 1));
+        plan_ = fftw_plan_dft_r2c_1d(size_, frame_, out_, FFTW_MEASURE);
+    }
+    
+    void execute() override {
+        for (int f = 0; f < STFT_FRAMES; ++f) {
+            std::copy(history_.begin() + hop_, history_.end(), history_.begin());
+            std::copy(signal_.begin() + f * hop_, signal_.begin() + (f + 1) * hop_, history_.end() - hop_);
+            for (int j = 0; j < size_; ++j) frame_[j] = history_[j] * window_[j];
+            fftw_execute(plan_);
+        }
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (frame_) fftw_free(frame_);
+        if (out_) fftw_free(out_);
+        signal_.clear();
+        history_.clear();
+    }
+};
+
+// FFTW3 batched Complex FFT Benchmark (fftw_plan_many_dft)
+class FFTW3BatchComplexBenchmark : public FFTBenchmark {
+private:
+    fftw_complex* in_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+    int count_;
+    
+public:
+    FFTW3BatchComplexBenchmark(int size, int count, double min_duration = 1.0) 
+        : FFTBenchmark("FFTW3", size, min_duration), in_(nullptr), out_(nullptr), plan_(nullptr), count_(count) {}
+    
+    void setup() override {
+        in_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_ * count_);
+        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_ * count_);
+        
+        int n[] = {size_};
+        plan_ = fftw_plan_many_dft(1, n, count_, in_, nullptr, 1, size_,
+                                   out_, nullptr, 1, size_, FFTW_FORWARD, FFTW_MEASURE);
+        
+        for (int i = 0; i < size_ * count_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            in_[i][0] = sin(t) + 0.5 * sin(5.0 * t);
+            in_[i][1] = 0.0;
+        }
+    }
+    
+    void execute() override {
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (in_) fftw_free(in_);
+        if (out_) fftw_free(out_);
+    }
+};
+
+// FFTW3 batched Real FFT Benchmark (fftw_plan_many_dft_r2c)
+class FFTW3BatchRealBenchmark : public FFTBenchmark {
+private:
+    double* in_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+    int count_;
+    
+public:
+    FFTW3BatchRealBenchmark(int size, int count, double min_duration = 1.0) 
+        : FFTBenchmark("FFTW3", size, min_duration), in_(nullptr), out_(nullptr), plan_(nullptr), count_(count) {}
+    
+    void setup() override {
+        in_ = (double*)fftw_malloc(sizeof(double) * size_ * count_);
+        out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * (size_/2 + 1) * count_);
+        
+        int n[] = {size_};
+        plan_ = fftw_plan_many_dft_r2c(1, n, count_, in_, nullptr, 1, size_,
+                                       out_, nullptr, 1, size_/2 + 1, FFTW_MEASURE);
+        
+        for (int i = 0; i < size_ * count_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            in_[i] = sin(t) + 0.5 * sin(5.0 * t);
+        }
+    }
+    
+    void execute() override {
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (in_) fftw_free(in_);
+        if (out_) fftw_free(out_);
+    }
+};
+// FFTW3 2D transform of size x size values (fftw_plan_dft_2d / _r2c_2d)
+class FFTW32DBenchmark : public FFTBenchmark {
+private:
+    bool is_real_;
+    double* rin_;
+    fftw_complex* in_;
+    fftw_complex* out_;
+    fftw_plan plan_;
+    
+public:
+    FFTW32DBenchmark(int size, bool is_real, double min_duration = 1.0) 
+        : FFTBenchmark("FFTW3", size, min_duration), is_real_(is_real), rin_(nullptr), in_(nullptr), out_(nullptr), plan_(nullptr) {}
+    
+    void setup() override {
+        const size_t n = size_t(size_) * size_;
+        if (is_real_) {
+            rin_ = (double*)fftw_malloc(sizeof(double) * n);
+            out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * size_ * (size_/2 + 1));
+            plan_ = fftw_plan_dft_r2c_2d(size_, size_, rin_, out_, FFTW_MEASURE);
+        } else {
+            in_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * n);
+            out_ = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * n);
+            plan_ = fftw_plan_dft_2d(size_, size_, in_, out_, FFTW_FORWARD, FFTW_MEASURE);
+        }
+        
+        for (size_t i = 0; i < n; ++i) {
+            double v = sin(0.01 * i) + 0.5 * sin(0.37 * (i % size_));
+            if (is_real_) {
+                rin_[i] = v;
+            } else {
+                in_[i][0] = v;
+                in_[i][1] = 0.0;
+            }
+        }
+    }
+    
+    void execute() override {
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (rin_) fftw_free(rin_);
+        if (in_) fftw_free(in_);
+        if (out_) fftw_free(out_);
+    }
+};
+
+// FFTW3 split-complex transform through the guru interface
+class FFTW3SplitBenchmark : public FFTBenchmark {
+private:
+    double* re_;
+    double* im_;
+    double* outRe_;
+    double* outIm_;
+    fftw_plan plan_;
+    
+public:
+    FFTW3SplitBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("FFTW3", size, min_duration), re_(nullptr), im_(nullptr), outRe_(nullptr), outIm_(nullptr), plan_(nullptr) {}
+    
+    void setup() override {
+        re_ = (double*)fftw_malloc(sizeof(double) * size_);
+        im_ = (double*)fftw_malloc(sizeof(double) * size_);
+        outRe_ = (double*)fftw_malloc(sizeof(double) * size_);
+        outIm_ = (double*)fftw_malloc(sizeof(double) * size_);
+        
+        // A forward split transform is the backward one with re and im swapped
+        fftw_iodim dim;
+        dim.n = size_;
+        dim.is = 1;
+        dim.os = 1;
+        plan_ = fftw_plan_guru_split_dft(1, &dim, 0, nullptr, im_, re_, outIm_, outRe_, FFTW_MEASURE);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            re_[i] = sin(t) + 0.5 * sin(5.0 * t);
+            im_[i] = 0.25 * cos(3.0 * t);
+        }
+    }
+    
+    void execute() override {
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (re_) fftw_free(re_);
+        if (im_) fftw_free(im_);
+        if (outRe_) fftw_free(outRe_);
+        if (outIm_) fftw_free(outIm_);
+    }
+};
+
+// FFTW3 fftw_plan_r2r_1d of the kind of a DCT/DST table row; for the MDCT
+// row, the same sine window and fold as the extension around REDFT11
+class FFTW3R2RBenchmark : public FFTBenchmark {
+private:
+    int kind_;
+    double* in_;
+    double* fold_;
+    double* out_;
+    vector<double> window_;
+    fftw_plan plan_;
+    
+public:
+    FFTW3R2RBenchmark(int size, int kind, double min_duration = 1.0) 
+        : FFTBenchmark("FFTW3", size, min_duration), kind_(kind), in_(nullptr), fold_(nullptr), out_(nullptr),
+          plan_(nullptr) {}
+    
+    void setup() override {
+        static const fftw_r2r_kind kinds[] = {FFTW_REDFT00, FFTW_REDFT10, FFTW_REDFT01, FFTW_REDFT11,
+                                              FFTW_RODFT00, FFTW_RODFT10, FFTW_RODFT01, FFTW_RODFT11,
+                                              FFTW_REDFT11};
+        const int n_in = kind_ == R2R_MDCT ? 2 * size_ : size_;
+        in_ = (double*)fftw_malloc(sizeof(double) * n_in);
+        fold_ = (double*)fftw_malloc(sizeof(double) * size_);
+        out_ = (double*)fftw_malloc(sizeof(double) * size_);
+        
+        // Planning may overwrite the arrays, so fill them afterwards
+        plan_ = fftw_plan_r2r_1d(size_, kind_ == R2R_MDCT ? fold_ : in_, out_, kinds[kind_], FFTW_MEASURE);
+        
+        for (int i = 0; i < n_in; ++i) in_[i] = sin(0.37 * i) + 0.1 * (i % 7);
+        if (kind_ == R2R_MDCT) {
+            window_.resize(2 * size_);
+            for (int j = 0; j < 2 * size_; ++j) window_[j] = sin(M_PI * (j + 0.5) / (2.0 * size_));
+        }
+    }
+    
+    void execute() override {
+        if (kind_ == R2R_MDCT) {
+            // Quarters a, b, c, d of the windowed block -> (-c reversed - d, a - b reversed)
+            const int n = size_, h = size_ / 2;
+            const double* w = window_.data();
+            for (int j = 0; j < h; ++j) {
+                fold_[j] = -w[n + h - 1 - j] * in_[n + h - 1 - j] - w[n + h + j] * in_[n + h + j];
+                fold_[h + j] = w[j] * in_[j] - w[n - 1 - j] * in_[n - 1 - j];
+            }
+        }
+        fftw_execute(plan_);
+    }
+    
+    void cleanup() override {
+        if (plan_) fftw_destroy_plan(plan_);
+        if (in_) fftw_free(in_);
+        if (fold_) fftw_free(fold_);
+        if (out_) fftw_free(out_);
+    }
+};
+#endif
+
+#ifdef HAVE_MKL
+// Intel MKL Complex FFT Benchmark
+class MKLComplexBenchmark : public FFTBenchmark {
+private:
+    vector<complex<double>> data_;
+    DFTI_DESCRIPTOR_HANDLE handle_;
+    
+public:
+    MKLComplexBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("MKL", size, min_duration), handle_(nullptr) {}
+    
+    void setup() override {
+        data_.resize(size_);
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = complex<double>(sin(t) + 0.5 * sin(5.0 * t), 0.0);
+        }
+        
+        DftiCreateDescriptor(&handle_, DFTI_DOUBLE, DFTI_COMPLEX, 1, size_);
+        DftiSetValue(handle_, DFTI_PLACEMENT, DFTI_INPLACE);
+        DftiCommitDescriptor(handle_);
+    }
+    
+    void execute() override {
+        DftiComputeForward(handle_, data_.data());
+    }
+    
+    void cleanup() override {
+        if (handle_) DftiFreeDescriptor(&handle_);
+        data_.clear();
+    }
+};
+
+// Intel MKL Real FFT Benchmark
+class MKLRealBenchmark : public FFTBenchmark {
+private:
+    vector<double> data_;
+    DFTI_DESCRIPTOR_HANDLE handle_;
+    
+public:
+    MKLRealBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("MKL", size, min_duration), handle_(nullptr) {}
+    
+    void setup() override {
+        data_.resize(size_ + 2, 0.0);
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
+        }
+        
+        DftiCreateDescriptor(&handle_, DFTI_DOUBLE, DFTI_REAL, 1, size_);
+        DftiSetValue(handle_, DFTI_PLACEMENT, DFTI_INPLACE);
+        DftiSetValue(handle_, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+        DftiCommitDescriptor(handle_);
+    }
+    
+    void execute() override {
+        DftiComputeForward(handle_, data_.data());
+    }
+    
+    void cleanup() override {
+        if (handle_) DftiFreeDescriptor(&handle_);
+        data_.clear();
+    }
+};
+#endif
+
+#ifdef HAVE_KISSFFT
+// KissFFT Complex FFT Benchmark
+class KissFFTComplexBenchmark : public FFTBenchmark {
+private:
+    vector<kiss_fft_cpx> in_;
+    vector<kiss_fft_cpx> out_;
+    kiss_fft_cfg cfg_;
+    
+public:
+    KissFFTComplexBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("Kiss", size, min_duration), cfg_(nullptr) {}
+    
+    void setup() override {
+        in_.resize(size_);
+        out_.resize(size_);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            in_[i].r = sin(t) + 0.5 * sin(5.0 * t);
+            in_[i].i = 0.0;
+        }
+        
+        cfg_ = kiss_fft_alloc(size_, 0, nullptr, nullptr);
+    }
+    
+    void execute() override {
+        kiss_fft(cfg_, in_.data(), out_.data());
+    }
+    
+    void cleanup() override {
+        if (cfg_) kiss_fft_free(cfg_);
+        in_.clear();
+        out_.clear();
+    }
+};
+
+// KissFFT Real FFT Benchmark
+class KissFFTRealBenchmark : public FFTBenchmark {
+private:
+    vector<kiss_fft_scalar> in_;
+    vector<kiss_fft_cpx> out_;
+    kiss_fftr_cfg cfg_;
+    
+public:
+    KissFFTRealBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("Kiss", size, min_duration), cfg_(nullptr) {}
+    
+    bool supported() const override { return size_ % 2 == 0; }
+    
+    void setup() override {
+        in_.resize(size_);
+        out_.resize(size_/2 + 1);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            in_[i] = sin(t) + 0.5 * sin(5.0 * t);
+        }
+        
+        cfg_ = kiss_fftr_alloc(size_, 0, nullptr, nullptr);
+    }
+    
+    void execute() override {
+        kiss_fftr(cfg_, in_.data(), out_.data());
+    }
+    
+    void cleanup() override {
+        if (cfg_) kiss_fftr_free(cfg_);
+        in_.clear();
+        out_.clear();
+    }
+};
+#endif
+
+#ifdef HAVE_PFFFT
+// PFFFT takes multiples of 16 (complex) or 32 (real) points with no prime
+// factor above 5
+static bool pffft_supports(int size, bool is_real) {
+    if (size % (is_real ? 32 : 16) != 0) return false;
+    const int primes[] = {2, 3, 5};
+    for (int p : primes) {
+        while (size % p == 0) size /= p;
+    }
+    return size == 1;
+}
+
+// PFFFT Complex FFT Benchmark
+class PFFFFTComplexBenchmark : public FFTBenchmark {
+private:
+    vector<float> data_;
+    vector<float> work_;
+    PFFFT_Setup* setup_;
+    
+public:
+    PFFFFTComplexBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("PFFFT", size, min_duration), setup_(nullptr) {}
+    
+    bool supported() const override { return pffft_supports(size_, false); }
+    
+    void setup() override {
+        data_.resize(size_ * 2);
+        work_.resize(size_ * 2);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i * 2] = sin(t) + 0.5 * sin(5.0 * t);
+            data_[i * 2 + 1] = 0.0;
+        }
+        
+        setup_ = pffft_new_setup(size_, PFFFT_COMPLEX);
+    }
+    
+    void execute() override {
+        pffft_transform_ordered(setup_, data_.data(), data_.data(), work_.data(), PFFFT_FORWARD);
+    }
+    
+    void cleanup() override {
+        if (setup_) pffft_destroy_setup(setup_);
+        data_.clear();
+        work_.clear();
+    }
+};
+
+// PFFFT Real FFT Benchmark
+class PFFFFTRealBenchmark : public FFTBenchmark {
+private:
+    vector<float> data_;
+    vector<float> work_;
+    PFFFT_Setup* setup_;
+    
+public:
+    PFFFFTRealBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("PFFFT", size, min_duration), setup_(nullptr) {}
+    
+    bool supported() const override { return pffft_supports(size_, true); }
+    
+    void setup() override {
+        data_.resize(size_);
+        work_.resize(size_);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
+        }
+        
+        setup_ = pffft_new_setup(size_, PFFFT_REAL);
+    }
+    
+    void execute() override {
+        pffft_transform_ordered(setup_, data_.data(), data_.data(), work_.data(), PFFFT_FORWARD);
+    }
+    
+    void cleanup() override {
+        if (setup_) pffft_destroy_setup(setup_);
+        data_.clear();
+        work_.clear();
+    }
+};
+#endif
+
+#ifdef HAVE_POCKETFFT
+// PocketFFT Complex FFT Benchmark
+class PocketFFTComplexBenchmark : public FFTBenchmark {
+private:
+    vector<complex<double>> data_;
+    pocketfft::shape_t shape_;
+    pocketfft::stride_t stride_;
+    pocketfft::shape_t axes_;
+    
+public:
+    PocketFFTComplexBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("Pocket", size, min_duration) {}
+    
+    void setup() override {
+        data_.resize(size_);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = complex<double>(sin(t) + 0.5 * sin(5.0 * t), 0.0);
+        }
+        
+        shape_ = {static_cast<size_t>(size_)};
+        stride_ = {static_cast<ptrdiff_t>(sizeof(complex<double>))};
+        axes_ = {0};
+    }
+    
+    void execute() override {
+        pocketfft::c2c(shape_, stride_, stride_, axes_, pocketfft::FORWARD, 
+                       data_.data(), data_.data(), 1.0);
+    }
+    
+    void cleanup() override {
+        data_.clear();
+    }
+};
+
+// PocketFFT Real FFT Benchmark
+class PocketFFTRealBenchmark : public FFTBenchmark {
+private:
+    vector<double> data_;
+    vector<complex<double>> out_;
+    pocketfft::shape_t shape_;
+    pocketfft::stride_t stride_in_;
+    pocketfft::stride_t stride_out_;
+    pocketfft::shape_t axes_;
+    
+public:
+    PocketFFTRealBenchmark(int size, double min_duration = 1.0) 
+        : FFTBenchmark("Pocket", size, min_duration) {}
+    
+    void setup() override {
+        data_.resize(size_);
+        out_.resize(size_/2 + 1);
+        
+        for (int i = 0; i < size_; ++i) {
+            double t = 2.0 * M_PI * i / size_;
+            data_[i] = sin(t) + 0.5 * sin(5.0 * t);
+        }
+        
+        shape_ = {static_cast<size_t>(size_)};
+        stride_in_ = {static_cast<ptrdiff_t>(sizeof(double))};
+        stride_out_ = {static_cast<ptrdiff_t>(sizeof(complex<double>))};
+        axes_ = {0};
+    }
+    
+    void execute() override {
+        pocketfft::r2c(shape_, stride_in_, stride_out_, axes_, pocketfft::FORWARD,
+                       data_.data(), out_.data(), 1.0);
+    }
+    
+    void cleanup() override {
+        data_.clear();
+        out_.clear();
+    }
+};
+#endif
+
+// Function to get the system architecture using the uname() system call
+std::string get_architecture() {
+    struct utsname buffer;
+    if (uname(&buffer) != 0) {
+        throw std::runtime_error("Failed to call uname()");
+    }
+    return buffer.machine;
+}
+
+// Function to get the CPU model name by reading /proc/cpuinfo
+std::string get_cpu_model() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+
+    if (!cpuinfo.is_open()) {
+        throw std::runtime_error("Could not open /proc/cpuinfo");
+    }
+
+    // Loop through the file line by line
+    while (std::getline(cpuinfo, line)) {
+        // Look for the line that specifies the human-readable model name
+        if (line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
+            // Find the colon and take the rest of the string as the model name
+            size_t colon_pos = line.find(':');
+            if (colon_pos != std::string::npos) {
+                // Trim leading whitespace and return the model name (only needs to be read once)
+                std::string model = line.substr(colon_pos + 1);
+                // Trim leading whitespace
+                size_t first_char = model.find_first_not_of(" \t");
+                if (first_char != std::string::npos) {
+                    return model.substr(first_char);
+                }
+            }
+        }
+    }
+
+    return "Model name not found in /proc/cpuinfo";
+}
+
+// Compiler name and version, as shown in the banner
+std::string get_compiler() {
+    std::ostringstream os;
+#if defined(__GNUC__) && !defined(__clang__)
+    os << "GCC " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+#elif defined(__clang__)
+    os << "Clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined(_MSC_VER)
+    os << "MSVC " << _MSC_VER;
+#else
+    os << "Unknown";
+#endif
+    return os.str();
+}
+
+#ifdef __linux__
+// Affinity of the process at the first pin, restored by unpin_thread()
+static cpu_set_t& startup_affinity() {
+    static cpu_set_t mask;
+    static bool saved = false;
+    if (!saved) {
+        CPU_ZERO(&mask);
+        sched_getaffinity(0, sizeof(mask), &mask);
+        saved = true;
+    }
+    return mask;
+}
+#endif
+
+// Pins the calling thread to one CPU so that migrations do not show up in
+// the samples. Returns false where that is not supported (non-Linux) or
+// the CPU is not available.
+bool pin_thread(int cpu) {
+#ifdef __linux__
+    startup_affinity();
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return cpu >= 0 && cpu < CPU_SETSIZE && sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Lets the calling thread run on all CPUs it could use before pin_thread()
+void unpin_thread() {
+#ifdef __linux__
+    sched_setaffinity(0, sizeof(cpu_set_t), &startup_affinity());
+#endif
+}
+
+#ifdef HAVE_OTFFT
+// Paced end-to-end run of a pipeline: a producer thread on producer_cpu
+// submits `blocks` blocks, one every period_ns (a block that finds the ring
+// full waits for the next tick, and the miss shows in overruns()), and the
+// calling thread consumes them with wait_spectrum(). Returns each block's
+// latency in us, from submit_input() to the consumer holding the spectrum.
+vector<double> pipeline_latencies(OTFFT::FFTPipeline& pipe, int blocks, long long period_ns, int producer_cpu) {
+    vector<double> signal(pipe.input_length());
+    for (size_t i = 0; i < signal.size(); ++i) signal[i] = sin(0.37 * i) + 0.1 * (i % 7);
+    vector<double> latencies;
+    latencies.reserve(blocks);
+    
+    thread producer([&]() {
+        if (producer_cpu >= 0) pin_thread(producer_cpu);
+        long long next = OTFFT::detail::steady_ns();
+        for (int b = 0; b < blocks; next += period_ns) {
+            while (OTFFT::detail::steady_ns() < next) this_thread::yield();
+            double* x = pipe.acquire_input();
+            if (!x) continue;
+            memcpy(x, signal.data(), signal.size() * sizeof(double));
+            pipe.submit_input();
+            ++b;
+        }
+    });
+    for (int b = 0; b < blocks; ++b) {
+        OTFFT::PipelineBlock info;
+        pipe.wait_spectrum(&info);
+        latencies.push_back(1e-3 * (OTFFT::detail::steady_ns() - info.submitted_ns));
+        pipe.release_spectrum();
+    }
+    producer.join();
+    return latencies;
+}
+#endif
+
+// Escapes a string for a JSON string literal
+std::string json_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+    return out;
+}
+
+// A number for JSON, null for NaN
+std::string json_number(double v) {
+    if (std::isnan(v)) return "null";
+    std::ostringstream os;
+    os << setprecision(6) << v;
+    return os.str();
+}
+
+// Quotes a CSV field if it needs it
+std::string csv_field(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) return text;
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Benchmark result holder
+struct BenchmarkResult {
+    string library;
+    double time_us;
+    double ratio;  // Relative to baseline (OTFFT)
+    
+    BenchmarkResult(const string& lib, double time, double base_time) 
+        : library(lib), time_us(time) {
+        ratio = time_us / base_time;
+    }
+};
+
+// Statistics of one table cell, for the JSON and CSV output
+struct BenchmarkRecord {
+    string test;
+    int size;
+    string library;
+    BenchmarkStats stats;
+    
+    BenchmarkRecord(const string& t, int n, const string& lib, const BenchmarkStats& st)
+        : test(t), size(n), library(lib), stats(st) {}
+};
+
+// Benchmark runner and table formatter
+class BenchmarkRunner {
+private:
+    vector<unique_ptr<FFTBenchmark>> benchmarks_;
+    double min_duration_seconds_;
+    vector<string> libraries_;        // columns to keep; empty keeps all
+    int pinned_cpu_;                  // -1 when not pinned
+    int max_threads_;                 // for the scaling tables; 0: hardware threads
+    vector<BenchmarkRecord> records_;
+    static const int LABEL_WIDTH = 15;
+    static const int COL_SIZE_WIDTH = 10;
+    static const int TIME_WIDTH = 9;
+    static const int RATIO_WIDTH = 6;
+    
+    // Adds a column unless the library filter leaves it out
+    void add_benchmark(FFTBenchmark* bench) {
+        unique_ptr<FFTBenchmark> owned(bench);
+        if (!libraries_.empty() &&
+            find(libraries_.begin(), libraries_.end(), bench->getName()) == libraries_.end()) return;
+        benchmarks_.push_back(std::move(owned));
+    }
+    
+    void create_benchmarks(int size, bool is_real) {
+        benchmarks_.clear();
+        
+        // FFTW3 is the primary/baseline library
+#ifdef HAVE_FFTW3
+        if (is_real) add_benchmark(new FFTW3RealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new FFTW3ComplexBenchmark(size, min_duration_seconds_));
+#endif
+        add_library_benchmarks(size, is_real);
+    }
+    
+    // FFTW3 under each planner mode, then the other libraries
+    void create_lifecycle_benchmarks(int size, bool is_real) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_FFTW3
+        const unsigned modes[] = {FFTW_ESTIMATE, FFTW_MEASURE, FFTW_PATIENT};
+        for (unsigned flags : modes) {
+            if (is_real) add_benchmark(new FFTW3RealBenchmark(size, min_duration_seconds_, flags));
+            else add_benchmark(new FFTW3ComplexBenchmark(size, min_duration_seconds_, flags));
+        }
+#endif
+        add_library_benchmarks(size, is_real);
+    }
+    
+    // Every library column after FFTW3, in table order
+    void add_library_benchmarks(int size, bool is_real) {
+#ifdef HAVE_OTFFT
+        if (is_real) add_benchmark(new OTFFTRealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new OTFFTComplexBenchmark(size, min_duration_seconds_));
+        if (!is_real) add_benchmark(new OTFFTTunedBenchmark(size, min_duration_seconds_));
+        if (!is_real) add_benchmark(new OTFFTMixedRadixBenchmark(size, min_duration_seconds_));
+        if (!is_real) add_benchmark(new OTFFTFixedBenchmark(size, min_duration_seconds_));
+        if (is_real) add_benchmark(new OTFFTFloatRealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new OTFFTFloatComplexBenchmark(size, min_duration_seconds_));
+        if (OTFFT::CpuDispatch::detected() >= OTFFT::ISA_AVX512) {
+            add_benchmark(new OTFFTAvx512Benchmark(size, is_real, false, min_duration_seconds_));
+            add_benchmark(new OTFFTAvx512Benchmark(size, is_real, true, min_duration_seconds_));
+        }
+#endif
+#ifdef HAVE_KISSFFT
+        if (is_real) add_benchmark(new KissFFTRealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new KissFFTComplexBenchmark(size, min_duration_seconds_));
+#endif
+#ifdef HAVE_PFFFT
+        if (is_real) add_benchmark(new PFFFFTRealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new PFFFFTComplexBenchmark(size, min_duration_seconds_));
+#endif
+#ifdef HAVE_POCKETFFT
+        if (is_real) add_benchmark(new PocketFFTRealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new PocketFFTComplexBenchmark(size, min_duration_seconds_));
+#endif
+#ifdef HAVE_MKL
+        if (is_real) add_benchmark(new MKLRealBenchmark(size, min_duration_seconds_));
+        else add_benchmark(new MKLComplexBenchmark(size, min_duration_seconds_));
+#endif
+    }
+    
+    void create_batched_benchmarks(int size, bool is_real, int count) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_FFTW3
+        if (is_real) add_benchmark(new FFTW3BatchRealBenchmark(size, count, min_duration_seconds_));
+        else add_benchmark(new FFTW3BatchComplexBenchmark(size, count, min_duration_seconds_));
+#endif
+#ifdef HAVE_OTFFT
+        if (is_real) add_benchmark(new OTFFTLoopRealBenchmark(size, count, min_duration_seconds_));
+        else add_benchmark(new OTFFTLoopComplexBenchmark(size, count, min_duration_seconds_));
+        if (is_real) add_benchmark(new OTFFTBatchRealBenchmark(size, count, min_duration_seconds_));
+        else add_benchmark(new OTFFTBatchComplexBenchmark(size, count, min_duration_seconds_));
+#endif
+    }
+    
+    void create_plan_benchmarks(int size, bool is_real) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTPlanBenchmark(size, is_real, min_duration_seconds_));
+        add_benchmark(new OTFFTFloatPlanBenchmark(size, is_real, false, min_duration_seconds_));
+        add_benchmark(new OTFFTFloatPlanBenchmark(size, is_real, true, min_duration_seconds_));
+#endif
+    }
+    
+    // One column per ISA level this CPU supports
+    void create_isa_benchmarks(int size, bool is_real) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_OTFFT
+        for (int level = OTFFT::ISA_SCALAR; level <= OTFFT::CpuDispatch::detected(); ++level) {
+            add_benchmark(new OTFFTIsaBenchmark(size, is_real, OTFFT::IsaLevel(level), min_duration_seconds_));
+        }
+#endif
+    }
+    
+    int calculate_table_width() const {
+        int width = LABEL_WIDTH + COL_SIZE_WIDTH + 3;  // Label + Size + separators
+        width += TIME_WIDTH + 2;  // Baseline library time + separators
+        
+        // Each additional library adds: time + ratio + separators
+        for (size_t i = 1; i < benchmarks_.size(); ++i) {
+            width += TIME_WIDTH + RATIO_WIDTH + 4;
+        }
+        
+        return width;
+    }
+    
+    void print_banner() const {
+        int width = calculate_table_width();
+        cout << string(width, '=') << endl;
+        cout << setw(width/2 + 20) << "FFT Performance Comparison Benchmark" << endl;
+        cout << string(width, '=') << endl;
+        
+        // Print compiler information
+        cout << "Compiler: " << get_compiler();
+        cout << " CPU: " << get_architecture() << " " << get_cpu_model();
+        cout << endl;
+        
+        cout << "Comparing:";
+        for (const auto& bench : benchmarks_) {
+            cout << " " << bench->getName();
+            if (bench != benchmarks_.back()) cout << " |";
+        }
+        cout << endl;
+        cout << "Min test duration: " << min_duration_seconds_ << " second(s), warmup "
+             << FFTBenchmark::warmup_seconds << " second(s)";
+        if (pinned_cpu_ >= 0) cout << ", pinned to CPU " << pinned_cpu_;
+        cout << endl;
+        cout << "Times shown in microseconds (μs), " << stat_name(FFTBenchmark::table_stat) << " per call" << endl;
+        if (FFTBenchmark::use_counters) {
+            cout << "Under each row: IPC and L1D/LLC/dTLB/branch misses per call (user space, timed calls)" << endl;
+        }
+        cout << string(width, '=') << endl;
+    }
+    
+    // Streaming STFT, hop = size/4; the hand-rolled OTFFT loop is the baseline
+    void create_stft_benchmarks(int size) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTLoopSTFTBenchmark(size, min_duration_seconds_));
+        add_benchmark(new OTFFTSTFTBenchmark(size, false, min_duration_seconds_));
+        add_benchmark(new OTFFTSTFTBenchmark(size, true, min_duration_seconds_));
+#ifdef HAVE_FFTW3
+        add_benchmark(new FFTW3LoopSTFTBenchmark(size, min_duration_seconds_));
+#endif
+#endif
+    }
+    
+    // FIR filtering of a stream; size is the number of taps and the direct
+    // time-domain filter is the baseline
+    void create_convolution_benchmarks(int taps) {
+        benchmarks_.clear();
+        
+        add_benchmark(new DirectConvolutionBenchmark(taps, min_duration_seconds_));
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTConvolutionBenchmark(taps, false, min_duration_seconds_));
+        add_benchmark(new OTFFTConvolutionBenchmark(taps, true, min_duration_seconds_));
+#endif
+    }
+    
+    // size x size 2D transforms; FFTW3 is the baseline
+    void create_2d_benchmarks(int size, bool is_real) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_FFTW3
+        add_benchmark(new FFTW32DBenchmark(size, is_real, min_duration_seconds_));
+#endif
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFT2DBenchmark(size, is_real, false, min_duration_seconds_));
+        add_benchmark(new OTFFT2DBenchmark(size, is_real, true, min_duration_seconds_));
+#endif
+    }
+    
+    void create_split_benchmarks(int size) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_FFTW3
+        add_benchmark(new FFTW3SplitBenchmark(size, min_duration_seconds_));
+#endif
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTSplitBenchmark(size, false, false, min_duration_seconds_));
+        add_benchmark(new OTFFTSplitBenchmark(size, true, false, min_duration_seconds_));
+        add_benchmark(new OTFFTSplitBenchmark(size, true, true, min_duration_seconds_));
+#endif
+    }
+    
+    // Columns of one DCT/DST table row (R2R_LABELS index) of n points
+    void create_r2r_benchmarks(int n, int kind) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_FFTW3
+        add_benchmark(new FFTW3R2RBenchmark(n, kind, min_duration_seconds_));
+#endif
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTR2RBenchmark(n, kind, min_duration_seconds_));
+#endif
+    }
+    
+    // 1, 2, 4, ... threads up to max_threads_ (always included)
+    vector<int> thread_counts() const {
+        const int top = max_threads_ > 0 ? max_threads_ : max(1, int(thread::hardware_concurrency()));
+        vector<int> counts;
+        for (int t = 1; t < top; t *= 2) counts.push_back(t);
+        counts.push_back(top);
+        return counts;
+    }
+    
+    void create_thread_scaling_benchmarks(int size) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_OTFFT
+        for (int t : thread_counts()) {
+            add_benchmark(new OTFFTParallelBenchmark(size, t, min_duration_seconds_));
+        }
+#endif
+    }
+    
+    // A real FFT per hop against the sliding DFT
+    void create_sliding_benchmarks(int size, int hop) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTHopFFTBenchmark(size, hop, min_duration_seconds_));
+        add_benchmark(new OTFFTSlidingBenchmark(size, hop, false, 0, min_duration_seconds_));
+        add_benchmark(new OTFFTSlidingBenchmark(size, hop, true, 0, min_duration_seconds_));
+        add_benchmark(new OTFFTSlidingBenchmark(size, hop, false, 16, min_duration_seconds_));
+#endif
+    }
+    
+    // Upstream ComplexFFT (the whole spectrum) against each partial method
+    void create_partial_benchmarks(int size, int bins) {
+        benchmarks_.clear();
+        
+#ifdef HAVE_OTFFT
+        add_benchmark(new OTFFTComplexBenchmark(size, min_duration_seconds_));
+        const OTFFT::PartialMethod methods[] = {
+            OTFFT::PARTIAL_GOERTZEL, OTFFT::PARTIAL_PRUNED, OTFFT::PARTIAL_FULL, OTFFT::PARTIAL_AUTO
+        };
+        for (OTFFT::PartialMethod m : methods) {
+            add_benchmark(new OTFFTPartialBenchmark(size, bins, m, min_duration_seconds_));
+        }
+#endif
+    }
+    
+    // The file copied sequentially (the raw bandwidth), then file-to-file
+    // transforms out of core and through memory
+    void create_ooc_benchmarks(int size, const string& dir) {
+        benchmarks_.clear();
+        
+        add_benchmark(new SequentialCopyBenchmark(size, dir, min_duration_seconds_));
+#ifdef HAVE_OTFFT
+#ifdef OTFFT_EXT_HAS_OUT_OF_CORE
+        add_benchmark(new OTFFTOutOfCoreBenchmark(size, dir, min_duration_seconds_));
+#endif
+        add_benchmark(new OTFFTInMemoryFileBenchmark(size, dir, min_duration_seconds_));
+#endif
+    }
+    
+    // Drops the plans FFTW (its wisdom) and the extension PlanCache keep,
+    // so that the next setup() plans from scratch
+    static void forget_plans() {
+#ifdef HAVE_FFTW3
+        fftw_forget_wisdom();
+#endif
+#ifdef HAVE_OTFFT
+        OTFFT::PlanCache::instance().clear();
+        OTFFT::Wisdom::instance().clear();
+#endif
+    }
+    
+    struct Lifecycle {
+        BenchmarkStats create;   // setup(): plan and buffers
+        BenchmarkStats first;    // first execute() on the new plan
+        BenchmarkStats destroy;  // cleanup()
+    };
+    
+    // Most plan/run/destroy cycles per cell; slow planners get at least one
+    static const int LIFECYCLE_MAX_REPS = 100;
+    
+    // Creates, runs once and destroys fresh plans until the cycles add up
+    // to min_duration_seconds_
+    Lifecycle measure_lifecycle(FFTBenchmark& bench) const {
+        vector<double> create, first, destroy;
+        double total_us = 0.0;
+        do {
+            forget_plans();
+            auto t0 = chrono::high_resolution_clock::now();
+            bench.setup();
+            auto t1 = chrono::high_resolution_clock::now();
+            bench.execute();
+            auto t2 = chrono::high_resolution_clock::now();
+            bench.cleanup();
+            auto t3 = chrono::high_resolution_clock::now();
+            create.push_back(chrono::duration<double, micro>(t1 - t0).count());
+            first.push_back(chrono::duration<double, micro>(t2 - t1).count());
+            destroy.push_back(chrono::duration<double, micro>(t3 - t2).count());
+            total_us += chrono::duration<double, micro>(t3 - t0).count();
+        } while (total_us < 1e6 * min_duration_seconds_ && create.size() < size_t(LIFECYCLE_MAX_REPS));
+        
+        Lifecycle lc;
+        const int reps = int(create.size());
+        lc.create = FFTBenchmark::summarize(create, accumulate(create.begin(), create.end(), 0.0) / reps, reps);
+        lc.first = FFTBenchmark::summarize(first, accumulate(first.begin(), first.end(), 0.0) / reps, reps);
+        lc.destroy = FFTBenchmark::summarize(destroy, accumulate(destroy.begin(), destroy.end(), 0.0) / reps, reps);
+        return lc;
+    }
+    
+    // Runs instances[t] on a thread of its own, all at once, for
+    // min_duration_seconds_ after a common warmup. Setup and cleanup run on
+    // the thread that uses the instance, so its buffers are first touched
+    // there, but one at a time: FFTW's planner is not thread-safe. Returns
+    // the elapsed seconds; calls[t] is what thread t completed in them.
+    double run_concurrent(const vector<FFTBenchmark*>& instances, vector<long long>& calls) const {
+        const int n = int(instances.size());
+        mutex setup_mutex;
+        atomic<int> ready(0);
+        atomic<bool> go(false), stop(false);
+        calls.assign(n, 0);
+        
+        vector<thread> threads;
+        for (int t = 0; t < n; ++t) {
+            threads.push_back(thread([&, t] {
+                FFTBenchmark* bench = instances[t];
+                {
+                    lock_guard<mutex> lock(setup_mutex);
+                    bench->setup();
+                }
+                ready.fetch_add(1);
+                // Warm up until every thread is ready and the warmup is over
+                do {
+                    bench->execute();
+                } while (!go.load(memory_order_acquire));
+                long long count = 0;
+                while (!stop.load(memory_order_acquire)) {
+                    bench->execute();
+                    count++;
+                }
+                calls[t] = count;
+                lock_guard<mutex> lock(setup_mutex);
+                bench->cleanup();
+            }));
+        }
+        
+        while (ready.load() < n) this_thread::sleep_for(chrono::milliseconds(1));
+        this_thread::sleep_for(chrono::duration<double>(FFTBenchmark::warmup_seconds));
+        auto start = chrono::high_resolution_clock::now();
+        go.store(true, memory_order_release);
+        this_thread::sleep_for(chrono::duration<double>(min_duration_seconds_));
+        stop.store(true, memory_order_release);
+        auto end = chrono::high_resolution_clock::now();
+        for (thread& th : threads) th.join();
+        
+        return chrono::duration<double>(end - start).count();
+    }
+    
+    void print_table_header() const {
+        cout << left << setw(LABEL_WIDTH) << "Test Type";
+        cout << right << setw(COL_SIZE_WIDTH) << "Size" << " |";
+        
+        // First library (baseline - typically FFTW3)
+        cout << right << setw(TIME_WIDTH) << benchmarks_[0]->getName() << " |";
+        
+        // Other libraries with ratio column
+        for (size_t i = 1; i < benchmarks_.size(); ++i) {
+            cout << right << setw(TIME_WIDTH) << benchmarks_[i]->getName() << " |";
+            cout << right << setw(RATIO_WIDTH) << "Ratio" << " |";
+        }
+        cout << endl;
+        
+        cout << string(calculate_table_width(), '-') << endl;
+    }
+    
+    // Also keeps the statistics behind the row for write_json()/write_csv();
+    // benchmarks_ still holds the columns the results came from
+    void print_results_row(const string& label, int size, const vector<BenchmarkResult>& results) {
+        for (size_t i = 0; i < benchmarks_.size(); ++i) {
+            if (std::isnan(results[i].time_us)) continue;
+            records_.emplace_back(label, size, benchmarks_[i]->getName(), benchmarks_[i]->getStats());
+        }
+        print_row(label, size, results);
+        if (FFTBenchmark::use_counters) print_counter_rows(results);
+    }
+    
+    // With --counters, under each row of times: IPC and misses per call of
+    // every column, in its time cell; n/a where an event was not counted
+    void print_counter_rows(const vector<BenchmarkResult>& results) const {
+        static const struct { const char* label; int event; } rows[] = {
+            { "  IPC", -1 },
+            { "  L1D miss", PerfCounters::L1D_MISSES },
+            { "  LLC miss", PerfCounters::LLC_MISSES },
+            { "  dTLB miss", PerfCounters::DTLB_MISSES },
+            { "  branch miss", PerfCounters::BRANCH_MISSES },
+        };
+        for (const auto& row : rows) {
+            cout << left << setw(LABEL_WIDTH) << row.label;
+            cout << right << setw(COL_SIZE_WIDTH) << "" << " |";
+            for (size_t i = 0; i < results.size(); ++i) {
+                const BenchmarkStats& st = benchmarks_[i]->getStats();
+                const double v = std::isnan(results[i].time_us) ? NAN
+                                 : row.event < 0 ? st.ipc() : st.counters[row.event];
+                print_count(v);
+                if (i > 0) cout << setw(RATIO_WIDTH) << "" << " |";
+            }
+            cout << endl;
+        }
+    }
+    
+    static void print_time(double time_us) {
+        if (std::isnan(time_us)) cout << setw(TIME_WIDTH) << "n/a" << " |";
+        else cout << fixed << setprecision(2) << setw(TIME_WIDTH) << time_us << " |";
+    }
+    
+    // Counts per call: two decimals for small ones (IPC), whole numbers up
+    // to the cell width, then scientific
+    static void print_count(double v) {
+        if (std::isnan(v)) cout << setw(TIME_WIDTH) << "n/a";
+        else if (v < 100) cout << fixed << setprecision(2) << setw(TIME_WIDTH) << v;
+        else if (v < 1e9) cout << fixed << setprecision(0) << setw(TIME_WIDTH) << v;
+        else cout << scientific << setprecision(2) << setw(TIME_WIDTH) << v;
+        cout << " |";
+    }
+    
+    void print_row(const string& label, int size, const vector<BenchmarkResult>& results) const {
+        cout << left << setw(LABEL_WIDTH) << label;
+        cout << right << setw(COL_SIZE_WIDTH) << size << " |";
+        
+        // First library (baseline) time; NaN marks a size the library
+        // does not support
+        print_time(results[0].time_us);
+        
+        // Other libraries with ratio
+        for (size_t i = 1; i < results.size(); ++i) {
+            print_time(results[i].time_us);
+            if (std::isnan(results[i].ratio)) {
+                cout << setw(RATIO_WIDTH) << "-" << " |";
+                continue;
+            }
+            // Large ratios (plan creation) without decimals to keep the width
+            cout << fixed << setprecision(results[i].ratio < 100 ? 2 : 0) << setw(RATIO_WIDTH-1) << results[i].ratio << "x |";
+        }
+        cout << endl;
+    }
+    
+public:
+    BenchmarkRunner(double min_duration_seconds = 1.0)
+        : min_duration_seconds_(min_duration_seconds), pinned_cpu_(-1), max_threads_(0) {}
+    
+    static const char* stat_name(TableStat stat) {
+        switch (stat) {
+        case STAT_MIN: return "min";
+        case STAT_MEDIAN: return "median";
+        case STAT_P99: return "p99";
+        default: return "mean";
+        }
+    }
+    
+    // Keeps only the columns with these names (as in the table headers)
+    void set_libraries(const vector<string>& names) { libraries_ = names; }
+    
+    // Most threads the scaling tables use; 0 for the hardware thread count
+    void set_max_threads(int threads) { max_threads_ = threads; }
+    
+    // Pins the benchmark thread; the thread scaling tests run unpinned
+    bool pin_to_cpu(int cpu) {
+        if (!pin_thread(cpu)) return false;
+        pinned_cpu_ = cpu;
+        return true;
+    }
+    
+    // Banner listing the libraries of the complex table at this size
+    void print_banner(int size) {
+        create_benchmarks(size, false);
+        print_banner();
+    }
+    
+    void run_complex_benchmarks(const vector<int>& sizes) {
+        // Create benchmarks once for header
+        create_benchmarks(sizes[0], false);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== COMPLEX FFT TESTS ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            // Create benchmarks for this size
+            create_benchmarks(size, false);
+            
+            vector<BenchmarkResult> results;
+            double baseline_time = 0.0;
+            
+            // Run benchmarks for each enabled library
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double time = benchmarks_[i]->supported() ? benchmarks_[i]->run() : NAN;
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_time = time;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+            }
+            
+            print_results_row("Complex FFT", size, results);
+        }
+    }
+    
+    void run_real_benchmarks(const vector<int>& sizes) {
+        // Create benchmarks once for header
+        create_benchmarks(sizes[0], true);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== REAL FFT TESTS ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            // Create benchmarks for this size
+            create_benchmarks(size, true);
+            
+            vector<BenchmarkResult> results;
+            double baseline_time = 0.0;
+            
+            // Run benchmarks for each enabled library
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double time = benchmarks_[i]->supported() ? benchmarks_[i]->run() : NAN;
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_time = time;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+            }
+            
+            print_results_row("Real FFT", size, results);
+        }
+    }
+    
+    // Times are per transform: each benchmark call runs `count` transforms
+    void run_batched_benchmarks(const vector<int>& sizes, bool is_real, int count) {
+        // Create benchmarks once for header
+        create_batched_benchmarks(sizes[0], is_real, count);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== BATCHED " << (is_real ? "REAL" : "COMPLEX") << " FFT TESTS ("
+             << count << " transforms per call, time per transform) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            create_batched_benchmarks(size, is_real, count);
+            
+            vector<BenchmarkResult> results;
+            double baseline_time = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double time = benchmarks_[i]->run() / count;
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_time = time;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+            }
+            
+            print_results_row(is_real ? "Batched Real" : "Batched Cplx", size, results);
+        }
+    }
+    
+    // Time to create (and destroy) one FFT object; ratios are relative to
+    // the upstream OTFFT Factory rather than FFTW3
+    void run_plan_benchmarks(const vector<int>& sizes, bool is_real) {
+        create_plan_benchmarks(sizes[0], is_real);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== " << (is_real ? "REAL" : "COMPLEX")
+             << " PLAN CREATION TESTS (ratio vs OTFFT Factory) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            create_plan_benchmarks(size, is_real);
+            
+            vector<BenchmarkResult> results;
+            double baseline_time = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double time = benchmarks_[i]->run();
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_time = time;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+            }
+            
+            print_results_row(is_real ? "Plan Real" : "Plan Cplx", size, results);
+        }
+    }
+    
+    // Plan creation, first call and destruction of fresh plans for every
+    // library, FFTW3 under ESTIMATE (the baseline), MEASURE and PATIENT,
+    // next to the steady-state time per call. "B/E vs X" rows give the
+    // number of transforms after which the column's total time (creation
+    // plus runs) crosses that of FFTW mode X: the mode with the faster runs
+    // wins from there on. "-" means one side is ahead at every count.
+    void run_lifecycle_benchmarks(const vector<int>& sizes, bool is_real) {
+        create_lifecycle_benchmarks(sizes[0], is_real);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== " << (is_real ? "REAL" : "COMPLEX")
+             << " PLAN LIFECYCLE (us, ratio vs first column; B/E in transforms) ==========" << endl;
+        print_table_header();
+        const string prefix = is_real ? "Lifecycle Real " : "Lifecycle Cplx ";
+#ifdef HAVE_OTFFT
+        // Each cycle forgets the wisdom; the other tables get it back after
+        ostringstream wisdom;
+        OTFFT::Wisdom::instance().save(wisdom);
+#endif
+        
+        for (int size : sizes) {
+            create_lifecycle_benchmarks(size, is_real);
+            const size_t cols = benchmarks_.size();
+            
+            vector<Lifecycle> cycles;
+            vector<double> create(cols), run(cols);
+            for (size_t i = 0; i < cols; ++i) {
+                if (!benchmarks_[i]->supported()) {
+                    cycles.push_back(Lifecycle());
+                    create[i] = run[i] = NAN;
+                    continue;
+                }
+                cycles.push_back(measure_lifecycle(*benchmarks_[i]));
+                benchmarks_[i]->run();
+                create[i] = cycles[i].create.value(FFTBenchmark::table_stat);
+                run[i] = benchmarks_[i]->getStats().value(FFTBenchmark::table_stat);
+            }
+            
+            const char* labels[] = {"Create", "First call", "Destroy", "Run"};
+            for (int row = 0; row < 4; ++row) {
+                vector<BenchmarkResult> results;
+                for (size_t i = 0; i < cols; ++i) {
+                    const BenchmarkStats& st = row == 0 ? cycles[i].create : row == 1 ? cycles[i].first
+                                             : row == 2 ? cycles[i].destroy : benchmarks_[i]->getStats();
+                    const double time = std::isnan(run[i]) ? NAN : st.value(FFTBenchmark::table_stat);
+                    results.emplace_back(benchmarks_[i]->getName(), time, i ? results[0].time_us : time);
+                    if (!std::isnan(time)) records_.emplace_back(prefix + labels[row], size, benchmarks_[i]->getName(), st);
+                }
+                print_row(labels[row], size, results);
+            }
+            
+            for (size_t m = 0; m < cols; ++m) {
+                const string mode = benchmarks_[m]->getName();
+                if (mode.compare(0, 4, "FFTW") != 0) continue;
+                cout << left << setw(LABEL_WIDTH) << "B/E vs " + mode;
+                cout << right << setw(COL_SIZE_WIDTH) << size << " |";
+                for (size_t i = 0; i < cols; ++i) {
+                    const double transforms = (create[m] - create[i]) / (run[i] - run[m]);
+                    cout << setw(TIME_WIDTH);
+                    if (i != m && transforms > 0 && transforms < 1e12) cout << fixed << setprecision(0) << ceil(transforms);
+                    else cout << "-";
+                    cout << " |";
+                    if (i) cout << setw(RATIO_WIDTH) << "" << " |";
+                }
+                cout << endl;
+            }
+        }
+#ifdef HAVE_OTFFT
+        istringstream saved(wisdom.str());
+        OTFFT::Wisdom::instance().load(saved);
+#endif
+    }
+    
+    // OTFFTf under each forced kernel level; ratios are relative to the
+    // scalar kernels
+    void run_isa_benchmarks(const vector<int>& sizes, bool is_real) {
+        create_isa_benchmarks(sizes[0], is_real);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== " << (is_real ? "REAL" : "COMPLEX")
+             << " FFT PER ISA LEVEL (OTFFTf, ratio vs scalar) ==========" << endl;
         print_table_header();
         
         for (int size : sizes) {
-            // Create benchmarks for this size
-            create_benchmarks(size, false);
+            create_isa_benchmarks(size, is_real);
+            
+            vector<BenchmarkResult> results;
+            double baseline_time = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double time = benchmarks_[i]->run();
+                
+                // First level is the baseline
+                if (i == 0) {
+                    baseline_time = time;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+            }
+            
+            print_results_row(is_real ? "ISA Real" : "ISA Cplx", size, results);
+        }
+    }
+    
+    // Throughput in thousands of frames per second; ratios are throughput
+    // relative to the hand-rolled loop (> 1 is faster)
+    void run_stft_benchmarks(const vector<int>& sizes) {
+        create_stft_benchmarks(sizes[0]);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== STREAMING STFT TESTS (hop = size/4, kframes/s, ratio vs OTloop) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            create_stft_benchmarks(size);
+            
+            vector<BenchmarkResult> results;
+            double baseline_rate = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double rate = 1e3 * STFT_FRAMES / benchmarks_[i]->run();
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_rate = rate;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), rate, baseline_rate);
+            }
+            
+            print_results_row("STFT", size, results);
+        }
+    }
+    
+    // Effective bandwidth in GB/s, the bytes of the input file over the
+    // time of one file-to-file call; ratios are relative to the sequential
+    // copy. The copy reads and writes the data once and the out-of-core
+    // transform twice, so about 0.5 is the bound where the disk limits.
+    // Files smaller than free memory stay in the page cache, which is then
+    // what both measure.
+    void run_ooc_benchmarks(const vector<int>& sizes, const string& dir) {
+        create_ooc_benchmarks(sizes[0], dir);
+        if (benchmarks_.size() < 2) return;
+        
+        cout << "\n========== OUT-OF-CORE FFT (files in " << dir << ", GB/s, ratio vs sequential copy) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            create_ooc_benchmarks(size, dir);
+            
+            vector<BenchmarkResult> results;
+            double baseline_rate = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double rate = 1e-3 * size * 2 * sizeof(double) / benchmarks_[i]->run();
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_rate = rate;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), rate, baseline_rate);
+            }
+            
+            print_results_row("Out-of-core", size, results);
+        }
+    }
+    
+    // Throughput in millions of samples per second; ratios are throughput
+    // relative to direct convolution (> 1 is faster)
+    void run_convolution_benchmarks(const vector<int>& taps) {
+        create_convolution_benchmarks(taps[0]);
+        if (benchmarks_.size() < 2) return;
+        
+        cout << "\n========== FIR CONVOLUTION TESTS (size = taps, block " << CONV_BLOCK
+             << ", Msamples/s, ratio vs Direct) ==========" << endl;
+        print_table_header();
+        
+        for (int size : taps) {
+            create_convolution_benchmarks(size);
+            
+            vector<BenchmarkResult> results;
+            double baseline_rate = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double rate = CONV_CHUNK / benchmarks_[i]->run();
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_rate = rate;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), rate, baseline_rate);
+            }
+            
+            print_results_row("Convolution", size, results);
+        }
+    }
+    
+    // Spectra per second in thousands, one per hop of new samples; ratios
+    // are rates relative to a real FFT per hop (> 1 is faster)
+    void run_sliding_benchmarks(const vector<int>& sizes, int hop) {
+        create_sliding_benchmarks(sizes[0], hop);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== SLIDING DFT (hop = " << hop << ", kupdates/s, ratio vs FFT/hop) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            if (size < hop) continue;
+            create_sliding_benchmarks(size, hop);
+            
+            vector<BenchmarkResult> results;
+            double baseline_rate = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double rate = 1e3 * SDFT_HOPS / benchmarks_[i]->run();
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_rate = rate;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), rate, baseline_rate);
+            }
+            
+            print_results_row("Sliding DFT", size, results);
+        }
+    }
+    
+    void run_2d_benchmarks(const vector<int>& sizes, bool is_real) {
+        create_2d_benchmarks(sizes[0], is_real);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== 2D " << (is_real ? "REAL" : "COMPLEX") << " FFT TESTS (size x size) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            create_2d_benchmarks(size, is_real);
             
             vector<BenchmarkResult> results;
             double baseline_time = 0.0;
             
-            // Run benchmarks for each enabled library
             for (size_t i = 0; i < benchmarks_.size(); ++i) {
                 double time = benchmarks_[i]->run();
                 
@@ -714,25 +3437,25 @@ public:
                 results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
             }
             
-            print_results_row("Complex FFT", size, results);
+            print_results_row(is_real ? "2D Real" : "2D Complex", size, results);
         }
     }
     
-    void run_real_benchmarks(const vector<int>& sizes) {
-        cout << "\n========== REAL FFT TESTS ==========" << endl;
+    // Split-format input and output; OTilv includes the interleave and
+    // deinterleave copies
+    void run_split_benchmarks(const vector<int>& sizes) {
+        create_split_benchmarks(sizes[0]);
+        if (benchmarks_.empty()) return;
         
-        // Create benchmarks once for header
-        create_benchmarks(sizes[0], true);
+        cout << "\n========== SPLIT-COMPLEX FFT TESTS (separate re/im arrays) ==========" << endl;
         print_table_header();
         
         for (int size : sizes) {
-            // Create benchmarks for this size
-            create_benchmarks(size, true);
+            create_split_benchmarks(size);
             
             vector<BenchmarkResult> results;
             double baseline_time = 0.0;
             
-            // Run benchmarks for each enabled library
             for (size_t i = 0; i < benchmarks_.size(); ++i) {
                 double time = benchmarks_[i]->run();
                 
@@ -744,7 +3467,370 @@ public:
                 results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
             }
             
-            print_results_row("Real FFT", size, results);
+            print_results_row("Split Complex", size, results);
+        }
+    }
+    
+    // One row per kind at each size, the Size column showing the points of
+    // the row (size+1 for DCT-I, size-1 for DST-I); the MDCT row is N
+    // coefficients from 2N samples, FFTW3's being the same fold around its
+    // REDFT11
+    void run_r2r_benchmarks(const vector<int>& sizes) {
+        create_r2r_benchmarks(sizes[0], 1);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== DCT/DST TESTS (fftw_plan_r2r_1d kinds, us) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            for (int kind = 0; kind < R2R_ROWS; ++kind) {
+                const int n = r2r_length(size, kind);
+                create_r2r_benchmarks(n, kind);
+                
+                vector<BenchmarkResult> results;
+                double baseline_time = 0.0;
+                
+                for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                    double time = benchmarks_[i]->run();
+                    
+                    // First library is the baseline
+                    if (i == 0) {
+                        baseline_time = time;
+                    }
+                    
+                    results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+                }
+                
+                print_results_row(R2R_LABELS[kind], n, results);
+            }
+        }
+    }
+    
+    // Six-step transform per pool size; ratios are relative to one thread
+    void run_thread_scaling_benchmarks(const vector<int>& sizes) {
+        create_thread_scaling_benchmarks(sizes[0]);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== PARALLEL FFT THREAD SCALING (fwd+inv, ratio vs 1 thread) ==========" << endl;
+        print_table_header();
+        
+        // Pool threads inherit the affinity of the thread that starts them
+        if (pinned_cpu_ >= 0) unpin_thread();
+        
+        for (int size : sizes) {
+            create_thread_scaling_benchmarks(size);
+            
+            vector<BenchmarkResult> results;
+            double baseline_time = 0.0;
+            
+            for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                double time = benchmarks_[i]->run();
+                
+                // First library is the baseline
+                if (i == 0) {
+                    baseline_time = time;
+                }
+                
+                results.emplace_back(benchmarks_[i]->getName(), time, baseline_time);
+            }
+            
+            print_results_row("Parallel FFT", size, results);
+        }
+        
+        benchmarks_.clear();
+        if (pinned_cpu_ >= 0) pin_thread(pinned_cpu_);
+    }
+    
+    // The 1D complex or real columns with an independent instance per
+    // thread, 1, 2, 4, ... threads at once: one transform stream per core.
+    // Each cell is the aggregate rate in thousands of transforms per second
+    // and the scaling efficiency, rate / (threads * rate on one thread).
+    // The JSON/CSV records hold per-call times with one sample per thread.
+    void run_throughput_benchmarks(const vector<int>& sizes, bool is_real) {
+        create_benchmarks(sizes[0], is_real);
+        if (benchmarks_.empty()) return;
+        
+        const int cols = int(benchmarks_.size());
+        const int width = LABEL_WIDTH + COL_SIZE_WIDTH + 2 + cols * (TIME_WIDTH + RATIO_WIDTH + 4);
+        cout << "\n========== " << (is_real ? "REAL" : "COMPLEX")
+             << " FFT THROUGHPUT (instance per thread, ktransforms/s, efficiency vs 1 thread) ==========" << endl;
+        cout << left << setw(LABEL_WIDTH) << "Threads";
+        cout << right << setw(COL_SIZE_WIDTH) << "Size" << " |";
+        for (int i = 0; i < cols; ++i) {
+            cout << right << setw(TIME_WIDTH) << benchmarks_[i]->getName() << " |";
+            cout << right << setw(RATIO_WIDTH) << "Eff" << " |";
+        }
+        cout << endl << string(width, '-') << endl;
+        
+        // Pool threads inherit the affinity of the thread that starts them
+        if (pinned_cpu_ >= 0) unpin_thread();
+        
+        for (int size : sizes) {
+            vector<double> single(cols, 0.0);
+            for (int threads : thread_counts()) {
+                // threads copies of the column set
+                vector<vector<unique_ptr<FFTBenchmark>>> sets(threads);
+                for (int t = 0; t < threads; ++t) {
+                    create_benchmarks(size, is_real);
+                    sets[t] = std::move(benchmarks_);
+                }
+                
+                ostringstream label;
+                label << threads << (threads == 1 ? " thread" : " threads");
+                cout << left << setw(LABEL_WIDTH) << label.str();
+                cout << right << setw(COL_SIZE_WIDTH) << size << " |";
+                for (int i = 0; i < cols; ++i) {
+                    if (!sets[0][i]->supported()) {
+                        print_time(NAN);
+                        cout << setw(RATIO_WIDTH) << "-" << " |";
+                        continue;
+                    }
+                    vector<FFTBenchmark*> instances;
+                    for (int t = 0; t < threads; ++t) instances.push_back(sets[t][i].get());
+                    vector<long long> calls;
+                    const double seconds = run_concurrent(instances, calls);
+                    
+                    long long total = 0;
+                    vector<double> per_call_us;
+                    for (int t = 0; t < threads; ++t) {
+                        total += calls[t];
+                        per_call_us.push_back(1e6 * seconds / max(calls[t], 1LL));
+                    }
+                    const double rate = total / seconds;
+                    if (threads == 1) single[i] = rate;
+                    const double efficiency = rate / (threads * single[i]);
+                    
+                    cout << fixed << setprecision(2) << setw(TIME_WIDTH) << rate / 1e3 << " |";
+                    cout << fixed << setprecision(2) << setw(RATIO_WIDTH) << efficiency << " |" << flush;
+                    
+                    const double mean_us = 1e6 * seconds * threads / max(total, 1LL);
+                    BenchmarkStats stats = FFTBenchmark::summarize(per_call_us, mean_us, int(min<long long>(total, INT_MAX)));
+                    records_.emplace_back((is_real ? "Throughput Real " : "Throughput Cplx ") + label.str(),
+                                          size, sets[0][i]->getName(), stats);
+                }
+                cout << endl;
+            }
+        }
+        
+        if (pinned_cpu_ >= 0) pin_thread(pinned_cpu_);
+    }
+    
+#ifdef HAVE_OTFFT
+    // Block latency through the lock-free pipeline (SPSC) and through the
+    // same ring handed over under a mutex (Mutex), real and complex, paced
+    // at one block per two one-shot transform times so that the ring does
+    // not fill up. With three or more CPUs the producer, transform and
+    // consumer threads run pinned to CPUs 0, 1 and 2. Cells are us from
+    // submit_input() to the consumer holding the spectrum; Overrun counts
+    // producer ticks that found the ring full.
+    void run_pipeline_benchmarks(const vector<int>& sizes) {
+        const bool pin = thread::hardware_concurrency() >= 3;
+        const int width = LABEL_WIDTH + COL_SIZE_WIDTH + 2 + 5 * (TIME_WIDTH + 2);
+        cout << "\n========== FFT PIPELINE LATENCY (submit to consume, us per block, "
+             << (pin ? "threads on CPUs 0, 1, 2" : "threads unpinned") << ") ==========" << endl;
+        cout << left << setw(LABEL_WIDTH) << "Pipeline";
+        cout << right << setw(COL_SIZE_WIDTH) << "Size" << " |";
+        for (const char* h : {"p50", "p99", "max", "Blocks", "Overrun"}) cout << right << setw(TIME_WIDTH) << h << " |";
+        cout << endl << string(width, '-') << endl;
+        
+        if (pin) pin_thread(2);
+        else if (pinned_cpu_ >= 0) unpin_thread();
+        
+        for (int size : sizes) {
+            for (int is_real = 1; is_real >= 0; --is_real) {
+                if (!ext_supports(size, is_real != 0)) continue;
+                const OTFFT::PipelineTransform transform = is_real ? OTFFT::PIPELINE_REAL : OTFFT::PIPELINE_COMPLEX;
+                const long long period_ns = max(2000LL, llround(2e3 * transform_time_us(size, is_real != 0)));
+                const int blocks = int(min(1e6, max(256.0, min_duration_seconds_ * 1e9 / period_ns)));
+                const int warmup = int(min(double(blocks), max(16.0, FFTBenchmark::warmup_seconds * 1e9 / period_ns)));
+                
+                for (int spsc = 1; spsc >= 0; --spsc) {
+                    unique_ptr<OTFFT::FFTPipeline> pipe;
+                    if (!spsc) pipe.reset(new MutexFFTPipeline(transform, size, 8, pin ? 1 : -1));
+                    else if (is_real) pipe = OTFFT::FactoryExt::createRealFFTPipeline(size, 8, pin ? 1 : -1);
+                    else pipe = OTFFT::FactoryExt::createComplexFFTPipeline(size, 8, pin ? 1 : -1);
+                    pipeline_latencies(*pipe, warmup, period_ns, pin ? 0 : -1);
+                    const unsigned long long warmup_overruns = pipe->overruns();
+                    vector<double> lat = pipeline_latencies(*pipe, blocks, period_ns, pin ? 0 : -1);
+                    const double mean = accumulate(lat.begin(), lat.end(), 0.0) / lat.size();
+                    BenchmarkStats stats = FFTBenchmark::summarize(lat, mean, blocks);
+                    
+                    const string name = spsc ? "SPSC" : "Mutex";
+                    cout << left << setw(LABEL_WIDTH) << name + (is_real ? " Real" : " Cplx");
+                    cout << right << setw(COL_SIZE_WIDTH) << size << " |";
+                    print_time(stats.median_us);
+                    print_time(stats.p99_us);
+                    print_time(*max_element(lat.begin(), lat.end()));
+                    cout << setw(TIME_WIDTH) << blocks << " |";
+                    cout << setw(TIME_WIDTH) << pipe->overruns() - warmup_overruns << " |" << endl;
+                    records_.emplace_back(is_real ? "Pipeline Real" : "Pipeline Cplx", size, name, stats);
+                }
+            }
+        }
+        
+        if (pinned_cpu_ >= 0) pin_thread(pinned_cpu_);
+        else if (pin) unpin_thread();
+    }
+    
+    // One-shot forward transform of the kind a pipeline stage runs, in us
+    static double transform_time_us(int size, bool is_real) {
+        vector<double> x(2 * size_t(size), 0.5);
+        vector<OTFFT::complex_t> y(size);
+        OTFFT::CompactRealFFTPtr rfft;
+        OTFFT::MixedRadixFFTPtr fft;
+        if (is_real) rfft = OTFFT::FactoryExt::createCompactRealFFT(size);
+        else fft = OTFFT::FactoryExt::createMixedRadixFFT(size);
+        auto once = [&]() {
+            if (is_real) rfft->fwd(x.data(), y.data());
+            else fft->fwd(y.data());
+        };
+        once();
+        int reps = 1;
+        while (true) {
+            const auto t0 = chrono::steady_clock::now();
+            for (int i = 0; i < reps; ++i) once();
+            const double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+            if (us > 1e4) return us / reps;
+            reps *= 2;
+        }
+    }
+    
+    // One row per bin count at each size; the label's letter is the method
+    // Auto picked (G, P or F). After each size, the measured crossovers:
+    // the fewest bins at which pruning beats the Goertzel bank, and at which
+    // the full transform plus a gather beats pruning.
+    void run_partial_benchmarks(const vector<int>& sizes, const vector<int>& bin_counts) {
+        create_partial_benchmarks(sizes[0], 1);
+        if (benchmarks_.empty()) return;
+        
+        cout << "\n========== PARTIAL FFT (selected bins, us, ratio vs full ComplexFFT) ==========" << endl;
+        print_table_header();
+        
+        for (int size : sizes) {
+            int pruned_from = 0, full_from = 0;
+            for (int count : bin_counts) {
+                if (count > size) break;
+                create_partial_benchmarks(size, count);
+                
+                vector<BenchmarkResult> results;
+                double baseline_time = 0.0;
+                map<string, double> times;
+                char picked = '-';
+                
+                for (size_t i = 0; i < benchmarks_.size(); ++i) {
+                    FFTBenchmark& bench = *benchmarks_[i];
+                    double time = bench.supported() ? bench.run() : NAN;
+                    
+                    // First library is the baseline
+                    if (i == 0) {
+                        baseline_time = time;
+                    }
+                    
+                    times[bench.getName()] = time;
+                    if (bench.getName() == "Auto") {
+                        picked = "AGPF"[static_cast<OTFFTPartialBenchmark&>(bench).chosen()];
+                    }
+                    results.emplace_back(bench.getName(), time, baseline_time);
+                }
+                
+                if (!pruned_from && times["Pruned"] < times["Goertz"]) pruned_from = count;
+                if (!full_from && times["Full"] < min(times["Pruned"], times["Goertz"])) full_from = count;
+                
+                ostringstream label;
+                label << count << (count == 1 ? " bin " : " bins ") << picked;
+                print_results_row(label.str(), size, results);
+            }
+            
+            cout << "Crossovers at " << size << ": pruned beats Goertzel from ";
+            if (pruned_from) cout << pruned_from << (pruned_from == 1 ? " bin" : " bins"); else cout << "-";
+            cout << ", full beats both from ";
+            if (full_from) cout << full_from << (full_from == 1 ? " bin" : " bins"); else cout << "-";
+            cout << endl;
+        }
+    }
+    
+    // Bytes per extension plan: twiddle tables plus the workspace one call
+    // needs, for double and float complex and real transforms
+    void run_memory_report(const vector<int>& sizes) const {
+        const int width = 11;
+        cout << "\n========== PLAN MEMORY (bytes per plan: twiddles + workspace) ==========" << endl;
+        cout << left << setw(LABEL_WIDTH) << "Test Type";
+        cout << right << setw(COL_SIZE_WIDTH) << "Size" << " |";
+        cout << right << setw(width) << "Complex" << " |" << setw(width) << "Complexf" << " |";
+        cout << right << setw(width) << "Real" << " |" << setw(width) << "Realf" << " |" << endl;
+        cout << string(LABEL_WIDTH + COL_SIZE_WIDTH + 2 + 4 * (width + 2), '-') << endl;
+        
+        for (int size : sizes) {
+            auto c = OTFFT::FactoryExt::createWorkspaceComplexFFT(size);
+            auto cf = OTFFT::FactoryExt::createWorkspaceComplexFFTf(size);
+            auto r = OTFFT::FactoryExt::createWorkspaceRealFFT(size);
+            auto rf = OTFFT::FactoryExt::createWorkspaceRealFFTf(size);
+            cout << left << setw(LABEL_WIDTH) << "Plan Bytes";
+            cout << right << setw(COL_SIZE_WIDTH) << size << " |";
+            cout << setw(width) << c->plan_bytes() + c->workspace_size() << " |";
+            cout << setw(width) << cf->plan_bytes() + cf->workspace_size() << " |";
+            cout << setw(width) << r->plan_bytes() + r->workspace_size() << " |";
+            cout << setw(width) << rf->plan_bytes() + rf->workspace_size() << " |" << endl;
+        }
+    }
+#endif
+    
+    // One object per table cell: test (row label), size, library (column)
+    // and the per-call statistics in microseconds. Times are per call of
+    // the benchmark, e.g. per batch of BATCH_COUNT transforms in the
+    // batched tables, before any conversion the tables apply.
+    void write_json(ostream& os) const {
+        os << defaultfloat;
+        os << "{\n";
+        os << "  \"compiler\": \"" << json_escape(get_compiler()) << "\",\n";
+        os << "  \"cpu\": \"" << json_escape(get_architecture() + " " + get_cpu_model()) << "\",\n";
+        os << "  \"min_duration_s\": " << min_duration_seconds_ << ",\n";
+        os << "  \"warmup_s\": " << FFTBenchmark::warmup_seconds << ",\n";
+        os << "  \"pinned_cpu\": " << pinned_cpu_ << ",\n";
+        os << "  \"results\": [";
+        for (size_t i = 0; i < records_.size(); ++i) {
+            const BenchmarkRecord& r = records_[i];
+            os << (i ? ",\n" : "\n") << "    {\"test\": \"" << json_escape(r.test) << "\", \"size\": " << r.size
+               << ", \"library\": \"" << json_escape(r.library) << "\", \"iterations\": " << r.stats.iterations
+               << ", \"samples\": " << r.stats.samples << setprecision(6)
+               << ", \"mean_us\": " << r.stats.mean_us << ", \"min_us\": " << r.stats.min_us
+               << ", \"median_us\": " << r.stats.median_us << ", \"p99_us\": " << r.stats.p99_us
+               << ", \"stddev_us\": " << r.stats.stddev_us;
+            if (FFTBenchmark::use_counters) {
+                os << ", \"ipc\": " << json_number(r.stats.ipc());
+                for (int e = 0; e < PerfCounters::EVENTS; ++e) {
+                    os << ", \"" << PerfCounters::name(PerfCounters::Event(e)) << "\": " << json_number(r.stats.counters[e]);
+                }
+            }
+            os << "}";
+        }
+        os << "\n  ]\n}\n";
+    }
+    
+    // The same records as write_json(), one line each after a header line
+    void write_csv(ostream& os) const {
+        os << defaultfloat;
+        os << "test,size,library,iterations,samples,mean_us,min_us,median_us,p99_us,stddev_us";
+        if (FFTBenchmark::use_counters) {
+            os << ",ipc";
+            for (int e = 0; e < PerfCounters::EVENTS; ++e) os << "," << PerfCounters::name(PerfCounters::Event(e));
+        }
+        os << "\n";
+        for (const BenchmarkRecord& r : records_) {
+            os << csv_field(r.test) << "," << r.size << "," << csv_field(r.library) << ","
+               << r.stats.iterations << "," << r.stats.samples << setprecision(6) << ","
+               << r.stats.mean_us << "," << r.stats.min_us << "," << r.stats.median_us << ","
+               << r.stats.p99_us << "," << r.stats.stddev_us;
+            if (FFTBenchmark::use_counters) {
+                // Empty fields for events that were not counted
+                os << ",";
+                if (!std::isnan(r.stats.ipc())) os << r.stats.ipc();
+                for (int e = 0; e < PerfCounters::EVENTS; ++e) {
+                    os << ",";
+                    if (!std::isnan(r.stats.counters[e])) os << r.stats.counters[e];
+                }
+            }
+            os << "\n";
         }
     }
     
@@ -756,14 +3842,243 @@ public:
     }
 };
 
-int main() {
-    vector<int> sizes = {128, 256, 512, 1024, 2048, 4096, 8192, 16384};
+static void print_usage(const char* argv0) {
+    cout << "Usage: " << argv0 << " [options]\n"
+         << "  --sizes N,N,...         1D transform sizes (default 8..16384)\n"
+         << "  --mixed-sizes N,...|none\n"
+         << "                          sizes that are not powers of two, added to the\n"
+         << "                          complex and real tables (default 1000,1536,3000,\n"
+         << "                          48000 and the primes 1009,4099,10007)\n"
+         << "  --sizes-2d N,N,...      2D sizes, N x N (default 64..2048)\n"
+         << "  --taps N,N,...          convolution filter lengths (default 1024..65536)\n"
+         << "  --thread-sizes N,...    thread scaling sizes (default 2^18..2^22)\n"
+         << "  --partial-sizes N,...   partial FFT sizes (default 1024,8192)\n"
+         << "  --partial-bins N,...    partial FFT bin counts (default 1,2,4..256)\n"
+         << "  --ooc-sizes N,...       out-of-core FFT sizes (default 2^20,2^22,2^24)\n"
+         << "  --ooc-dir DIR           directory for the out-of-core files (default .)\n"
+         << "  --tests T,T,...         tables to run: complex real batched plan lifecycle\n"
+         << "                          memory stft sliding conv 2d split dct partial threads\n"
+         << "                          isa throughput ooc pipeline\n"
+         << "                          (default all but isa, throughput, ooc and pipeline)\n"
+         << "  --libs L,L,...          columns to keep, by header name (e.g. FFTW3,OTFFT);\n"
+         << "                          the first one kept is the ratio baseline\n"
+         << "  --duration S            minimum timed seconds per cell (default 1)\n"
+         << "  --warmup S              untimed seconds per cell first (default 0.1)\n"
+         << "  --stat mean|min|median|p99\n"
+         << "                          statistic shown in the tables (default mean)\n"
+         << "  --threads N             most threads in the scaling tables (default: hardware)\n"
+         << "  --cpu N                 pin the benchmark thread to CPU N (Linux)\n"
+         << "  --counters              hardware counters per call under each row and in\n"
+         << "                          the JSON/CSV output (Linux perf_event_open)\n"
+         << "  --json FILE             write all statistics as JSON\n"
+         << "  --csv FILE              write all statistics as CSV\n"
+         << "  --wisdom FILE           load OTtuned's measurements from FILE if it exists\n"
+         << "                          and save them there at the end\n"
+         << "  --isa-levels            same as adding isa to --tests\n";
+}
+
+static vector<string> split_list(const string& text) {
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+static vector<int> parse_sizes(const string& text) {
+    vector<int> sizes;
+    for (const string& item : split_list(text)) {
+        char* end = nullptr;
+        const long n = strtol(item.c_str(), &end, 0);
+        if (*end != '\0' || n <= 0 || n > (1L << 30)) throw invalid_argument("bad size: " + item);
+        sizes.push_back(int(n));
+    }
+    if (sizes.empty()) throw invalid_argument("empty size list");
+    return sizes;
+}
+
+static int parse_cpu(const string& text) {
+    char* end = nullptr;
+    const long n = strtol(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || n < 0 || n > 65535) throw invalid_argument("bad CPU: " + text);
+    return int(n);
+}
+
+static double parse_seconds(const string& text) {
+    char* end = nullptr;
+    const double s = strtod(text.c_str(), &end);
+    if (*end != '\0' || !(s >= 0)) throw invalid_argument("bad duration: " + text);
+    return s;
+}
+
+int main(int argc, char** argv) {
+    vector<int> sizes = {8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384};
+    // Audio block sizes with factors 3, 5 and 7, then primes (Bluestein)
+    vector<int> mixed_sizes = {1000, 1536, 3000, 48000, 1009, 4099, 10007};
+    vector<int> sizes_2d = {64, 128, 256, 512, 1024, 2048};
+    vector<int> taps = {1024, 4096, 8192, 16384, 32768, 65536};
+    vector<int> thread_sizes = {1 << 18, 1 << 19, 1 << 20, 1 << 21, 1 << 22};
+    vector<int> partial_sizes = {1024, 8192};
+    vector<int> partial_bins = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+    vector<int> ooc_sizes = {1 << 20, 1 << 22, 1 << 24};
+    string ooc_dir = ".";
+    vector<string> tests = {"complex", "real", "batched", "plan", "lifecycle", "memory", "stft", "sliding", "conv", "2d",
+                            "split", "dct", "partial", "threads"};
+    vector<string> libraries;
+    double duration = 1.0;
+    int cpu = -1;
+    int max_threads = 0;
+    string json_path, csv_path, wisdom_path;
+    
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            }
+            // --isa-levels: also run the extension kernels under each forced ISA level
+            if (arg == "--isa-levels") {
+                tests.push_back("isa");
+                continue;
+            }
+            if (arg == "--counters") {
+                FFTBenchmark::use_counters = true;
+                continue;
+            }
+            auto next = [&]() -> string {
+                if (i + 1 >= argc) throw invalid_argument("missing value for " + arg);
+                return argv[++i];
+            };
+            if (arg == "--sizes") sizes = parse_sizes(next());
+            else if (arg == "--mixed-sizes") {
+                const string value = next();
+                mixed_sizes = value == "none" ? vector<int>() : parse_sizes(value);
+            }
+            else if (arg == "--sizes-2d") sizes_2d = parse_sizes(next());
+            else if (arg == "--taps") taps = parse_sizes(next());
+            else if (arg == "--thread-sizes") thread_sizes = parse_sizes(next());
+            else if (arg == "--partial-sizes") partial_sizes = parse_sizes(next());
+            else if (arg == "--partial-bins") partial_bins = parse_sizes(next());
+            else if (arg == "--ooc-sizes") ooc_sizes = parse_sizes(next());
+            else if (arg == "--ooc-dir") ooc_dir = next();
+            else if (arg == "--tests") tests = split_list(next());
+            else if (arg == "--libs") libraries = split_list(next());
+            else if (arg == "--duration") duration = parse_seconds(next());
+            else if (arg == "--warmup") FFTBenchmark::warmup_seconds = parse_seconds(next());
+            else if (arg == "--cpu") cpu = parse_cpu(next());
+            else if (arg == "--threads") max_threads = parse_sizes(next())[0];
+            else if (arg == "--json") json_path = next();
+            else if (arg == "--csv") csv_path = next();
+            else if (arg == "--wisdom") wisdom_path = next();
+            else if (arg == "--stat") {
+                const string value = next();
+                if (value == "mean") FFTBenchmark::table_stat = STAT_MEAN;
+                else if (value == "min") FFTBenchmark::table_stat = STAT_MIN;
+                else if (value == "median") FFTBenchmark::table_stat = STAT_MEDIAN;
+                else if (value == "p99") FFTBenchmark::table_stat = STAT_P99;
+                else throw invalid_argument("bad statistic: " + value);
+            }
+            else throw invalid_argument("unknown option " + arg);
+        }
+    } catch (const invalid_argument& e) {
+        cerr << e.what() << endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+    auto selected = [&tests](const char* name) {
+        return find(tests.begin(), tests.end(), name) != tests.end();
+    };
+    
+    // Timing only when the kernel gives no counters at all
+    if (FFTBenchmark::use_counters) {
+        PerfCounters probe;
+        if (!probe.available()) {
+            cerr << "Hardware counters unavailable ("
+                 << (probe.error() ? strerror(probe.error()) : "perf_event_open needs Linux") << "); timing only" << endl;
+            FFTBenchmark::use_counters = false;
+        }
+    }
     
-    // Run each test for at least 1 second
-    BenchmarkRunner runner(1.0);
-    runner.run_complex_benchmarks(sizes);
-    runner.run_real_benchmarks(sizes);
+    BenchmarkRunner runner(duration);
+    runner.set_libraries(libraries);
+    runner.set_max_threads(max_threads);
+    if (cpu >= 0 && !runner.pin_to_cpu(cpu)) {
+        cerr << "Could not pin to CPU " << cpu << "; running unpinned" << endl;
+    }
+    
+#ifdef HAVE_OTFFT
+    if (!wisdom_path.empty() && ifstream(wisdom_path) && !OTFFT::Wisdom::instance().load(wisdom_path)) {
+        cerr << "Ignoring " << wisdom_path << ": not a wisdom file of this version" << endl;
+    }
+#endif
+    runner.print_banner(sizes[0]);
+    vector<int> table_sizes(sizes);
+    table_sizes.insert(table_sizes.end(), mixed_sizes.begin(), mixed_sizes.end());
+    if (selected("complex")) runner.run_complex_benchmarks(table_sizes);
+    if (selected("real")) runner.run_real_benchmarks(table_sizes);
+    if (selected("batched")) {
+        runner.run_batched_benchmarks(sizes, false, BATCH_COUNT);
+        runner.run_batched_benchmarks(sizes, true, BATCH_COUNT);
+    }
+    if (selected("plan")) {
+        runner.run_plan_benchmarks(sizes, false);
+        runner.run_plan_benchmarks(sizes, true);
+    }
+    if (selected("lifecycle")) {
+        runner.run_lifecycle_benchmarks(sizes, false);
+        runner.run_lifecycle_benchmarks(sizes, true);
+    }
+#ifdef HAVE_OTFFT
+    if (selected("memory")) runner.run_memory_report(sizes);
+#endif
+    if (selected("stft")) runner.run_stft_benchmarks(sizes);
+    if (selected("sliding")) {
+        runner.run_sliding_benchmarks(sizes, 1);
+        runner.run_sliding_benchmarks(sizes, 16);
+    }
+    if (selected("conv")) runner.run_convolution_benchmarks(taps);
+    if (selected("2d")) {
+        runner.run_2d_benchmarks(sizes_2d, false);
+        runner.run_2d_benchmarks(sizes_2d, true);
+    }
+    if (selected("split")) runner.run_split_benchmarks(sizes);
+    if (selected("dct")) runner.run_r2r_benchmarks(sizes);
+#ifdef HAVE_OTFFT
+    if (selected("partial")) runner.run_partial_benchmarks(partial_sizes, partial_bins);
+#endif
+    if (selected("threads")) runner.run_thread_scaling_benchmarks(thread_sizes);
+    if (selected("isa")) {
+        runner.run_isa_benchmarks(sizes, false);
+        runner.run_isa_benchmarks(sizes, true);
+    }
+    if (selected("throughput")) {
+        runner.run_throughput_benchmarks(sizes, false);
+        runner.run_throughput_benchmarks(sizes, true);
+    }
+    if (selected("ooc")) runner.run_ooc_benchmarks(ooc_sizes, ooc_dir);
+#ifdef HAVE_OTFFT
+    if (selected("pipeline")) runner.run_pipeline_benchmarks(sizes);
+#endif
     runner.print_footer();
     
+    if (!json_path.empty()) {
+        ofstream out(json_path);
+        runner.write_json(out);
+        if (!out) cerr << "Could not write " << json_path << endl;
+    }
+    if (!csv_path.empty()) {
+        ofstream out(csv_path);
+        runner.write_csv(out);
+        if (!out) cerr << "Could not write " << csv_path << endl;
+    }
+#ifdef HAVE_OTFFT
+    if (!wisdom_path.empty() && !OTFFT::Wisdom::instance().save(wisdom_path)) {
+        cerr << "Could not write " << wisdom_path << endl;
+    }
+#endif
+    
     return 0;
 }
@@ -9,8 +9,8 @@ class OtfftConan(ConanFile):
     license = "MIT"
     author = "Takuya OKAHISA"
     url = "https://github.com/DEWETRON/OTFFT"
-    description = "A high-speed FFT library using Stockham's algorithm and AVX/SSE"
-    topics = ("fft", "performance", "avx", "sse", "simd")
+    description = "A high-speed FFT library using Stockham's algorithm and AVX/SSE, with NEON kernels on armv8"
+    topics = ("fft", "performance", "avx", "sse", "neon", "simd")
 
     # Binary configuration
     settings = "os", "compiler", "build_type", "arch"
@@ -78,6 +78,9 @@ class OtfftConan(ConanFile):
         # Copy headers from inc directory (where OTFFT keeps them)
         self.copy("*.h", dst="include", src=os.path.join(self.source_folder, "inc"), keep_path=False)
         
+        # Copy the header-only extension layer shipped with this recipe
+        self.copy("otfft_ext/*", dst="include", src=os.path.join(self.source_folder, "include"), keep_path=True)
+        
         # Copy generated config header from build folder
         self.copy("otfft_config.h", dst="include", src=os.path.join(self.build_folder, "src"), keep_path=False)
         
@@ -105,6 +108,10 @@ class OtfftConan(ConanFile):
             elif self.settings.compiler == "Visual Studio":
                 self.cpp_info.cppflags.append("/openmp")
 
+        # The otfft_ext executors use std::thread
+        if self.settings.os == "Linux":
+            self.cpp_info.system_libs.append("pthread")
+
         # Set C++ standard requirement
         if self.settings.compiler == "gcc" or self.settings.compiler == "clang":
             self.cpp_info.cppflags.append("-std=c++11")
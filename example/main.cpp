@@ -5,6 +5,7 @@
 // Include OTFFT headers
 #include "otfft.h"
 #include "otfft_fwd.h"
+#include "otfft_ext/real_compact.h"
 
 using namespace std;
 using complex_t = OTFFT::complex_t;
@@ -53,9 +54,9 @@ int main() {
     cout << "\nExample 2: Real FFT (size: " << N << ")" << endl;
     {
         // Allocate memory for real data and spectrum
-        // OTFFT RealFFT requires N complex values for spectrum
+        // The compact RealFFT stores only the N/2+1 non-redundant bins
         vector<double> realInput(N);
-        vector<complex_t> spectrum(N);
+        vector<complex_t> spectrum(N / 2 + 1);
         vector<double> realOutput(N);
         
         // Initialize with test signal
@@ -65,7 +66,7 @@ int main() {
         }
         
         // Create Real FFT object
-        auto rfft = OTFFT::Factory::createRealFFT(N);
+        auto rfft = OTFFT::FactoryExt::createCompactRealFFT(N);
         
         // Perform forward real FFT
         rfft->fwd(realInput.data(), spectrum.data());
@@ -0,0 +1,333 @@
+#ifndef OTFFT_EXT_BATCH_H
+#define OTFFT_EXT_BATCH_H
+
+// Batched ("many") same-size transforms with stride/distance addressing.
+//
+// Element j of transform t is read from in[t*idist + j*istride] and written
+// to out[t*odist + j*ostride]; in and out may be the same buffer with the
+// same layout (in-place). Strided layouts (e.g. interleaved channels) are
+// processed in chunks that are interleaved element-major, so every Stockham
+// stage runs once per chunk and each twiddle factor is loaded once for the
+// whole chunk instead of once per transform; unit-stride complex vectors run
+// straight through the shared plan without the transpose.
+//
+//   auto batch = OTFFT::FactoryExt::createBatchComplexFFT(N);
+//   batch->fwd(channels, data, 1, N);   // channels contiguous vectors
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicBatchComplexFFT {
+public:
+    virtual ~BasicBatchComplexFFT() {}
+    virtual int size() const = 0;
+
+    // fwd is normalized by 1/N and inv is unnormalized, as for ComplexFFT
+    virtual void fwd(int count, const C* in, int istride, int idist,
+                     C* out, int ostride, int odist) const = 0;
+    virtual void inv(int count, const C* in, int istride, int idist,
+                     C* out, int ostride, int odist) const = 0;
+
+    void fwd(int count, C* data, int stride, int dist) const {
+        fwd(count, data, stride, dist, data, stride, dist);
+    }
+    void inv(int count, C* data, int stride, int dist) const {
+        inv(count, data, stride, dist, data, stride, dist);
+    }
+};
+
+// Spectra hold the N/2+1 non-redundant bins 0..N/2 of each transform
+template <typename C>
+class BasicBatchRealFFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicBatchRealFFT() {}
+    virtual int size() const = 0;
+
+    virtual void fwd(int count, const real_type* in, int istride, int idist,
+                     C* out, int ostride, int odist) const = 0;
+    virtual void inv(int count, const C* in, int istride, int idist,
+                     real_type* out, int ostride, int odist) const = 0;
+};
+
+typedef BasicBatchComplexFFT<complex_t> BatchComplexFFT;
+typedef BasicBatchComplexFFT<complexf_t> BatchComplexFFTf;
+typedef BasicBatchRealFFT<complex_t> BatchRealFFT;
+typedef BasicBatchRealFFT<complexf_t> BatchRealFFTf;
+
+typedef std::unique_ptr<BatchComplexFFT> BatchComplexFFTPtr;
+typedef std::unique_ptr<BatchComplexFFTf> BatchComplexFFTfPtr;
+typedef std::unique_ptr<BatchRealFFT> BatchRealFFTPtr;
+typedef std::unique_ptr<BatchRealFFTf> BatchRealFFTfPtr;
+
+namespace detail {
+
+// Number of transforms interleaved per chunk: enough to fill the vector
+// lanes at every stage, few enough that a chunk stays around L2-sized.
+inline int batch_chunk(int n, size_t complex_bytes, int lanes)
+{
+    const size_t budget = 128 * 1024;
+    int b = 1;
+    while (b < 64 && size_t(2 * b) * n * complex_bytes <= budget) b *= 2;
+    return std::max(b, lanes);
+}
+
+// Element-major gather of b complex vectors of length n: x[j*b + t] gets the
+// value whose real part is at src[t*ds + j*es] and imaginary part ims
+// scalars further. Copies run in tiles of 8 elements so that each source
+// cache line is consumed in one go even when ds is a large power of two.
+template <typename T>
+inline void gather_batch(int n, int b, const T* src, ptrdiff_t es, ptrdiff_t ims, ptrdiff_t ds, T* x)
+{
+    const int JB = 8;
+    if (es == 2 && ims == 1) {
+        // contiguous complex input: move each element as one unit
+        for (int j0 = 0; j0 < n; j0 += JB) {
+            const int j1 = std::min(n, j0 + JB);
+            for (int t = 0; t < b; ++t) {
+                const T* sp = src + t * ds + 2 * j0;
+                T* xp = x + 2 * (ptrdiff_t(j0) * b + t);
+                for (int j = j0; j < j1; ++j, sp += 2, xp += 2 * b) {
+                    std::memcpy(xp, sp, 2 * sizeof(T));
+                }
+            }
+        }
+        return;
+    }
+    for (int j0 = 0; j0 < n; j0 += JB) {
+        const int j1 = std::min(n, j0 + JB);
+        for (int t = 0; t < b; ++t) {
+            const T* sp = src + t * ds + j0 * es;
+            T* xp = x + 2 * (ptrdiff_t(j0) * b + t);
+            for (int j = j0; j < j1; ++j, sp += es, xp += 2 * b) {
+                xp[0] = sp[0];
+                xp[1] = sp[ims];
+            }
+        }
+    }
+}
+
+// Inverse of gather_batch
+template <typename T>
+inline void scatter_batch(int n, int b, const T* x, T* dst, ptrdiff_t es, ptrdiff_t ims, ptrdiff_t ds)
+{
+    const int JB = 8;
+    if (es == 2 && ims == 1) {
+        for (int j0 = 0; j0 < n; j0 += JB) {
+            const int j1 = std::min(n, j0 + JB);
+            for (int t = 0; t < b; ++t) {
+                T* dp = dst + t * ds + 2 * j0;
+                const T* xp = x + 2 * (ptrdiff_t(j0) * b + t);
+                for (int j = j0; j < j1; ++j, dp += 2, xp += 2 * b) {
+                    std::memcpy(dp, xp, 2 * sizeof(T));
+                }
+            }
+        }
+        return;
+    }
+    for (int j0 = 0; j0 < n; j0 += JB) {
+        const int j1 = std::min(n, j0 + JB);
+        for (int t = 0; t < b; ++t) {
+            T* dp = dst + t * ds + j0 * es;
+            const T* xp = x + 2 * (ptrdiff_t(j0) * b + t);
+            for (int j = j0; j < j1; ++j, dp += es, xp += 2 * b) {
+                dp[0] = xp[0];
+                dp[ims] = xp[1];
+            }
+        }
+    }
+}
+
+template <typename C>
+class BatchComplexFFTImpl : public BasicBatchComplexFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const StockhamPlan<T>> plan_;
+    int chunk_;
+
+    template <bool Inv>
+    void run(int count, const C* in, int istride, int idist,
+             C* out, int ostride, int odist) const {
+        const int n = plan_->size();
+        const T scale = Inv ? T(1) : T(1) / n;
+        if (istride == 1 && ostride == 1) {
+            // contiguous vectors: transposing to element-major costs more
+            // than the shared twiddle loads save, so run them one by one
+            T* work = thread_scratch<T>(2 * size_t(n));
+            for (int t = 0; t < count; ++t) {
+                const T* src = scalars(in + ptrdiff_t(t) * idist);
+                T* dst = scalars(out + ptrdiff_t(t) * odist);
+                if (Inv) kern_.inv(*plan_, src, dst, work, scale);
+                else kern_.fwd(*plan_, src, dst, work, scale);
+            }
+            return;
+        }
+        T* x = thread_scratch<T>(4 * size_t(n) * chunk_);
+        T* work = x + 2 * size_t(n) * chunk_;
+        for (int t0 = 0; t0 < count; t0 += chunk_) {
+            const int b = std::min(chunk_, count - t0);
+            gather_batch(n, b, scalars(in + ptrdiff_t(t0) * idist),
+                         2 * ptrdiff_t(istride), 1, 2 * ptrdiff_t(idist), x);
+            if (Inv) kern_.inv_batch(*plan_, b, x, work, scale);
+            else kern_.fwd_batch(*plan_, b, x, work, scale);
+            scatter_batch(n, b, x, scalars(out + ptrdiff_t(t0) * odist),
+                          2 * ptrdiff_t(ostride), 1, 2 * ptrdiff_t(odist));
+        }
+    }
+
+public:
+    BatchComplexFFTImpl(int n, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().complex_plan<T>(n, kern)),
+          chunk_(batch_chunk(n, sizeof(C), kern.lanes)) {}
+
+    int size() const override { return plan_->size(); }
+
+    void fwd(int count, const C* in, int istride, int idist,
+             C* out, int ostride, int odist) const override {
+        run<false>(count, in, istride, idist, out, ostride, odist);
+    }
+    void inv(int count, const C* in, int istride, int idist,
+             C* out, int ostride, int odist) const override {
+        run<true>(count, in, istride, idist, out, ostride, odist);
+    }
+};
+
+// Real transforms of size N as complex transforms of size N/2 on the packed
+// samples z[j] = x[2j] + i x[2j+1]; the split into the real spectrum is
+// fused with the scatter to the caller's layout (see RealPlan).
+template <typename C>
+class BatchRealFFTImpl : public BasicBatchRealFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+    int chunk_;
+
+public:
+    BatchRealFFTImpl(int n, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().real_plan<T>(n, kern)),
+          chunk_(batch_chunk(n / 2, sizeof(C), kern.lanes)) {}
+
+    int size() const override { return plan_->size(); }
+
+    void fwd(int count, const T* in, int istride, int idist,
+             C* out, int ostride, int odist) const override {
+        const int n = plan_->size(), h = n / 2;
+        const T f = T(1) / n;
+        const T* w = plan_->twiddles();
+        T* z = thread_scratch<T>(2 * size_t(n) * chunk_);
+        T* work = z + size_t(n) * chunk_;
+        for (int t0 = 0; t0 < count; t0 += chunk_) {
+            const int b = std::min(chunk_, count - t0);
+            gather_batch(h, b, in + ptrdiff_t(t0) * idist,
+                         2 * ptrdiff_t(istride), istride, idist, z);
+            kern_.fwd_batch(plan_->half(), b, z, work, T(1));
+
+            for (int t = 0; t < b; ++t) {
+                T* y = scalars(out + ptrdiff_t(t0 + t) * odist);
+                const ptrdiff_t os = 2 * ptrdiff_t(ostride);
+                const T z0r = z[2 * t], z0i = z[2 * t + 1];
+                y[0] = (z0r + z0i) * f;
+                y[1] = 0;
+                y[h * os] = (z0r - z0i) * f;
+                y[h * os + 1] = 0;
+                for (int k = 1; 2 * k <= h; ++k) {
+                    const T wr = w[2 * k], wi = w[2 * k + 1];
+                    const T* zk = z + 2 * (ptrdiff_t(k) * b + t);
+                    const T* zm = z + 2 * (ptrdiff_t(h - k) * b + t);
+                    const T ar = zk[0], ai = zk[1];
+                    const T br = zm[0], bi = -zm[1];
+                    const T er = T(0.5) * (ar + br), ei = T(0.5) * (ai + bi);
+                    const T or_ = T(0.5) * (ai - bi), oi = T(-0.5) * (ar - br);
+                    const T tr = wr * or_ - wi * oi, ti = wr * oi + wi * or_;
+                    y[k * os] = (er + tr) * f;
+                    y[k * os + 1] = (ei + ti) * f;
+                    y[(h - k) * os] = (er - tr) * f;
+                    y[(h - k) * os + 1] = -(ei - ti) * f;
+                }
+            }
+        }
+    }
+
+    void inv(int count, const C* in, int istride, int idist,
+             T* out, int ostride, int odist) const override {
+        const int n = plan_->size(), h = n / 2;
+        const T* w = plan_->twiddles();
+        T* z = thread_scratch<T>(2 * size_t(n) * chunk_);
+        T* work = z + size_t(n) * chunk_;
+        for (int t0 = 0; t0 < count; t0 += chunk_) {
+            const int b = std::min(chunk_, count - t0);
+            for (int t = 0; t < b; ++t) {
+                const T* y = scalars(in + ptrdiff_t(t0 + t) * idist);
+                const ptrdiff_t is = 2 * ptrdiff_t(istride);
+                z[2 * t] = y[0] + y[h * is];
+                z[2 * t + 1] = y[0] - y[h * is];
+                for (int k = 1; 2 * k <= h; ++k) {
+                    const T wr = w[2 * k], wi = -w[2 * k + 1];
+                    const T ar = y[k * is], ai = y[k * is + 1];
+                    const T br = y[(h - k) * is], bi = -y[(h - k) * is + 1];
+                    const T pr = ar + br, pi = ai + bi;
+                    const T dr = ar - br, di = ai - bi;
+                    const T cr = wr * dr - wi * di, ci = wr * di + wi * dr;
+                    T* zk = z + 2 * (ptrdiff_t(k) * b + t);
+                    T* zm = z + 2 * (ptrdiff_t(h - k) * b + t);
+                    zk[0] = pr - ci;
+                    zk[1] = pi + cr;
+                    zm[0] = pr + ci;
+                    zm[1] = -(pi - cr);
+                }
+            }
+            kern_.inv_batch(plan_->half(), b, z, work, T(1));
+            scatter_batch(h, b, z, out + ptrdiff_t(t0) * odist,
+                          2 * ptrdiff_t(ostride), ostride, odist);
+        }
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline BatchComplexFFTPtr createBatchComplexFFT(int n)
+{
+    return BatchComplexFFTPtr(
+        new detail::BatchComplexFFTImpl<complex_t>(n, detail::active_kernels<double>()));
+}
+
+inline BatchComplexFFTfPtr createBatchComplexFFTf(int n)
+{
+    return BatchComplexFFTfPtr(
+        new detail::BatchComplexFFTImpl<complexf_t>(n, detail::active_kernels<float>()));
+}
+
+inline BatchRealFFTPtr createBatchRealFFT(int n)
+{
+    return BatchRealFFTPtr(
+        new detail::BatchRealFFTImpl<complex_t>(n, detail::active_kernels<double>()));
+}
+
+inline BatchRealFFTfPtr createBatchRealFFTf(int n)
+{
+    return BatchRealFFTfPtr(
+        new detail::BatchRealFFTImpl<complexf_t>(n, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_BATCH_H
@@ -0,0 +1,169 @@
+#ifndef OTFFT_EXT_CONVOLUTION_H
+#define OTFFT_EXT_CONVOLUTION_H
+
+// Streaming FIR filtering by uniformly partitioned overlap-save.
+//
+// The filter is cut into P = ceil(taps/B) partitions of B samples whose
+// 2B-point spectra are computed once at construction. Every B input
+// samples the engine transforms the last 2B inputs, pushes the spectrum
+// into a frequency-domain delay line of P spectra, multiply-accumulates it
+// against the partition spectra (SIMD, via the active kernel set) and
+// keeps the second half of the inverse transform. The cost per sample is
+// two 2B-point real FFTs over B plus about P complex MACs, and the latency
+// is B samples whatever the filter length.
+//
+// All buffers are allocated at construction and reused across calls. The
+// object carries stream state, so each stream needs its own.
+//
+//   auto conv = OTFFT::FactoryExt::createConvolution(h.data(), taps, 512);
+//   conv->process(in, count, out);   // out[t] = (h * in)[t - 512]
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicConvolution {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicConvolution() {}
+    virtual int taps() const = 0;
+    // Partition size B, which is also the latency in samples
+    virtual int block() const = 0;
+
+    // Filters count samples: out[t] is the filter output for input sample
+    // t - block() of the stream. in and out may be the same buffer.
+    virtual void process(const real_type* in, int count, real_type* out) = 0;
+    // Clears the input history and pending output
+    virtual void reset() = 0;
+};
+
+typedef BasicConvolution<complex_t> Convolution;
+typedef BasicConvolution<complexf_t> Convolutionf;
+
+typedef std::unique_ptr<Convolution> ConvolutionPtr;
+typedef std::unique_ptr<Convolutionf> ConvolutionfPtr;
+
+namespace detail {
+
+template <typename C>
+class ConvolutionImpl : public BasicConvolution<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const RealPlan<T>> plan_;  // 2B-point real transform
+    int taps_;
+    int block_;
+    int parts_;
+    AlignedBuffer<T> filter_;  // parts_ spectra of B+1 bins, unnormalized
+    AlignedBuffer<T> fdl_;     // delay line of parts_ input spectra
+    AlignedBuffer<T> acc_;     // B+1 bins
+    AlignedBuffer<T> input_;   // previous block, then the block being filled
+    AlignedBuffer<T> output_;  // output of the last completed block
+    AlignedBuffer<T> frame_;   // 2B samples
+    AlignedBuffer<T> work_;
+    int newest_;  // fdl_ slot of the latest spectrum
+    int fill_;    // samples of the current block received so far
+
+    size_t spectrum_size() const { return 2 * size_t(block_ + 1); }
+
+    void run_block() {
+        const int b = block_;
+        const size_t ss = spectrum_size();
+        newest_ = newest_ + 1 == parts_ ? 0 : newest_ + 1;
+        plan_->fwd(kern_, input_.data(), fdl_.data() + newest_ * ss, work_.data());
+        std::memset(acc_.data(), 0, ss * sizeof(T));
+        // Spectrum of block k-p meets partition p
+        for (int p = 0, slot = newest_; p < parts_; ++p, slot = slot == 0 ? parts_ - 1 : slot - 1) {
+            kern_.cmac(b + 1, fdl_.data() + slot * ss, filter_.data() + p * ss, acc_.data());
+        }
+        plan_->inv(kern_, acc_.data(), frame_.data(), work_.data());
+        std::memcpy(output_.data(), frame_.data() + b, b * sizeof(T));
+        std::memcpy(input_.data(), input_.data() + b, b * sizeof(T));
+    }
+
+public:
+    ConvolutionImpl(const T* h, int taps, int block, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().real_plan<T>(2 * block, kern)), taps_(taps),
+          block_(block), parts_(taps < 1 ? 0 : (taps + block - 1) / block),
+          filter_(parts_ * spectrum_size()), fdl_(parts_ * spectrum_size()), acc_(spectrum_size()),
+          input_(2 * size_t(block)), output_(block), frame_(2 * size_t(block)), work_(2 * size_t(block)),
+          newest_(0), fill_(0) {
+        if (taps < 1) {
+            throw std::invalid_argument("OTFFT ext: convolution needs at least one tap");
+        }
+        const int n = 2 * block;
+        for (int p = 0; p < parts_; ++p) {
+            const int len = std::min(block, taps - p * block);
+            std::memset(frame_.data(), 0, n * sizeof(T));
+            std::memcpy(frame_.data(), h + ptrdiff_t(p) * block, len * sizeof(T));
+            T* hp = filter_.data() + p * spectrum_size();
+            plan_->fwd(kern_, frame_.data(), hp, work_.data());
+            // Undo the 1/N of fwd so that inv(X * H) is the linear convolution
+            for (size_t i = 0; i < spectrum_size(); ++i) hp[i] *= T(n);
+        }
+        reset();
+    }
+
+    int taps() const override { return taps_; }
+    int block() const override { return block_; }
+
+    void process(const T* in, int count, T* out) override {
+        while (count > 0) {
+            const int m = std::min(count, block_ - fill_);
+            // Read the input before writing the output for in == out
+            std::memcpy(input_.data() + block_ + fill_, in, m * sizeof(T));
+            std::memcpy(out, output_.data() + fill_, m * sizeof(T));
+            fill_ += m;
+            in += m;
+            out += m;
+            count -= m;
+            if (fill_ == block_) {
+                run_block();
+                fill_ = 0;
+            }
+        }
+    }
+
+    void reset() override {
+        std::memset(fdl_.data(), 0, fdl_.size() * sizeof(T));
+        std::memset(input_.data(), 0, input_.size() * sizeof(T));
+        std::memset(output_.data(), 0, output_.size() * sizeof(T));
+        newest_ = 0;
+        fill_ = 0;
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// h: taps filter coefficients; block: partition size and latency, with no
+// prime factor above 7 (larger blocks cost less per sample for long filters)
+inline ConvolutionPtr createConvolution(const double* h, int taps, int block)
+{
+    return ConvolutionPtr(new detail::ConvolutionImpl<complex_t>(h, taps, block, detail::active_kernels<double>()));
+}
+
+inline ConvolutionfPtr createConvolutionf(const float* h, int taps, int block)
+{
+    return ConvolutionfPtr(new detail::ConvolutionImpl<complexf_t>(h, taps, block, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_CONVOLUTION_H
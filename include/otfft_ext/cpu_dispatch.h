@@ -0,0 +1,360 @@
+#ifndef OTFFT_EXT_CPU_DISPATCH_H
+#define OTFFT_EXT_CPU_DISPATCH_H
+
+// Runtime selection of the SIMD kernel set.
+//
+// Every extension header compiles its Stockham kernels once per x86
+// instruction set level (SSE2, AVX, AVX2+FMA, AVX-512) regardless of the
+// compiler flags, and FactoryExt objects pick the best level the CPU and OS
+// support (cpuid/xgetbv) when they are created. The level can be capped with
+// the OTFFT_EXT_ISA environment variable (scalar, sse2, avx, avx2, avx512) or
+// with CpuDispatch::force(); objects keep the level they were created with.
+// On AArch64 the levels are scalar and neon.
+//
+//   OTFFT::CpuDispatch::force(OTFFT::ISA_AVX);
+//   auto fft = OTFFT::FactoryExt::createComplexFFTf(N);   // AVX kernels
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "detail/simd.h"
+#include "detail/split_plan.h"
+#include "detail/stockham.h"
+
+#if defined(OTFFT_EXT_X86_DISPATCH)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace OTFFT {
+
+enum IsaLevel {
+    ISA_SCALAR = 0,
+    ISA_SSE2 = 1,
+    ISA_AVX = 2,
+    ISA_AVX2 = 3,    // AVX2 + FMA
+    ISA_AVX512 = 4,  // AVX-512 F + DQ
+    // Levels only compare within one architecture
+    ISA_NEON = 1     // AArch64 Advanced SIMD
+};
+
+class CpuDispatch {
+public:
+    // Best level supported by this CPU and OS
+    static IsaLevel detected() {
+        static const IsaLevel level = detect();
+        return level;
+    }
+
+    // Level used for objects created from now on
+    static IsaLevel active() {
+        const int f = forced().load();
+        const IsaLevel cap = f >= 0 ? IsaLevel(f) : env_level();
+        return cap < detected() ? cap : detected();
+    }
+
+    // Cap the level (clamped to detected()), overriding OTFFT_EXT_ISA
+    static void force(IsaLevel level) { forced().store(int(level)); }
+
+    // Back to OTFFT_EXT_ISA or, if unset, detected()
+    static void reset() { forced().store(-1); }
+
+    // Highest level this architecture has kernels for
+    static IsaLevel top() {
+#if defined(OTFFT_EXT_NEON)
+        return ISA_NEON;
+#else
+        return ISA_AVX512;
+#endif
+    }
+
+    static const char* name(IsaLevel level) {
+#if defined(OTFFT_EXT_NEON)
+        static const char* const names[] = { "scalar", "neon" };
+#else
+        static const char* const names[] = { "scalar", "sse2", "avx", "avx2", "avx512" };
+#endif
+        if (level < ISA_SCALAR || level > top()) return "unknown";
+        return names[level];
+    }
+
+    static bool parse(const char* s, IsaLevel& level) {
+        for (int i = ISA_SCALAR; i <= top(); ++i) {
+            if (std::strcmp(s, name(IsaLevel(i))) == 0) {
+                level = IsaLevel(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static std::atomic<int>& forced() {
+        static std::atomic<int> level(-1);
+        return level;
+    }
+
+    static IsaLevel env_level() {
+        static const IsaLevel level = read_env();
+        return level;
+    }
+
+    static IsaLevel read_env() {
+        IsaLevel level = top();
+        const char* s = std::getenv("OTFFT_EXT_ISA");
+        if (s && !parse(s, level)) level = top();
+        return level;
+    }
+
+#if defined(OTFFT_EXT_X86_DISPATCH)
+    static void cpuid(unsigned leaf, unsigned sub, unsigned r[4]) {
+#if defined(_MSC_VER)
+        int regs[4];
+        __cpuidex(regs, int(leaf), int(sub));
+        for (int i = 0; i < 4; ++i) r[i] = unsigned(regs[i]);
+#else
+        __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+    }
+
+    static unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned lo, hi;
+        __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+    }
+
+    static IsaLevel detect() {
+        unsigned r[4];
+        cpuid(0, 0, r);
+        const unsigned max_leaf = r[0];
+        if (max_leaf < 1) return ISA_SCALAR;
+        cpuid(1, 0, r);
+        const unsigned ecx1 = r[2], edx1 = r[3];
+        if (!(edx1 & (1u << 26))) return ISA_SCALAR;
+        // AVX needs the OS to save the YMM state (OSXSAVE + XCR0 bits 1, 2)
+        if (!(ecx1 & (1u << 27)) || !(ecx1 & (1u << 28))) return ISA_SSE2;
+        const unsigned long long xcr0 = xgetbv0();
+        if ((xcr0 & 0x6) != 0x6) return ISA_SSE2;
+        if (max_leaf < 7) return ISA_AVX;
+        cpuid(7, 0, r);
+        const unsigned ebx7 = r[1];
+        if (!(ebx7 & (1u << 5)) || !(ecx1 & (1u << 12))) return ISA_AVX;
+        // AVX-512 F + DQ, with opmask and ZMM state enabled (XCR0 bits 5-7)
+        if ((ebx7 & (1u << 16)) && (ebx7 & (1u << 17)) && (xcr0 & 0xE0) == 0xE0) return ISA_AVX512;
+        return ISA_AVX2;
+    }
+#elif defined(OTFFT_EXT_NEON)
+    static IsaLevel detect() { return ISA_NEON; }
+#else
+    static IsaLevel detect() { return ISA_SCALAR; }
+#endif
+};
+
+} // namespace OTFFT
+
+// Kernel sets. Each one is compiled inside a target region for its ISA so
+// that the intrinsics inline regardless of the command-line -m flags.
+// A region only adds to those flags, so in a unit built with -mavx2 even
+// the scalar and SSE2 sets are AVX code. The sets live in unnamed
+// namespaces: each translation unit keeps its own copies, and the linker
+// never swaps a baseline unit's kernels for those of a unit built higher.
+
+#define OTFFT_EXT_STR(x) #x
+#if defined(__clang__)
+#define OTFFT_EXT_TARGET_BEGIN(isa) \
+    _Pragma(OTFFT_EXT_STR(clang attribute push(__attribute__((target(isa))), apply_to = function)))
+#define OTFFT_EXT_TARGET_END _Pragma("clang attribute pop")
+#elif defined(__GNUC__)
+#define OTFFT_EXT_TARGET_BEGIN(isa) _Pragma("GCC push_options") _Pragma(OTFFT_EXT_STR(GCC target(isa)))
+#define OTFFT_EXT_TARGET_END _Pragma("GCC pop_options")
+#else
+// MSVC exposes the intrinsics of every ISA without target flags
+#define OTFFT_EXT_TARGET_BEGIN(isa)
+#define OTFFT_EXT_TARGET_END
+#endif
+
+namespace OTFFT {
+namespace detail {
+namespace {
+namespace isa_scalar {
+template <typename T> struct Vec : ScalarVec<T> {};
+#define OTFFT_EXT_ISA_LEVEL 0
+#define OTFFT_EXT_MAX_RADIX 4
+#include "detail/kernels.inc"
+#undef OTFFT_EXT_ISA_LEVEL
+#undef OTFFT_EXT_MAX_RADIX
+} // namespace isa_scalar
+} // namespace
+} // namespace detail
+} // namespace OTFFT
+
+#if defined(OTFFT_EXT_X86_DISPATCH)
+
+OTFFT_EXT_TARGET_BEGIN("sse2")
+namespace OTFFT {
+namespace detail {
+namespace {
+namespace isa_sse2 {
+#define OTFFT_EXT_ISA_LEVEL 1
+#define OTFFT_EXT_MAX_RADIX 4
+#include "detail/simd_x86.inc"
+#include "detail/kernels.inc"
+#undef OTFFT_EXT_ISA_LEVEL
+#undef OTFFT_EXT_MAX_RADIX
+} // namespace isa_sse2
+} // namespace
+} // namespace detail
+} // namespace OTFFT
+OTFFT_EXT_TARGET_END
+
+OTFFT_EXT_TARGET_BEGIN("avx")
+namespace OTFFT {
+namespace detail {
+namespace {
+namespace isa_avx {
+#define OTFFT_EXT_ISA_LEVEL 2
+#define OTFFT_EXT_MAX_RADIX 4
+#include "detail/simd_x86.inc"
+#include "detail/kernels.inc"
+#undef OTFFT_EXT_ISA_LEVEL
+#undef OTFFT_EXT_MAX_RADIX
+} // namespace isa_avx
+} // namespace
+} // namespace detail
+} // namespace OTFFT
+OTFFT_EXT_TARGET_END
+
+OTFFT_EXT_TARGET_BEGIN("avx2,fma")
+namespace OTFFT {
+namespace detail {
+namespace {
+namespace isa_avx2 {
+#define OTFFT_EXT_ISA_LEVEL 3
+#define OTFFT_EXT_MAX_RADIX 4
+#include "detail/simd_x86.inc"
+#include "detail/kernels.inc"
+#undef OTFFT_EXT_ISA_LEVEL
+#undef OTFFT_EXT_MAX_RADIX
+} // namespace isa_avx2
+} // namespace
+} // namespace detail
+} // namespace OTFFT
+OTFFT_EXT_TARGET_END
+
+// 512-bit double registers (4 complex values each) and radix-8 passes,
+// which the 32 vector registers can hold without spilling
+OTFFT_EXT_TARGET_BEGIN("avx512f,avx512dq,avx2,fma")
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 flags the self-initialized _mm512_undefined_*() placeholders the
+// AVX-512 intrinsics pass as their unused merge operand
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+namespace OTFFT {
+namespace detail {
+namespace {
+namespace isa_avx512 {
+#define OTFFT_EXT_ISA_LEVEL 4
+#define OTFFT_EXT_MAX_RADIX 8
+#include "detail/simd_x86.inc"
+#include "detail/kernels.inc"
+#undef OTFFT_EXT_ISA_LEVEL
+#undef OTFFT_EXT_MAX_RADIX
+} // namespace isa_avx512
+} // namespace
+} // namespace detail
+} // namespace OTFFT
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+OTFFT_EXT_TARGET_END
+
+#endif // OTFFT_EXT_X86_DISPATCH
+
+#if defined(OTFFT_EXT_NEON)
+
+// 128-bit registers; AArch64 has 32 of them, enough for radix-8 passes
+namespace OTFFT {
+namespace detail {
+namespace {
+namespace isa_neon {
+#define OTFFT_EXT_ISA_LEVEL 1
+#define OTFFT_EXT_MAX_RADIX 8
+#include "detail/simd_neon.inc"
+#include "detail/kernels.inc"
+#undef OTFFT_EXT_ISA_LEVEL
+#undef OTFFT_EXT_MAX_RADIX
+} // namespace isa_neon
+} // namespace
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_NEON
+
+namespace OTFFT {
+namespace detail {
+
+template <typename T>
+inline const KernelTable<T>& kernels(IsaLevel level)
+{
+    switch (level) {
+#if defined(OTFFT_EXT_X86_DISPATCH)
+    case ISA_AVX512: return isa_avx512::kernel_table<T>();
+    case ISA_AVX2: return isa_avx2::kernel_table<T>();
+    case ISA_AVX: return isa_avx::kernel_table<T>();
+    case ISA_SSE2: return isa_sse2::kernel_table<T>();
+#elif defined(OTFFT_EXT_NEON)
+    case ISA_NEON: return isa_neon::kernel_table<T>();
+#endif
+    default: return isa_scalar::kernel_table<T>();
+    }
+}
+
+// Kernels for objects created now
+template <typename T>
+inline const KernelTable<T>& active_kernels()
+{
+    return kernels<T>(CpuDispatch::active());
+}
+
+// The kernels of one level with plans laid out for max_radix 4 or 8
+// instead of the level's own choice; every kernel set runs both. The
+// tuning planner (wisdom.h) tries both. A level above top() is clamped to
+// it; any other radix throws.
+template <typename T>
+inline const KernelTable<T>& kernels(IsaLevel level, int max_radix)
+{
+    if (max_radix != 4 && max_radix != 8) {
+        throw std::invalid_argument("OTFFT ext: kernel max_radix must be 4 or 8");
+    }
+    if (level < ISA_SCALAR) level = ISA_SCALAR;
+    if (level > CpuDispatch::top()) level = CpuDispatch::top();
+    struct Tables {
+        std::vector<KernelTable<T>> t;
+        Tables() {
+            for (int i = ISA_SCALAR; i <= CpuDispatch::top(); ++i) {
+                for (int r = 4; r <= 8; r += 4) {
+                    t.push_back(kernels<T>(IsaLevel(i)));
+                    t.back().max_radix = r;
+                }
+            }
+        }
+    };
+    static const Tables tables;
+    return tables.t[2 * level + (max_radix == 8 ? 1 : 0)];
+}
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_CPU_DISPATCH_H
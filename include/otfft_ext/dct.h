@@ -0,0 +1,446 @@
+#ifndef OTFFT_EXT_DCT_H
+#define OTFFT_EXT_DCT_H
+
+// Real-to-real trigonometric transforms: DCT and DST of types I to IV, and
+// the MDCT.
+//
+// R2RTransform computes exactly what FFTW's fftw_plan_r2r_1d computes for
+// the matching kind, unnormalized:
+//   DCT_I   REDFT00   y[k] = x[0] + (-1)^k x[N-1] + 2 sum_{j=1}^{N-2} x[j] cos(pi j k / (N-1))
+//   DCT_II  REDFT10   y[k] = 2 sum_j x[j] cos(pi (2j+1) k / 2N)
+//   DCT_III REDFT01   y[k] = x[0] + 2 sum_{j>=1} x[j] cos(pi j (2k+1) / 2N)
+//   DCT_IV  REDFT11   y[k] = 2 sum_j x[j] cos(pi (2j+1)(2k+1) / 4N)
+//   DST_I   RODFT00   y[k] = 2 sum_j x[j] sin(pi (j+1)(k+1) / (N+1))
+//   DST_II  RODFT10   y[k] = 2 sum_j x[j] sin(pi (2j+1)(k+1) / 2N)
+//   DST_III RODFT01   y[k] = (-1)^k x[N-1] + 2 sum_{j<N-1} x[j] sin(pi (j+1)(2k+1) / 2N)
+//   DST_IV  RODFT11   y[k] = 2 sum_j x[j] sin(pi (2j+1)(2k+1) / 4N)
+// DCT-I, DST-I and the type IV transforms are their own inverses up to a
+// factor of 2(N-1), 2(N+1) and 2N; types II and III invert each other up to
+// a factor of 2N.
+//
+// None of them runs a complex FFT of the 2N- or 4N-point symmetric
+// extension. Types II and III are one real FFT of N points, i.e. an
+// N/2-point complex core, between a permutation and a twiddle pass.
+// Type IV is an N/2-point complex FFT between two twiddle passes. Type I
+// is a real FFT of N-1 (DST: N+1) points, with the odd outputs summed up
+// from it. The DSTs are the DCTs of the input with every other sample
+// negated or reversed. Sizes must be even, with no prime factor above 7
+// in N/2; for type I N-1 (DST: N+1) must be such a size.
+//
+// MDCT::fwd() windows a block of 2N samples, folds it into N, and runs the
+// DCT-IV core, so N coefficients cost an N/2-point complex FFT:
+//   X[k] = sum_{n<2N} w[n] x[n] cos(pi/N (n + 1/2 + N/2)(k + 1/2))
+// inv() returns the 2N windowed samples of
+//   y[n] = 2 w[n] / N sum_k X[k] cos(pi/N (n + 1/2 + N/2)(k + 1/2)),
+// and blocks taken with a hop of N overlap-add back to the signal when
+// w[n]^2 + w[n+N]^2 = 1 and w is symmetric, as for the default sine window.
+// Neither object keeps state between calls.
+//
+//   auto dct = OTFFT::FactoryExt::createR2R(N, OTFFT::DCT_II);
+//   dct->execute(x, y);                        // x may equal y
+//   auto mdct = OTFFT::FactoryExt::createMDCT(N);
+//   mdct->fwd(block, coefficients);            // 2N samples -> N
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+
+namespace OTFFT {
+
+enum R2RKind { DCT_I, DCT_II, DCT_III, DCT_IV, DST_I, DST_II, DST_III, DST_IV };
+
+template <typename C>
+class BasicR2RTransform {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicR2RTransform() {}
+    virtual int size() const = 0;
+    virtual R2RKind kind() const = 0;
+    // x: size() reals -> y: size() reals; x may equal y
+    virtual void execute(const real_type* x, real_type* y) const = 0;
+};
+
+typedef BasicR2RTransform<complex_t> R2RTransform;
+typedef BasicR2RTransform<complexf_t> R2RTransformf;
+
+typedef std::unique_ptr<R2RTransform> R2RTransformPtr;
+typedef std::unique_ptr<R2RTransformf> R2RTransformfPtr;
+
+template <typename C>
+class BasicMDCT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicMDCT() {}
+    // Coefficients per block, N; a block has 2N samples
+    virtual int size() const = 0;
+    // x: 2N samples -> X: N coefficients
+    virtual void fwd(const real_type* x, real_type* X) const = 0;
+    // X: N coefficients (only read) -> y: 2N samples, to overlap-add
+    virtual void inv(const real_type* X, real_type* y) const = 0;
+};
+
+typedef BasicMDCT<complex_t> MDCT;
+typedef BasicMDCT<complexf_t> MDCTf;
+
+typedef std::unique_ptr<MDCT> MDCTPtr;
+typedef std::unique_ptr<MDCTf> MDCTfPtr;
+
+namespace detail {
+
+// Sizes whose half a StockhamPlan runs: the real FFT and DCT-IV cores
+inline bool dct_size_ok(int n)
+{
+    return n >= 2 && n % 2 == 0 && is_smooth(n / 2);
+}
+
+// DCT-IV (or DST-IV) of N points through an N/2-point complex FFT:
+// z[j] = (x[2j] + i x[N-1-2j]) e^{-i pi (4j+1) / 4N}, Z = FFT(z), then
+// u[k] = Z[k] e^{-i pi k / N} gives y[2k] = Re u[k], y[N-1-2k] = -Im u[k]
+template <typename T>
+class DCT4Core {
+    const KernelTable<T>& kern_;
+    int n_;
+    std::shared_ptr<const StockhamPlan<T>> plan_;
+    AlignedBuffer<T> pre_;   // N/2 complex twiddles
+    AlignedBuffer<T> post_;  // N/2 complex twiddles
+
+public:
+    DCT4Core(int n, const KernelTable<T>& kern)
+        : kern_(kern), n_(n), plan_(PlanCache::instance().complex_plan<T>(n / 2, kern)), pre_(n), post_(n) {
+        for (int j = 0; j < n / 2; ++j) {
+            pre_[2 * j] = T(cos(-M_PI * (4 * j + 1) / (4.0 * n)));
+            pre_[2 * j + 1] = T(sin(-M_PI * (4 * j + 1) / (4.0 * n)));
+            post_[2 * j] = T(cos(-M_PI * j / n));
+            post_[2 * j + 1] = T(sin(-M_PI * j / n));
+        }
+    }
+
+    int size() const { return n_; }
+
+    // y[k] = scale * sum_j x[j] cos(pi (2j+1)(2k+1) / 4N), or the sine for
+    // sine = true (the DCT-IV of x reversed, odd outputs negated). x may
+    // equal y. Uses scratch slot 0.
+    void run(const T* x, T* y, T scale, bool sine) const {
+        const int n = n_, m = n / 2;
+        T* z = thread_scratch<T>(2 * size_t(n));
+        T* work = z + n;
+        for (int j = 0; j < m; ++j) {
+            T re = x[2 * j], im = x[n - 1 - 2 * j];
+            if (sine) std::swap(re, im);
+            const T wr = pre_[2 * j], wi = pre_[2 * j + 1];
+            z[2 * j] = re * wr - im * wi;
+            z[2 * j + 1] = re * wi + im * wr;
+        }
+        kern_.fwd(*plan_, z, z, work, scale);
+        for (int k = 0; k < m; ++k) {
+            const T zr = z[2 * k], zi = z[2 * k + 1];
+            const T wr = post_[2 * k], wi = post_[2 * k + 1];
+            y[2 * k] = zr * wr - zi * wi;
+            const T ui = zr * wi + zi * wr;
+            y[n - 1 - 2 * k] = sine ? ui : -ui;
+        }
+    }
+};
+
+template <typename C>
+class R2RType4Impl : public BasicR2RTransform<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    R2RKind kind_;
+    DCT4Core<T> core_;
+
+public:
+    R2RType4Impl(int n, R2RKind kind, const KernelTable<T>& kern) : kind_(kind), core_(n, kern) {}
+
+    int size() const override { return core_.size(); }
+    R2RKind kind() const override { return kind_; }
+
+    void execute(const T* x, T* y) const override { core_.run(x, y, T(2), kind_ == DST_IV); }
+};
+
+// Types II and III through a real FFT of N points (Makhoul): the DCT-II
+// is V = FFT(v) of v = x[0], x[2], .., x[3], x[1] (evens up, odds down),
+// with y[k] = 2 Re(e^{-i pi k / 2N} V[k]) and y[N-k] = -2 Im(..); the
+// DCT-III runs the steps backwards through the inverse real FFT
+template <typename C>
+class R2RType23Impl : public BasicR2RTransform<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    R2RKind kind_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+    AlignedBuffer<T> w_;  // e^{-i pi k / 2N}, k = 0..N/2
+
+    void dct2(const T* x, T* y, bool sine) const {
+        const int n = plan_->size(), h = n / 2;
+        T* v = thread_scratch<T, 1>(2 * size_t(n) + 2);
+        T* s = v + n;
+        // DST-II: the DCT-II of x with odd samples negated, output reversed
+        const T odd = sine ? T(-1) : T(1);
+        for (int j = 0; j < h; ++j) {
+            v[j] = x[2 * j];
+            v[n - 1 - j] = odd * x[2 * j + 1];
+        }
+        plan_->fwd(kern_, v, s, thread_scratch<T>(size_t(n)));
+        // The real FFT is normalized by 1/N
+        const T f = T(2 * n);
+        if (sine) {
+            y[n - 1] = f * s[0];
+            for (int k = 1; k <= h; ++k) {
+                const T sr = s[2 * k], si = s[2 * k + 1], wr = w_[2 * k], wi = w_[2 * k + 1];
+                y[n - 1 - k] = f * (sr * wr - si * wi);
+                y[k - 1] = -f * (sr * wi + si * wr);
+            }
+        } else {
+            y[0] = f * s[0];
+            for (int k = 1; k <= h; ++k) {
+                const T sr = s[2 * k], si = s[2 * k + 1], wr = w_[2 * k], wi = w_[2 * k + 1];
+                y[k] = f * (sr * wr - si * wi);
+                y[n - k] = -f * (sr * wi + si * wr);
+            }
+        }
+    }
+
+    // V[0] = X[0], V[k] = e^{i pi k / 2N} (X[k] - i X[N-k]); z = IFFT(V)
+    // unnormalized, y[2j] = z[j], y[2j+1] = z[N-1-j]
+    void dct3(const T* x, T* y, bool sine) const {
+        const int n = plan_->size(), h = n / 2;
+        T* s = thread_scratch<T, 1>(2 * size_t(n) + 2);
+        T* z = s + n + 2;
+        // DST-III: the DCT-III of x reversed, odd outputs negated
+        const int last = sine ? n - 1 : 0;
+        const int step = sine ? -1 : 1;
+        s[0] = x[last];
+        s[1] = 0;
+        for (int k = 1; k <= h; ++k) {
+            const T a = x[last + step * k], b = x[last + step * (n - k)];
+            const T wr = w_[2 * k], wi = -w_[2 * k + 1];
+            s[2 * k] = wr * a + wi * b;
+            s[2 * k + 1] = wi * a - wr * b;
+        }
+        plan_->inv(kern_, s, z, thread_scratch<T>(size_t(n)));
+        const T odd = sine ? T(-1) : T(1);
+        for (int j = 0; j < h; ++j) {
+            y[2 * j] = z[j];
+            y[2 * j + 1] = odd * z[n - 1 - j];
+        }
+    }
+
+public:
+    R2RType23Impl(int n, R2RKind kind, const KernelTable<T>& kern)
+        : kern_(kern), kind_(kind), plan_(PlanCache::instance().real_plan<T>(n, kern)), w_(2 * size_t(n / 2 + 1)) {
+        for (int k = 0; k <= n / 2; ++k) {
+            w_[2 * k] = T(cos(-M_PI * k / (2.0 * n)));
+            w_[2 * k + 1] = T(sin(-M_PI * k / (2.0 * n)));
+        }
+    }
+
+    int size() const override { return plan_->size(); }
+    R2RKind kind() const override { return kind_; }
+
+    void execute(const T* x, T* y) const override {
+        if (kind_ == DCT_II || kind_ == DST_II) dct2(x, y, kind_ == DST_II);
+        else dct3(x, y, kind_ == DST_III);
+    }
+};
+
+// Type I through a real FFT of M = N-1 (DCT) or N+1 (DST) points of the
+// folded sequence u[j] = (f[j] + f[M-j]) / 2 -+ sin(pi j / M) (f[j] - f[M-j])
+// (Numerical Recipes' cosft1/sinft). Its real parts give the even DCT
+// outputs and its imaginary parts the steps between the odd ones, and the
+// other way around for the DST.
+template <typename C>
+class R2RType1Impl : public BasicR2RTransform<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    R2RKind kind_;
+    int n_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+    AlignedBuffer<T> sin_;  // sin(pi j / M), j < M
+    AlignedBuffer<T> cos_;  // cos(pi j / M), j < M (DCT only)
+
+public:
+    R2RType1Impl(int n, R2RKind kind, const KernelTable<T>& kern)
+        : kern_(kern), kind_(kind), n_(n), plan_(PlanCache::instance().real_plan<T>(kind == DCT_I ? n - 1 : n + 1, kern)),
+          sin_(size_t(plan_->size())), cos_(size_t(plan_->size())) {
+        const int m = plan_->size();
+        for (int j = 0; j < m; ++j) {
+            sin_[j] = T(sin(M_PI * j / m));
+            cos_[j] = T(cos(M_PI * j / m));
+        }
+    }
+
+    int size() const override { return n_; }
+    R2RKind kind() const override { return kind_; }
+
+    void execute(const T* x, T* y) const override {
+        const int m = plan_->size(), h = m / 2;
+        T* u = thread_scratch<T, 1>(2 * size_t(m) + 2);
+        T* s = u + m;
+        // The real FFT is normalized by 1/M
+        const T f = T(2 * m);
+        if (kind_ == DCT_I) {
+            // f[j] = x[j], j = 0..M
+            T odd = T(0.5) * (x[0] - x[m]);
+            for (int j = 0; j < m; ++j) {
+                const T a = x[j], b = x[m - j];
+                u[j] = T(0.5) * (a + b) - sin_[j] * (a - b);
+                if (j > 0) odd += a * cos_[j];
+            }
+            plan_->fwd(kern_, u, s, thread_scratch<T>(size_t(m)));
+            y[0] = f * s[0];
+            y[1] = 2 * odd;
+            for (int k = 1; k < h; ++k) {
+                y[2 * k] = f * s[2 * k];
+                y[2 * k + 1] = y[2 * k - 1] - f * s[2 * k + 1];
+            }
+            y[m] = f * s[2 * h];
+        } else {
+            // f[j] = x[j-1], j = 1..M-1, and f[0] = f[M] = 0
+            u[0] = 0;
+            for (int j = 1; j < m; ++j) {
+                const T a = x[j - 1], b = x[m - j - 1];
+                u[j] = sin_[j] * (a + b) + T(0.5) * (a - b);
+            }
+            plan_->fwd(kern_, u, s, thread_scratch<T>(size_t(m)));
+            y[0] = T(0.5) * f * s[0];
+            for (int k = 1; k < h; ++k) {
+                y[2 * k - 1] = -f * s[2 * k + 1];
+                y[2 * k] = y[2 * k - 2] + f * s[2 * k];
+            }
+        }
+    }
+};
+
+template <typename C>
+class MDCTImpl : public BasicMDCT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    DCT4Core<T> core_;
+    AlignedBuffer<T> window_;  // 2N samples
+
+public:
+    MDCTImpl(int n, const T* window, const KernelTable<T>& kern) : core_(n, kern), window_(2 * size_t(n)) {
+        if (window) {
+            std::memcpy(window_.data(), window, 2 * size_t(n) * sizeof(T));
+        } else {
+            for (int j = 0; j < 2 * n; ++j) window_[j] = T(sin(M_PI * (j + 0.5) / (2.0 * n)));
+        }
+    }
+
+    int size() const override { return core_.size(); }
+
+    // With the windowed block split into quarters a, b, c, d, the MDCT is
+    // the DCT-IV (half FFTW's scale) of (-c reversed - d, a - b reversed)
+    void fwd(const T* x, T* X) const override {
+        const int n = core_.size(), h = n / 2;
+        const T* w = window_.data();
+        T* u = thread_scratch<T, 1>(size_t(n));
+        for (int j = 0; j < h; ++j) {
+            u[j] = -w[n + h - 1 - j] * x[n + h - 1 - j] - w[n + h + j] * x[n + h + j];
+            u[h + j] = w[j] * x[j] - w[n - 1 - j] * x[n - 1 - j];
+        }
+        core_.run(u, X, T(1), false);
+    }
+
+    // The DCT-IV of 2X / N in halves p, q unfolds to (q, -q reversed,
+    // -p reversed, -p), windowed
+    void inv(const T* X, T* y) const override {
+        const int n = core_.size(), h = n / 2;
+        const T* w = window_.data();
+        T* p = thread_scratch<T, 1>(size_t(n));
+        core_.run(X, p, T(2) / T(n), false);
+        const T* q = p + h;
+        for (int j = 0; j < h; ++j) {
+            y[j] = w[j] * q[j];
+            y[h + j] = -w[h + j] * q[h - 1 - j];
+            y[n + j] = -w[n + j] * p[h - 1 - j];
+            y[n + h + j] = -w[n + h + j] * p[j];
+        }
+    }
+};
+
+template <typename C>
+inline BasicR2RTransform<C>* create_r2r(int n, R2RKind kind)
+{
+    typedef typename complex_traits<C>::scalar T;
+    const KernelTable<T>& kern = active_kernels<T>();
+    switch (kind) {
+    case DCT_I:
+        if (n < 3 || !dct_size_ok(n - 1)) {
+            throw std::invalid_argument("OTFFT ext: DCT-I size must be odd with no prime factor above 7 in (N-1)/2");
+        }
+        return new R2RType1Impl<C>(n, kind, kern);
+    case DST_I:
+        if (n < 1 || !dct_size_ok(n + 1)) {
+            throw std::invalid_argument("OTFFT ext: DST-I size must be odd with no prime factor above 7 in (N+1)/2");
+        }
+        return new R2RType1Impl<C>(n, kind, kern);
+    case DCT_II: case DCT_III: case DST_II: case DST_III:
+        if (!dct_size_ok(n)) {
+            throw std::invalid_argument("OTFFT ext: DCT/DST size must be even with no prime factor above 7 in N/2");
+        }
+        return new R2RType23Impl<C>(n, kind, kern);
+    case DCT_IV: case DST_IV:
+        if (!dct_size_ok(n)) {
+            throw std::invalid_argument("OTFFT ext: DCT/DST size must be even with no prime factor above 7 in N/2");
+        }
+        return new R2RType4Impl<C>(n, kind, kern);
+    }
+    throw std::invalid_argument("OTFFT ext: unknown R2R kind");
+}
+
+template <typename C>
+inline BasicMDCT<C>* create_mdct(int n, const typename complex_traits<C>::scalar* window)
+{
+    typedef typename complex_traits<C>::scalar T;
+    if (!dct_size_ok(n)) {
+        throw std::invalid_argument("OTFFT ext: MDCT size must be even with no prime factor above 7 in N/2");
+    }
+    return new MDCTImpl<C>(n, window, active_kernels<T>());
+}
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline R2RTransformPtr createR2R(int n, R2RKind kind)
+{
+    return R2RTransformPtr(detail::create_r2r<complex_t>(n, kind));
+}
+
+inline R2RTransformfPtr createR2Rf(int n, R2RKind kind)
+{
+    return R2RTransformfPtr(detail::create_r2r<complexf_t>(n, kind));
+}
+
+// n coefficients per block of 2n samples; window: 2n samples, or nullptr
+// for the sine window sin(pi (j + 1/2) / 2n)
+inline MDCTPtr createMDCT(int n, const double* window = nullptr)
+{
+    return MDCTPtr(detail::create_mdct<complex_t>(n, window));
+}
+
+inline MDCTfPtr createMDCTf(int n, const float* window = nullptr)
+{
+    return MDCTfPtr(detail::create_mdct<complexf_t>(n, window));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DCT_H
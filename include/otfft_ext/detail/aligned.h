@@ -0,0 +1,88 @@
+#ifndef OTFFT_EXT_DETAIL_ALIGNED_H
+#define OTFFT_EXT_DETAIL_ALIGNED_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace OTFFT {
+namespace detail {
+
+// Alignment used for every buffer owned by the extension layer (one cache
+// line, which also covers the widest SIMD register we load from).
+static const size_t kAlign = 64;
+
+inline void* aligned_malloc(size_t bytes, size_t align = kAlign)
+{
+    if (bytes == 0) bytes = align;
+#ifdef _MSC_VER
+    void* p = _aligned_malloc(bytes, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align, bytes) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+inline void aligned_free(void* p)
+{
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// Move-only, uninitialized, cache-line aligned array of trivially copyable T.
+// A buffer constructed on caller storage (an Arena block) borrows it and
+// frees nothing.
+template <typename T>
+class AlignedBuffer {
+private:
+    T* data_;
+    size_t size_;
+    bool owned_;
+
+public:
+    AlignedBuffer() : data_(nullptr), size_(0), owned_(true) {}
+    explicit AlignedBuffer(size_t n)
+        : data_(n ? static_cast<T*>(aligned_malloc(n * sizeof(T))) : nullptr), size_(n), owned_(true) {}
+    AlignedBuffer(T* storage, size_t n) : data_(storage), size_(n), owned_(false) {}
+    ~AlignedBuffer() { if (data_ && owned_) aligned_free(data_); }
+
+    AlignedBuffer(AlignedBuffer&& other) : data_(other.data_), size_(other.size_), owned_(other.owned_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    AlignedBuffer& operator=(AlignedBuffer&& other) {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(owned_, other.owned_);
+        return *this;
+    }
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    void resize(size_t n) {
+        if (n == size_) return;
+        AlignedBuffer tmp(n);
+        *this = std::move(tmp);
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_ALIGNED_H
@@ -0,0 +1,72 @@
+#ifndef OTFFT_EXT_DETAIL_ARENA_H
+#define OTFFT_EXT_DETAIL_ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+#include "aligned.h"
+
+namespace OTFFT {
+namespace detail {
+
+// Bump allocator over a chain of cache-line aligned blocks. Allocations are
+// handed out back to back, each rounded up to kAlign, so the twiddles and
+// workspaces of plans built one after another end up contiguous. Nothing
+// is freed before the arena itself, which must outlive every plan and
+// buffer carved from it. Not thread-safe.
+class Arena {
+public:
+    explicit Arena(size_t block_bytes = size_t(1) << 20)
+        : block_bytes_(block_bytes), cur_(nullptr), end_(nullptr), used_(0), capacity_(0) {}
+    ~Arena() {
+        for (size_t i = 0; i < blocks_.size(); ++i) aligned_free(blocks_[i]);
+    }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // kAlign-aligned storage for bytes bytes; a request that does not fit in
+    // the current block opens a new one (of at least block_bytes)
+    void* allocate(size_t bytes) {
+        bytes = (bytes + kAlign - 1) / kAlign * kAlign;
+        if (bytes == 0) bytes = kAlign;
+        if (size_t(end_ - cur_) < bytes) {
+            const size_t size = bytes > block_bytes_ ? bytes : block_bytes_;
+            char* block = static_cast<char*>(aligned_malloc(size));
+            blocks_.push_back(block);
+            cur_ = block;
+            end_ = block + size;
+            capacity_ += size;
+        }
+        void* p = cur_;
+        cur_ += bytes;
+        used_ += bytes;
+        return p;
+    }
+
+    template <typename T>
+    T* allocate(size_t count) { return static_cast<T*>(allocate(count * sizeof(T))); }
+
+    size_t used() const { return used_; }          // bytes handed out
+    size_t capacity() const { return capacity_; }  // bytes reserved in blocks
+    size_t blocks() const { return blocks_.size(); }
+
+private:
+    size_t block_bytes_;
+    std::vector<void*> blocks_;
+    char* cur_;
+    char* end_;
+    size_t used_;
+    size_t capacity_;
+};
+
+// n values from the arena when one is given, else from the heap
+template <typename T>
+inline AlignedBuffer<T> make_buffer(size_t n, Arena* arena)
+{
+    return arena ? AlignedBuffer<T>(arena->allocate<T>(n), n) : AlignedBuffer<T>(n);
+}
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_ARENA_H
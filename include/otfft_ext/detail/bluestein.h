@@ -0,0 +1,137 @@
+#ifndef OTFFT_EXT_DETAIL_BLUESTEIN_H
+#define OTFFT_EXT_DETAIL_BLUESTEIN_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "aligned.h"
+#include "stockham.h"
+
+namespace OTFFT {
+namespace detail {
+
+// In-place unnormalized forward DFT of a power-of-two number of {Re, Im}
+// doubles. Plans use it to precompute spectra at construction, where no
+// kernel set is at hand; it is not meant for the transforms themselves.
+inline void reference_fft(std::vector<double>& x)
+{
+    const int n = int(x.size() / 2);
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(x[2 * i], x[2 * j]);
+            std::swap(x[2 * i + 1], x[2 * j + 1]);
+        }
+    }
+    for (int len = 2; len <= n; len *= 2) {
+        const double theta = -2.0 * M_PI / len;
+        for (int k = 0; k < len / 2; ++k) {
+            const double wr = cos(theta * k), wi = sin(theta * k);
+            for (int i = k; i < n; i += len) {
+                double* a = &x[2 * i];
+                double* b = &x[2 * (i + len / 2)];
+                const double tr = b[0] * wr - b[1] * wi, ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+// Immutable plan for a complex transform of any size N, as Bluestein's
+// chirp-z algorithm: with c_k = exp(-i pi k^2 / N),
+//   X_k = c_k * sum_t (x_t c_t) conj(c_(k-t)),
+// a circular convolution of length M >= 2N-1 (a power of two) run with
+// one forward and one inverse Stockham transform. The spectrum of the
+// conj(c) sequence is precomputed, scaled by 1/M. Meant for sizes that have
+// a prime factor above 7; StockhamPlan runs the others directly at about
+// a third of the cost. Like StockhamPlan it holds no scratch.
+template <typename T>
+class BluesteinPlan {
+public:
+    BluesteinPlan(int n, int lanes, int max_radix = 4)
+        : n_(n), m_(padded_size(n)), conv_(m_, lanes, max_radix),
+          chirp_(2 * size_t(n)), spec_(2 * size_t(m_)) {
+        std::vector<double> b(2 * size_t(m_), 0.0);
+        for (int k = 0; k < n; ++k) {
+            // k^2 mod 2N keeps the angle exact for large k
+            const double phi = -M_PI * double((long long)k * k % (2LL * n)) / n;
+            chirp_[2 * k] = T(cos(phi));
+            chirp_[2 * k + 1] = T(sin(phi));
+            b[2 * k] = cos(phi);
+            b[2 * k + 1] = -sin(phi);
+            if (k > 0) {
+                b[2 * (m_ - k)] = cos(phi);
+                b[2 * (m_ - k) + 1] = -sin(phi);
+            }
+        }
+        reference_fft(b);
+        for (size_t i = 0; i < b.size(); ++i) spec_[i] = T(b[i] / m_);
+    }
+
+    int size() const { return n_; }
+    int conv_size() const { return m_; }
+    size_t twiddle_bytes() const {
+        return conv_.twiddle_bytes() + (chirp_.size() + spec_.size()) * sizeof(T);
+    }
+
+    // x: N complex values -> y: their DFT (inverse DFT for Inv) times scale.
+    // x may equal y. work: 2*conv_size() complex values. kern must match
+    // the lanes the plan was built for.
+    template <bool Inv>
+    void run(const KernelTable<T>& kern, const T* x, T* y, T* work, T scale) const {
+        T* a = work;
+        T* w = work + 2 * size_t(m_);
+        // The inverse is conj(DFT(conj x))
+        const T sign = Inv ? T(-1) : T(1);
+        for (int k = 0; k < n_; ++k) {
+            const T xr = x[2 * k], xi = sign * x[2 * k + 1];
+            const T cr = chirp_[2 * k], ci = chirp_[2 * k + 1];
+            a[2 * k] = xr * cr - xi * ci;
+            a[2 * k + 1] = xr * ci + xi * cr;
+        }
+        for (size_t i = 2 * size_t(n_); i < 2 * size_t(m_); ++i) a[i] = T(0);
+        kern.fwd(conv_, a, a, w, T(1));
+        for (int k = 0; k < m_; ++k) {
+            const T ar = a[2 * k], ai = a[2 * k + 1];
+            const T br = spec_[2 * k], bi = spec_[2 * k + 1];
+            a[2 * k] = ar * br - ai * bi;
+            a[2 * k + 1] = ar * bi + ai * br;
+        }
+        kern.inv(conv_, a, a, w, T(1));
+        for (int k = 0; k < n_; ++k) {
+            const T ar = a[2 * k], ai = a[2 * k + 1];
+            const T cr = chirp_[2 * k], ci = chirp_[2 * k + 1];
+            y[2 * k] = (ar * cr - ai * ci) * scale;
+            y[2 * k + 1] = sign * (ar * ci + ai * cr) * scale;
+        }
+    }
+
+private:
+    int n_;
+    int m_;
+    StockhamPlan<T> conv_;
+    AlignedBuffer<T> chirp_;  // c_k, k = 0..N-1
+    AlignedBuffer<T> spec_;   // DFT_M of conj(c) placed circularly, / M
+
+    static int padded_size(int n) {
+        if (n <= 0 || n > (1 << 29)) {
+            throw std::invalid_argument("OTFFT ext: transform size out of range");
+        }
+        int m = 1;
+        while (m < 2 * n - 1) m *= 2;
+        return m;
+    }
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_BLUESTEIN_H
@@ -0,0 +1,60 @@
+#ifndef OTFFT_EXT_DETAIL_COLUMNS_H
+#define OTFFT_EXT_DETAIL_COLUMNS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "../plan_cache.h"
+#include "stockham.h"
+
+namespace OTFFT {
+namespace detail {
+
+// Columns per strip: at least a few cache lines per row segment, few
+// enough that the strip and its work buffer stay around L2-sized.
+inline int nd_strip(int len, size_t complex_bytes, int lanes, int inner)
+{
+    const size_t budget = 512 * 1024;
+    int b = std::max(lanes, int(256 / complex_bytes));
+    while (b < 64 && size_t(4 * b) * len * complex_bytes <= budget) b *= 2;
+    return std::min(b, inner);
+}
+
+// Transforms columns c_begin..c_end-1 of the len x inner row-major complex
+// matrix x, one strip of adjacent columns at a time through the batch
+// kernels. Disjoint column ranges may run on different threads.
+template <typename T, bool Inv>
+inline void nd_column_range(const KernelTable<T>& kern, const StockhamPlan<T>& plan, ptrdiff_t inner,
+                            ptrdiff_t c_begin, ptrdiff_t c_end, T* x, T scale)
+{
+    const int len = plan.size();
+    const int strip = nd_strip(len, 2 * sizeof(T), kern.lanes, int(std::min<ptrdiff_t>(inner, 1 << 20)));
+    T* buf = thread_scratch<T>(4 * size_t(len) * strip);
+    T* work = buf + 2 * size_t(len) * strip;
+    for (ptrdiff_t c0 = c_begin; c0 < c_end; c0 += strip) {
+        const int b = int(std::min<ptrdiff_t>(strip, c_end - c0));
+        const size_t seg = 2 * size_t(b) * sizeof(T);
+        for (int j = 0; j < len; ++j) {
+            std::memcpy(buf + 2 * ptrdiff_t(j) * b, x + 2 * (j * inner + c0), seg);
+        }
+        if (Inv) kern.inv_batch(plan, b, buf, work, scale);
+        else kern.fwd_batch(plan, b, buf, work, scale);
+        for (int j = 0; j < len; ++j) {
+            std::memcpy(x + 2 * (j * inner + c0), buf + 2 * ptrdiff_t(j) * b, seg);
+        }
+    }
+}
+
+// Transforms all columns of the len x inner row-major complex matrix x
+template <typename T, bool Inv>
+inline void nd_columns(const KernelTable<T>& kern, const StockhamPlan<T>& plan, ptrdiff_t inner,
+                       T* x, T scale)
+{
+    nd_column_range<T, Inv>(kern, plan, inner, 0, inner, x, scale);
+}
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_COLUMNS_H
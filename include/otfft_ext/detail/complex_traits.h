@@ -0,0 +1,39 @@
+#ifndef OTFFT_EXT_DETAIL_COMPLEX_TRAITS_H
+#define OTFFT_EXT_DETAIL_COMPLEX_TRAITS_H
+
+#include "otfft.h"
+#include "../fft_float.h"
+
+namespace OTFFT {
+namespace detail {
+
+// Maps the public complex types onto the scalar the kernels work on. Both
+// are laid out as {Re, Im}, so a C* is treated as 2*n interleaved scalars.
+template <typename C> struct complex_traits;
+
+template <>
+struct complex_traits<complex_t> {
+    typedef double scalar;
+};
+
+template <>
+struct complex_traits<complexf_t> {
+    typedef float scalar;
+};
+
+template <typename C>
+inline typename complex_traits<C>::scalar* scalars(C* p)
+{
+    return reinterpret_cast<typename complex_traits<C>::scalar*>(p);
+}
+
+template <typename C>
+inline const typename complex_traits<C>::scalar* scalars(const C* p)
+{
+    return reinterpret_cast<const typename complex_traits<C>::scalar*>(p);
+}
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_COMPLEX_TRAITS_H
@@ -0,0 +1,109 @@
+#ifndef OTFFT_EXT_DETAIL_REAL_H
+#define OTFFT_EXT_DETAIL_REAL_H
+
+#include <cmath>
+#include <stdexcept>
+
+#include "aligned.h"
+#include "stockham.h"
+
+namespace OTFFT {
+namespace detail {
+
+inline int real_half_size(int n)
+{
+    if (n < 2 || n % 2 != 0 || !is_smooth(n / 2)) {
+        throw std::invalid_argument("OTFFT ext: real transform size must be even with no prime factor above 7");
+    }
+    return n / 2;
+}
+
+// Immutable plan for a real transform of size N, computed as a complex
+// transform of size N/2 on the even/odd samples packed as
+// z[k] = x[2k] + i x[2k+1]. Like StockhamPlan it holds no scratch, and
+// given an arena it keeps its tables there.
+template <typename T>
+class RealPlan {
+public:
+    RealPlan(int n, int lanes, int max_radix = 4, Arena* arena = nullptr)
+        : n_(n), half_(real_half_size(n), lanes, max_radix, arena),
+          w_(make_buffer<T>(2 * size_t(n / 4 + 1), arena)) {
+        for (int k = 0; k <= n / 4; ++k) {
+            w_[2 * k] = T(cos(-2.0 * M_PI * k / n));
+            w_[2 * k + 1] = T(sin(-2.0 * M_PI * k / n));
+        }
+    }
+
+    int size() const { return n_; }
+    const StockhamPlan<T>& half() const { return half_; }
+    const T* twiddles() const { return w_.data(); }  // W_N^k, k = 0..N/4
+    size_t twiddle_bytes() const { return half_.twiddle_bytes() + w_.size() * sizeof(T); }
+
+    // x: N reals -> y: bins 0..N/2 (N/2+1 complex values), normalized by 1/N.
+    // packed: y holds N/2 complex values with the real Nyquist bin X[N/2]
+    // in the imaginary slot of the (real) DC bin.
+    // work: N/2 complex values. kern must match the lanes the plan was built for.
+    void fwd(const KernelTable<T>& kern, const T* x, T* y, T* work, bool packed = false) const {
+        const int h = n_ / 2;
+        kern.fwd(half_, x, y, work, T(1));
+
+        const T f = T(1) / n_;
+        const T z0r = y[0], z0i = y[1];
+        y[0] = (z0r + z0i) * f;
+        if (packed) {
+            y[1] = (z0r - z0i) * f;
+        } else {
+            y[1] = 0;
+            y[2 * h] = (z0r - z0i) * f;
+            y[2 * h + 1] = 0;
+        }
+        for (int k = 1; 2 * k <= h; ++k) {
+            const T ar = y[2 * k], ai = y[2 * k + 1];
+            const T br = y[2 * (h - k)], bi = -y[2 * (h - k) + 1];
+            // E = (Z[k] + conj Z[h-k]) / 2, O = (Z[k] - conj Z[h-k]) / 2i
+            const T er = T(0.5) * (ar + br), ei = T(0.5) * (ai + bi);
+            const T or_ = T(0.5) * (ai - bi), oi = T(-0.5) * (ar - br);
+            const T wr = w_[2 * k], wi = w_[2 * k + 1];
+            const T tr = wr * or_ - wi * oi, ti = wr * oi + wi * or_;
+            // X[k] = E + W^k O, X[h-k] = conj(E - W^k O)
+            y[2 * k] = (er + tr) * f;
+            y[2 * k + 1] = (ei + ti) * f;
+            y[2 * (h - k)] = (er - tr) * f;
+            y[2 * (h - k) + 1] = -(ei - ti) * f;
+        }
+    }
+
+    // y: bins 0..N/2 (only read), or N/2 packed values -> x: N reals,
+    // unnormalized. work: N/2 complex values.
+    void inv(const KernelTable<T>& kern, const T* y, T* x, T* work, bool packed = false) const {
+        const int h = n_ / 2;
+        const T nyquist = packed ? y[1] : y[2 * h];
+        x[0] = y[0] + nyquist;
+        x[1] = y[0] - nyquist;
+        for (int k = 1; 2 * k <= h; ++k) {
+            const T ar = y[2 * k], ai = y[2 * k + 1];
+            const T br = y[2 * (h - k)], bi = -y[2 * (h - k) + 1];
+            // P = X[k] + conj X[h-k], T = i conj(W^k) (X[k] - conj X[h-k])
+            const T pr = ar + br, pi = ai + bi;
+            const T dr = ar - br, di = ai - bi;
+            const T wr = w_[2 * k], wi = -w_[2 * k + 1];
+            const T cr = wr * dr - wi * di, ci = wr * di + wi * dr;
+            const T tr = -ci, ti = cr;
+            x[2 * k] = pr + tr;
+            x[2 * k + 1] = pi + ti;
+            x[2 * (h - k)] = pr - tr;
+            x[2 * (h - k) + 1] = -(pi - ti);
+        }
+        kern.inv(half_, x, x, work, T(1));
+    }
+
+private:
+    int n_;
+    StockhamPlan<T> half_;
+    AlignedBuffer<T> w_;
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_REAL_H
@@ -0,0 +1,53 @@
+#ifndef OTFFT_EXT_DETAIL_ROOTS_H
+#define OTFFT_EXT_DETAIL_ROOTS_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "aligned.h"
+
+namespace OTFFT {
+namespace detail {
+
+// The N-th roots of unity W^j = exp(-2 pi i j / N), j = 0..N-1, as
+// {Re, Im} pairs. Transforms that need W^(jk mod N) for arbitrary j and k,
+// rather than the per-stage layout of a StockhamPlan, share one table per
+// size and precision through the PlanCache. The lanes and max_radix
+// arguments only match the other plans' constructors; the table does not
+// depend on them.
+template <typename T>
+class RootTable {
+public:
+    explicit RootTable(int n, int lanes = 0, int max_radix = 0) : n_(n), w_(check_size(n)) {
+        (void)lanes;
+        (void)max_radix;
+        for (int j = 0; j < n; ++j) {
+            const double theta = -2.0 * M_PI * j / n;
+            w_[2 * j] = T(cos(theta));
+            w_[2 * j + 1] = T(sin(theta));
+        }
+    }
+
+    int size() const { return n_; }
+    size_t twiddle_bytes() const { return w_.size() * sizeof(T); }
+    const T* data() const { return w_.data(); }
+    // W^(jk mod N) for jk >= 0
+    const T* at(long long jk) const { return w_.data() + 2 * (jk % n_); }
+
+private:
+    int n_;
+    AlignedBuffer<T> w_;
+
+    static size_t check_size(int n) {
+        if (n <= 0 || n > (1 << 29)) {
+            throw std::invalid_argument("OTFFT ext: transform size out of range");
+        }
+        return 2 * size_t(n);
+    }
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_ROOTS_H
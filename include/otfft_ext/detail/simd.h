@@ -0,0 +1,80 @@
+#ifndef OTFFT_EXT_DETAIL_SIMD_H
+#define OTFFT_EXT_DETAIL_SIMD_H
+
+// Complex-vector abstraction used by the Stockham kernels.
+//
+// Every vector type holds L interleaved complex values {Re, Im, Re, Im, ...}
+// of scalar type T and provides:
+//   load/store      unaligned load/store of L complex values
+//   add/sub/mul     lane-wise arithmetic (mul is the real, per-scalar product)
+//   cmul(a, w)      complex product a * w
+//   cmulc(a, w)     complex product a * conj(w)
+//   mulj(a)         i * a
+//   bcast(p)        the complex value at p in every lane
+//   set1(v)         the same real value in every scalar slot
+//
+// ScalarVec (L = 1) is the portable fallback and the tail path of every
+// kernel set; the SIMD types live in simd_x86.inc, compiled once per
+// instruction set by cpu_dispatch.h, and simd_neon.inc.
+
+// x86 compilers that can build code for an ISA above the command-line
+// target (GCC/Clang target regions, MSVC intrinsics) get runtime dispatch
+#if ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))) || \
+    defined(_M_X64)
+#define OTFFT_EXT_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// AArch64 always has NEON, with double-precision vectors
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__) && defined(__ARM_NEON)
+#define OTFFT_EXT_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace OTFFT {
+namespace detail {
+
+template <typename T>
+struct ScalarVec {
+    typedef T value_type;
+    struct reg { T re, im; };
+    static const int L = 1;
+
+    static reg load(const T* p) { reg r = { p[0], p[1] }; return r; }
+    static void store(T* p, reg a) { p[0] = a.re; p[1] = a.im; }
+    static reg add(reg a, reg b) { reg r = { a.re + b.re, a.im + b.im }; return r; }
+    static reg sub(reg a, reg b) { reg r = { a.re - b.re, a.im - b.im }; return r; }
+    static reg mul(reg a, reg b) { reg r = { a.re * b.re, a.im * b.im }; return r; }
+    static reg cmul(reg a, reg w) {
+        reg r = { a.re * w.re - a.im * w.im, a.re * w.im + a.im * w.re };
+        return r;
+    }
+    static reg cmulc(reg a, reg w) {
+        reg r = { a.re * w.re + a.im * w.im, a.im * w.re - a.re * w.im };
+        return r;
+    }
+    static reg mulj(reg a) { reg r = { -a.im, a.re }; return r; }
+    static reg bcast(const T* p) { return load(p); }
+    static reg set1(T v) { reg r = { v, v }; return r; }
+};
+
+// One real lane with the load/store/add/sub/mul/set1 of the vector types:
+// the tail path of the split-complex kernels (SplitVec in kernels.inc),
+// which use the vector types as plain arrays of 2*L real lanes.
+template <typename T>
+struct SplitScalar {
+    typedef T value_type;
+    typedef T reg;
+
+    static reg load(const T* p) { return *p; }
+    static void store(T* p, reg a) { *p = a; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+    static reg set1(T v) { return v; }
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_SIMD_H
@@ -0,0 +1,85 @@
+#ifndef OTFFT_EXT_DETAIL_SPLIT_PLAN_H
+#define OTFFT_EXT_DETAIL_SPLIT_PLAN_H
+
+#include <stdexcept>
+#include <vector>
+
+#include "aligned.h"
+#include "stockham.h"
+
+namespace OTFFT {
+namespace detail {
+
+inline int split_plan_size(int n)
+{
+    if (!is_power_of_two(n)) {
+        throw std::invalid_argument("OTFFT ext: split transform size must be a power of two");
+    }
+    return n;
+}
+
+// Immutable plan for split-complex transforms: the StockhamPlan stages,
+// plus expanded twiddles for the early stages whose stride s is below the
+// split vector width of 2*lanes complex values. Those stages run over the
+// flattened index i = p*s + q. Their twiddles are stored per i, as a row of
+// real parts and a row of imaginary parts for each w_k, so the kernels
+// load them with plain vector loads. Like StockhamPlan it holds no scratch.
+// Unlike StockhamPlan it only takes powers of two.
+template <typename T>
+class SplitPlan {
+public:
+    SplitPlan(int n, int lanes, int max_radix = 4) : plan_(split_plan_size(n), lanes, max_radix) {
+        const std::vector<StockhamStage>& stages = plan_.stages();
+        const int width = 2 * lanes;
+        std::vector<ptrdiff_t> offsets;
+        ptrdiff_t total = 0;
+        for (size_t k = 0; k + 1 < stages.size(); ++k) {
+            const StockhamStage& st = stages[k];
+            const ptrdiff_t sm = ptrdiff_t(st.s) * st.m;
+            const int r = st.kind == StockhamStage::R8_Q ? 8 : 4;
+            if (st.s % width != 0 && sm % width == 0) {
+                offsets.push_back(total);
+                total += 2 * (r - 1) * sm;
+            } else {
+                offsets.push_back(-1);
+            }
+        }
+        tw_.resize(size_t(total));
+        for (size_t k = 0; k < offsets.size(); ++k) {
+            if (offsets[k] < 0) continue;
+            const StockhamStage& st = stages[k];
+            const ptrdiff_t sm = ptrdiff_t(st.s) * st.m;
+            const int r = st.kind == StockhamStage::R8_Q ? 8 : 4;
+            const T* packed = plan_.twiddles() + st.tw;
+            T* row = tw_.data() + offsets[k];
+            for (int j = 0; j < r - 1; ++j, row += 2 * sm) {
+                for (ptrdiff_t i = 0; i < sm; ++i) {
+                    const T* w = packed + 2 * ((r - 1) * (i >> st.log2s) + j);
+                    row[i] = w[0];
+                    row[sm + i] = w[1];
+                }
+            }
+        }
+        offsets_.swap(offsets);
+    }
+
+    int size() const { return plan_.size(); }
+    const StockhamPlan<T>& plan() const { return plan_; }
+    size_t twiddle_bytes() const { return plan_.twiddle_bytes() + tw_.size() * sizeof(T); }
+
+    // Rows {Re w1, Im w1, Re w2, ...} of s*m values each for stage k, or
+    // nullptr if that stage runs vectorized over q
+    const T* expanded(size_t k) const {
+        return k < offsets_.size() && offsets_[k] >= 0 ? tw_.data() + offsets_[k] : nullptr;
+    }
+
+private:
+    StockhamPlan<T> plan_;
+    std::vector<ptrdiff_t> offsets_;  // per stage, -1 if not expanded
+    AlignedBuffer<T> tw_;
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_SPLIT_PLAN_H
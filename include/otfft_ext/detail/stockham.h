@@ -0,0 +1,213 @@
+#ifndef OTFFT_EXT_DETAIL_STOCKHAM_H
+#define OTFFT_EXT_DETAIL_STOCKHAM_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "aligned.h"
+#include "arena.h"
+
+namespace OTFFT {
+namespace detail {
+
+inline bool is_power_of_two(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+inline int ilog2(int n)
+{
+    int k = 0;
+    while ((1 << k) < n) ++k;
+    return k;
+}
+
+// True if n > 0 has no prime factor above 7, so a StockhamPlan can run it
+inline bool is_smooth(int n)
+{
+    if (n <= 0) return false;
+    static const int primes[] = {2, 3, 5, 7};
+    for (int p : primes) {
+        while (n % p == 0) n /= p;
+    }
+    return n == 1;
+}
+
+// One pass of a StockhamPlan. Every stage but the last is a twiddled
+// radix-r pass over n = r*m*s values; the last one is a twiddle-free pass
+// that reads and writes the same indices. Power-of-two sizes use radix-4
+// and radix-8 passes and a radix-8, 4 or 2 last pass. Other 7-smooth sizes
+// add twiddled radix-2 passes and radix-3, 5 and 7 passes and end in an
+// odd-radix last pass.
+struct StockhamStage {
+    enum Kind {
+        R4_Q, R4_I, R8_Q, R4_LAST, R8_LAST, R2_LAST,
+        R2_Q, R3_Q, R5_Q, R7_Q, R3_LAST, R5_LAST, R7_LAST
+    };
+
+    Kind kind;
+    int m;
+    int s;
+    int log2s;
+    size_t tw;   // offset of the packed {w1, .., w(r-1)} per-p table
+    size_t twx;  // offset of the per-i expanded table (R4_I stages only)
+};
+
+template <typename T> class StockhamPlan;
+template <typename T> class SplitPlan;
+
+// Entry points of one compiled kernel set (see cpu_dispatch.h). A plan must
+// be built for the table's lanes and max_radix, since the stage list and
+// the early-stage twiddle layout depend on them.
+template <typename T>
+struct KernelTable {
+    typedef void (*exec_fn)(const StockhamPlan<T>& plan, const T* in, T* out, T* work, T scale);
+    typedef void (*batch_fn)(const StockhamPlan<T>& plan, int b, T* x, T* work, T scale);
+    typedef void (*mac_fn)(int n, const T* a, const T* b, T* acc);
+    typedef void (*split_fn)(const SplitPlan<T>& plan, const T* in_re, const T* in_im,
+                             T* out_re, T* out_im, T* work, T scale);
+    typedef void (*goertzel_fn)(int n, const T* x, int groups, const T* coef, T* state);
+    typedef void (*sliding_fn)(int n, int count, const T* d, T r, const T* step, T* row, T* acc);
+
+    int level;      // IsaLevel the kernels were compiled for
+    int lanes;      // complex values per vector register
+    int max_radix;  // largest butterfly the plans for this table use
+    // in may equal out (in place); work holds size() complex values
+    exec_fn fwd;
+    exec_fn inv;
+    // b transforms interleaved element-major in x (n*b complex values),
+    // work of the same size
+    batch_fn fwd_batch;
+    batch_fn inv_batch;
+    // acc[i] += a[i] * b[i] over n complex values
+    mac_fn cmac;
+    // Split-complex (separate real and imaginary arrays) fwd/inv; in and
+    // out may alias, work holds 2*size() scalars
+    split_fn fwd_split;
+    split_fn inv_split;
+    // Goertzel recurrences over n complex samples x, for groups of
+    // 2*lanes bins with coef[b] = 2 cos(w_b). state receives per group the
+    // rows s1.re, s1.im, s2.re, s2.im (last and second-to-last values) of
+    // 2*lanes scalars each
+    goertzel_fn goertzel;
+    // Sliding DFT updates of n bins (a multiple of lanes) over count real
+    // inputs d: per input, acc = r*acc + d[s]*row, then row *= step
+    sliding_fn sliding;
+};
+
+// Immutable Stockham plan for a 7-smooth size (see is_smooth): stage list
+// plus twiddle tables. A plan holds no scratch, so one instance can be
+// shared by any number of threads; each caller supplies a work buffer of
+// size() complex values. Given an arena, the twiddle tables are placed
+// there instead of the heap.
+template <typename T>
+class StockhamPlan {
+public:
+    StockhamPlan(int n, int lanes, int max_radix = 4, Arena* arena = nullptr)
+        : n_(n), lanes_(lanes), max_radix_(max_radix) {
+        if (!is_smooth(n)) {
+            throw std::invalid_argument("OTFFT ext: Stockham plan size must have no prime factor above 7");
+        }
+        build(arena);
+    }
+
+    int size() const { return n_; }
+    int lanes() const { return lanes_; }
+    int max_radix() const { return max_radix_; }
+    size_t twiddle_bytes() const { return tw_.size() * sizeof(T); }
+    const std::vector<StockhamStage>& stages() const { return stages_; }
+    const T* twiddles() const { return tw_.data(); }
+
+private:
+    int n_;
+    int lanes_;
+    int max_radix_;
+    std::vector<StockhamStage> stages_;
+    AlignedBuffer<T> tw_;
+
+    // Appends a twiddled radix-r pass over the remaining n values at stride s
+    void add_pass(int r, int n, int s, std::vector<double>& tw) {
+        StockhamStage st;
+        st.kind = r == 8 ? StockhamStage::R8_Q : r == 4 ? StockhamStage::R4_Q
+                : r == 2 ? StockhamStage::R2_Q : r == 3 ? StockhamStage::R3_Q
+                : r == 5 ? StockhamStage::R5_Q : StockhamStage::R7_Q;
+        st.m = n / r;
+        st.s = s;
+        st.log2s = ilog2(s);
+        st.tw = tw.size();
+        st.twx = 0;
+        const double theta = -2.0 * M_PI / n;
+        for (int p = 0; p < st.m; ++p) {
+            for (int k = 1; k < r; ++k) {
+                tw.push_back(cos(theta * k * p));
+                tw.push_back(sin(theta * k * p));
+            }
+        }
+        if (r == 4 && s < lanes_ && (ptrdiff_t(s) * st.m) % lanes_ == 0) {
+            st.kind = StockhamStage::R4_I;
+            st.twx = tw.size();
+            const int sm = s * st.m;
+            for (int k = 1; k <= 3; ++k) {
+                for (int i = 0; i < sm; ++i) {
+                    const int p = i >> st.log2s;
+                    tw.push_back(cos(theta * k * p));
+                    tw.push_back(sin(theta * k * p));
+                }
+            }
+        }
+        stages_.push_back(st);
+    }
+
+    // Radix-8 passes (when allowed) run once the stride covers a whole
+    // vector; the early passes stay radix-4 so they can use R4_I. Other
+    // sizes take their factors of two first, the same way, so that the
+    // odd-radix passes after them run at strides of whole vectors.
+    void build(Arena* arena) {
+        std::vector<double> tw;
+        int n = n_, s = 1;
+        int twos = n_ & -n_;
+        if (twos == n_) {
+            const int last = max_radix_ == 8 ? 8 : 4;
+            while (n > last) {
+                const int r = max_radix_ == 8 && s >= lanes_ ? 8 : 4;
+                add_pass(r, n, s, tw);
+                n /= r;
+                s *= r;
+            }
+        } else {
+            while (twos > 1) {
+                const int r = max_radix_ == 8 && s >= lanes_ && twos % 8 == 0 ? 8 : twos % 4 == 0 ? 4 : 2;
+                add_pass(r, n, s, tw);
+                n /= r;
+                s *= r;
+                twos /= r;
+            }
+            static const int odd[] = {3, 5, 7};
+            for (int r : odd) {
+                while (n > r && n % r == 0) {
+                    add_pass(r, n, s, tw);
+                    n /= r;
+                    s *= r;
+                }
+            }
+        }
+        if (n > 1) {
+            StockhamStage st;
+            st.kind = n == 8 ? StockhamStage::R8_LAST : n == 4 ? StockhamStage::R4_LAST
+                    : n == 2 ? StockhamStage::R2_LAST : n == 3 ? StockhamStage::R3_LAST
+                    : n == 5 ? StockhamStage::R5_LAST : StockhamStage::R7_LAST;
+            st.m = 1;
+            st.s = s;
+            st.log2s = ilog2(s);
+            st.tw = 0;
+            st.twx = 0;
+            stages_.push_back(st);
+        }
+        tw_ = make_buffer<T>(tw.size(), arena);
+        for (size_t i = 0; i < tw.size(); ++i) tw_[i] = T(tw[i]);
+    }
+};
+
+} // namespace detail
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_DETAIL_STOCKHAM_H
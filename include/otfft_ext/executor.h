@@ -0,0 +1,215 @@
+#ifndef OTFFT_EXT_EXECUTOR_H
+#define OTFFT_EXT_EXECUTOR_H
+
+// Task executors for the parallel transforms (see parallel.h).
+//
+// The extension layer never starts threads of its own accord. Parallel
+// work goes through an Executor, which is either the process-wide
+// WorkStealingPool from default_executor() or an adapter onto a thread
+// pool the application already runs. That way a service does not end up
+// with a second, competing set of threads the way it does with OpenMP.
+//
+//   class MyPoolExecutor : public OTFFT::Executor {
+//       int concurrency() const override { return pool.size(); }
+//       void parallel_for(int count, const std::function<void(int)>& task) override {
+//           pool.run_and_wait(count, task);   // however the pool spells it
+//       }
+//   };
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace OTFFT {
+
+class Executor {
+public:
+    virtual ~Executor() {}
+    // Threads the tasks of one parallel_for can run on at once
+    virtual int concurrency() const = 0;
+    // Runs task(0) .. task(count-1) in any order, on any threads, and
+    // returns once all have finished. The first exception a task throws
+    // is rethrown here. Must be callable from several threads at once.
+    virtual void parallel_for(int count, const std::function<void(int)>& task) = 0;
+};
+
+// Fixed-size work-stealing pool. threads-1 workers are started, and the
+// thread calling parallel_for works as the last one. Each parallel_for
+// hands an equal index range to every thread. A thread takes work from the
+// back of its own deque, halving the range it takes and leaving the upper
+// half for others. An idle thread steals the oldest (largest) range from
+// the front of another deque, so uneven tasks balance out without a
+// shared queue.
+class WorkStealingPool : public Executor {
+public:
+    // 0 threads: std::thread::hardware_concurrency()
+    explicit WorkStealingPool(int threads = 0) : queued_(0), stop_(false) {
+        if (threads <= 0) threads = int(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 1;
+        for (int i = 0; i < threads; ++i) queues_.push_back(std::unique_ptr<Queue>(new Queue));
+        for (int i = 1; i < threads; ++i) workers_.push_back(std::thread(&WorkStealingPool::worker, this, i));
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < workers_.size(); ++i) workers_[i].join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int concurrency() const override { return int(queues_.size()); }
+
+    void parallel_for(int count, const std::function<void(int)>& task) override {
+        if (count <= 0) return;
+        Job job(task, count);
+        const int threads = concurrency();
+        const int home = current_queue();
+        // One contiguous range per queue
+        int begin = 0;
+        for (int t = 0; t < threads && begin < count; ++t) {
+            const int end = begin + (count - begin) / (threads - t);
+            if (end > begin) push((home + t) % threads, Range(&job, begin, end));
+            begin = end;
+        }
+        wake(true);
+        while (job.remaining.load(std::memory_order_acquire) > 0) {
+            Range r;
+            if (take(home, r)) run(home, r);
+            else std::this_thread::yield();
+        }
+        if (job.error) std::rethrow_exception(job.error);
+    }
+
+private:
+    struct Job {
+        const std::function<void(int)>& task;
+        std::atomic<int> remaining;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        Job(const std::function<void(int)>& t, int count) : task(t), remaining(count) {}
+    };
+
+    struct Range {
+        Job* job;
+        int begin;
+        int end;
+        Range() : job(nullptr), begin(0), end(0) {}
+        Range(Job* j, int b, int e) : job(j), begin(b), end(e) {}
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<int> queued_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stop_;
+
+    // Workers own queues 1..threads-1. Threads from outside the pool share
+    // queue 0.
+    int current_queue() const {
+        const std::pair<const WorkStealingPool*, int>& self = tls();
+        return self.first == this ? self.second : 0;
+    }
+
+    static std::pair<const WorkStealingPool*, int>& tls() {
+        static thread_local std::pair<const WorkStealingPool*, int> self(nullptr, 0);
+        return self;
+    }
+
+    void push(int q, const Range& r) {
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        queues_[q]->ranges.push_back(r);
+        queued_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Taking the sleep mutex first means a worker is either still before
+    // its queued_ check or already waiting, so no wake-up is lost
+    void wake(bool all) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        if (all) wake_.notify_all();
+        else wake_.notify_one();
+    }
+
+    // Own queue from the back, then the other queues from the front
+    bool take(int home, Range& r) {
+        const int threads = concurrency();
+        for (int t = 0; t < threads; ++t) {
+            const int q = (home + t) % threads;
+            std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+            std::deque<Range>& d = queues_[q]->ranges;
+            if (d.empty()) continue;
+            if (t == 0) {
+                r = d.back();
+                d.pop_back();
+            } else {
+                r = d.front();
+                d.pop_front();
+            }
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // Splits off the upper half of r until a single index is left, so
+    // that idle threads can steal the rest
+    void run(int home, Range r) {
+        while (r.end - r.begin > 1) {
+            const int mid = r.begin + (r.end - r.begin) / 2;
+            push(home, Range(r.job, mid, r.end));
+            wake(false);
+            r.end = mid;
+        }
+        Job& job = *r.job;
+        try {
+            job.task(r.begin);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.error_mutex);
+            if (!job.error) job.error = std::current_exception();
+        }
+        job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void worker(int index) {
+        tls() = std::make_pair(static_cast<const WorkStealingPool*>(this), index);
+        for (;;) {
+            Range r;
+            if (take(index, r)) {
+                run(index, r);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stop_) return;
+        }
+    }
+};
+
+// Process-wide pool with one thread per hardware thread, started on first
+// use
+inline Executor& default_executor()
+{
+    static WorkStealingPool pool;
+    return pool;
+}
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_EXECUTOR_H
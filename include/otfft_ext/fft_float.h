@@ -0,0 +1,111 @@
+#ifndef OTFFT_EXT_FFT_FLOAT_H
+#define OTFFT_EXT_FFT_FLOAT_H
+
+// Single-precision ComplexFFT/RealFFT for OTFFT.
+//
+// Mirrors the double-precision objects returned by OTFFT::Factory:
+//   fwd() is normalized by 1/N, inv() is unnormalized, both work in place on
+//   interleaved {Re, Im} data. Sizes must have no prime factor above 7, and
+//   real sizes must be even with N/2 such a size (see mixed_radix.h for
+//   complex transforms of any size).
+//
+//   auto fft = OTFFT::FactoryExt::createComplexFFTf(N);
+//   fft->fwd(data);   // OTFFT::complexf_t* data, N values
+
+#include <memory>
+
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+
+namespace OTFFT {
+
+struct complexf_t {
+    float Re, Im;
+    complexf_t() : Re(0.0f), Im(0.0f) {}
+    complexf_t(float re, float im = 0.0f) : Re(re), Im(im) {}
+};
+
+class ComplexFFTf {
+public:
+    virtual ~ComplexFFTf() {}
+    virtual int size() const = 0;
+    virtual void fwd(complexf_t* x) const = 0;
+    virtual void inv(complexf_t* x) const = 0;
+};
+
+class RealFFTf {
+public:
+    virtual ~RealFFTf() {}
+    virtual int size() const = 0;
+    // x: N reals -> y: N complex bins (the upper half is the conjugate mirror)
+    virtual void fwd(const float* x, complexf_t* y) const = 0;
+    // y: bins 0..N/2 are read (and left untouched) -> x: N reals
+    virtual void inv(const complexf_t* y, float* x) const = 0;
+};
+
+typedef std::unique_ptr<ComplexFFTf> ComplexFFTfPtr;
+typedef std::unique_ptr<RealFFTf> RealFFTfPtr;
+
+namespace detail {
+
+// Plans come from the process-wide PlanCache and scratch is per thread, so
+// creating an object is cheap for sizes seen before and every method may
+// be called concurrently. The kernel set is fixed at construction.
+class ComplexFFTfImpl : public ComplexFFTf {
+    const KernelTable<float>& kern_;
+    std::shared_ptr<const StockhamPlan<float>> plan_;
+
+public:
+    ComplexFFTfImpl(int n, const KernelTable<float>& kern)
+        : kern_(kern), plan_(PlanCache::instance().complex_plan<float>(n, kern)) {}
+    int size() const override { return plan_->size(); }
+    void fwd(complexf_t* x) const override {
+        float* p = reinterpret_cast<float*>(x);
+        kern_.fwd(*plan_, p, p, thread_scratch<float>(2 * size_t(size())), 1.0f / size());
+    }
+    void inv(complexf_t* x) const override {
+        float* p = reinterpret_cast<float*>(x);
+        kern_.inv(*plan_, p, p, thread_scratch<float>(2 * size_t(size())), 1.0f);
+    }
+};
+
+class RealFFTfImpl : public RealFFTf {
+    const KernelTable<float>& kern_;
+    std::shared_ptr<const RealPlan<float>> plan_;
+
+public:
+    RealFFTfImpl(int n, const KernelTable<float>& kern)
+        : kern_(kern), plan_(PlanCache::instance().real_plan<float>(n, kern)) {}
+
+    int size() const override { return plan_->size(); }
+
+    void fwd(const float* x, complexf_t* y) const override {
+        const int n = size();
+        plan_->fwd(kern_, x, reinterpret_cast<float*>(y), thread_scratch<float>(size_t(n)));
+        for (int k = n / 2 + 1; k < n; ++k) y[k] = complexf_t(y[n - k].Re, -y[n - k].Im);
+    }
+
+    void inv(const complexf_t* y, float* x) const override {
+        plan_->inv(kern_, reinterpret_cast<const float*>(y), x, thread_scratch<float>(size_t(size())));
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline ComplexFFTfPtr createComplexFFTf(int n)
+{
+    return ComplexFFTfPtr(new detail::ComplexFFTfImpl(n, detail::active_kernels<float>()));
+}
+
+inline RealFFTfPtr createRealFFTf(int n)
+{
+    return RealFFTfPtr(new detail::RealFFTfImpl(n, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_FFT_FLOAT_H
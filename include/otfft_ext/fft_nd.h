@@ -0,0 +1,264 @@
+#ifndef OTFFT_EXT_FFT_ND_H
+#define OTFFT_EXT_FFT_ND_H
+
+// 2D and 3D complex and real-to-complex transforms on row-major arrays.
+//
+// Each axis reuses one cached 1D plan. The last (contiguous) axis runs
+// row by row. Every other axis is an L x inner matrix whose columns are
+// the transforms; they are processed in strips of adjacent columns. Each
+// strip is copied row segment by row segment into a buffer that is
+// already the element-major layout of the batch kernels, transformed
+// there with each twiddle loaded once for the strip, and copied back. The
+// strip is sized to stay cache resident, so no pass walks the whole array
+// column-wise and no full transpose is needed.
+//
+// fwd() is normalized by 1/(n0*n1[*n2]) and inv() is unnormalized, as for
+// the 1D objects. Real spectra hold n0 x [n1 x] (n_last/2+1) bins;
+// RealFFTND::inv() uses the spectrum as scratch and overwrites it.
+//
+//   auto fft = OTFFT::FactoryExt::createComplexFFT2D(rows, cols);
+//   fft->fwd(image);   // rows*cols OTFFT::complex_t, row-major
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/columns.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicComplexFFTND {
+public:
+    virtual ~BasicComplexFFTND() {}
+    virtual int rank() const = 0;
+    virtual int dim(int axis) const = 0;
+
+    // In place on dim(0) x .. x dim(rank-1) values, last axis contiguous
+    virtual void fwd(C* x) const = 0;
+    virtual void inv(C* x) const = 0;
+};
+
+template <typename C>
+class BasicRealFFTND {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicRealFFTND() {}
+    virtual int rank() const = 0;
+    virtual int dim(int axis) const = 0;
+
+    // x: dim(0) x .. x dim(rank-1) reals -> y: the same shape with the
+    // last axis cut to dim(rank-1)/2+1 bins
+    virtual void fwd(const real_type* x, C* y) const = 0;
+    // y (overwritten) -> x
+    virtual void inv(C* y, real_type* x) const = 0;
+};
+
+typedef BasicComplexFFTND<complex_t> ComplexFFTND;
+typedef BasicComplexFFTND<complexf_t> ComplexFFTNDf;
+typedef BasicRealFFTND<complex_t> RealFFTND;
+typedef BasicRealFFTND<complexf_t> RealFFTNDf;
+
+typedef std::unique_ptr<ComplexFFTND> ComplexFFTNDPtr;
+typedef std::unique_ptr<ComplexFFTNDf> ComplexFFTNDfPtr;
+typedef std::unique_ptr<RealFFTND> RealFFTNDPtr;
+typedef std::unique_ptr<RealFFTNDf> RealFFTNDfPtr;
+
+namespace detail {
+
+// Validated shape of a 2D or 3D transform
+inline std::vector<int> nd_dims(int n0, int n1, int n2)
+{
+    std::vector<int> dims;
+    dims.push_back(n0);
+    dims.push_back(n1);
+    if (n2 > 0) dims.push_back(n2);
+    for (size_t a = 0; a < dims.size(); ++a) {
+        if (!is_power_of_two(dims[a])) {
+            throw std::invalid_argument("OTFFT ext: multi-dimensional sizes must be powers of two");
+        }
+    }
+    return dims;
+}
+
+template <typename C>
+class ComplexFFTNDImpl : public BasicComplexFFTND<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::vector<int> dims_;
+    std::vector<std::shared_ptr<const StockhamPlan<T>>> plans_;
+    ptrdiff_t total_;
+
+    template <bool Inv>
+    void run(C* x) const {
+        T* p = scalars(x);
+        const int r = rank();
+        // Last axis: contiguous rows
+        const StockhamPlan<T>& last = *plans_[r - 1];
+        const int n = last.size();
+        const T row_scale = Inv ? T(1) : T(1) / n;
+        T* work = thread_scratch<T>(2 * size_t(n));
+        for (ptrdiff_t o = 0; o < total_ / n; ++o) {
+            T* row = p + 2 * o * n;
+            if (Inv) kern_.inv(last, row, row, work, row_scale);
+            else kern_.fwd(last, row, row, work, row_scale);
+        }
+        // Other axes: columns of each outer x (len x inner) block
+        ptrdiff_t inner = n;
+        for (int a = r - 2; a >= 0; --a) {
+            const StockhamPlan<T>& plan = *plans_[a];
+            const int len = plan.size();
+            const T scale = Inv ? T(1) : T(1) / len;
+            const ptrdiff_t block = len * inner;
+            for (ptrdiff_t o = 0; o < total_ / block; ++o) {
+                nd_columns<T, Inv>(kern_, plan, inner, p + 2 * o * block, scale);
+            }
+            inner = block;
+        }
+    }
+
+public:
+    ComplexFFTNDImpl(const std::vector<int>& dims, const KernelTable<T>& kern)
+        : kern_(kern), dims_(dims), total_(1) {
+        for (size_t a = 0; a < dims_.size(); ++a) {
+            plans_.push_back(PlanCache::instance().complex_plan<T>(dims_[a], kern));
+            total_ *= dims_[a];
+        }
+    }
+
+    int rank() const override { return int(dims_.size()); }
+    int dim(int axis) const override { return dims_[axis]; }
+    void fwd(C* x) const override { run<false>(x); }
+    void inv(C* x) const override { run<true>(x); }
+};
+
+template <typename C>
+class RealFFTNDImpl : public BasicRealFFTND<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::vector<int> dims_;
+    std::shared_ptr<const RealPlan<T>> rows_;
+    std::vector<std::shared_ptr<const StockhamPlan<T>>> plans_;  // all axes but the last
+    ptrdiff_t rows_count_;  // product of all dims but the last
+
+    // Columns of every axis but the last, over the rows_count_ x bins spectrum
+    template <bool Inv>
+    void columns(T* p) const {
+        const int bins = rows_->size() / 2 + 1;
+        ptrdiff_t inner = bins;
+        for (int a = int(plans_.size()) - 1; a >= 0; --a) {
+            const StockhamPlan<T>& plan = *plans_[a];
+            const int len = plan.size();
+            const T scale = Inv ? T(1) : T(1) / len;
+            const ptrdiff_t block = len * inner;
+            for (ptrdiff_t o = 0; o < rows_count_ * bins / block; ++o) {
+                nd_columns<T, Inv>(kern_, plan, inner, p + 2 * o * block, scale);
+            }
+            inner = block;
+        }
+    }
+
+public:
+    RealFFTNDImpl(const std::vector<int>& dims, const KernelTable<T>& kern)
+        : kern_(kern), dims_(dims), rows_(PlanCache::instance().real_plan<T>(dims.back(), kern)),
+          rows_count_(1) {
+        for (size_t a = 0; a + 1 < dims_.size(); ++a) {
+            plans_.push_back(PlanCache::instance().complex_plan<T>(dims_[a], kern));
+            rows_count_ *= dims_[a];
+        }
+    }
+
+    int rank() const override { return int(dims_.size()); }
+    int dim(int axis) const override { return dims_[axis]; }
+
+    void fwd(const T* x, C* y) const override {
+        const int n = rows_->size(), bins = n / 2 + 1;
+        T* p = scalars(y);
+        T* work = thread_scratch<T>(size_t(n));
+        for (ptrdiff_t o = 0; o < rows_count_; ++o) {
+            rows_->fwd(kern_, x + o * n, p + 2 * o * bins, work);
+        }
+        columns<false>(p);
+    }
+
+    void inv(C* y, T* x) const override {
+        const int n = rows_->size(), bins = n / 2 + 1;
+        T* p = scalars(y);
+        columns<true>(p);
+        T* work = thread_scratch<T>(size_t(n));
+        for (ptrdiff_t o = 0; o < rows_count_; ++o) {
+            rows_->inv(kern_, p + 2 * o * bins, x + o * n, work);
+        }
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// n0 x n1 (n1 contiguous), powers of two
+inline ComplexFFTNDPtr createComplexFFT2D(int n0, int n1)
+{
+    return ComplexFFTNDPtr(new detail::ComplexFFTNDImpl<complex_t>(
+        detail::nd_dims(n0, n1, 0), detail::active_kernels<double>()));
+}
+
+inline ComplexFFTNDPtr createComplexFFT3D(int n0, int n1, int n2)
+{
+    return ComplexFFTNDPtr(new detail::ComplexFFTNDImpl<complex_t>(
+        detail::nd_dims(n0, n1, n2), detail::active_kernels<double>()));
+}
+
+inline ComplexFFTNDfPtr createComplexFFT2Df(int n0, int n1)
+{
+    return ComplexFFTNDfPtr(new detail::ComplexFFTNDImpl<complexf_t>(
+        detail::nd_dims(n0, n1, 0), detail::active_kernels<float>()));
+}
+
+inline ComplexFFTNDfPtr createComplexFFT3Df(int n0, int n1, int n2)
+{
+    return ComplexFFTNDfPtr(new detail::ComplexFFTNDImpl<complexf_t>(
+        detail::nd_dims(n0, n1, n2), detail::active_kernels<float>()));
+}
+
+inline RealFFTNDPtr createRealFFT2D(int n0, int n1)
+{
+    return RealFFTNDPtr(new detail::RealFFTNDImpl<complex_t>(
+        detail::nd_dims(n0, n1, 0), detail::active_kernels<double>()));
+}
+
+inline RealFFTNDPtr createRealFFT3D(int n0, int n1, int n2)
+{
+    return RealFFTNDPtr(new detail::RealFFTNDImpl<complex_t>(
+        detail::nd_dims(n0, n1, n2), detail::active_kernels<double>()));
+}
+
+inline RealFFTNDfPtr createRealFFT2Df(int n0, int n1)
+{
+    return RealFFTNDfPtr(new detail::RealFFTNDImpl<complexf_t>(
+        detail::nd_dims(n0, n1, 0), detail::active_kernels<float>()));
+}
+
+inline RealFFTNDfPtr createRealFFT3Df(int n0, int n1, int n2)
+{
+    return RealFFTNDfPtr(new detail::RealFFTNDImpl<complexf_t>(
+        detail::nd_dims(n0, n1, n2), detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_FFT_ND_H
@@ -0,0 +1,411 @@
+#ifndef OTFFT_EXT_FIXED_H
+#define OTFFT_EXT_FIXED_H
+
+// Complex transforms of a size fixed at compile time, N = 1..64.
+//
+// FixedFFT<N> needs no plan and no heap: each size is a codelet the
+// compiler builds from templates, a Cooley-Tukey recursion over radix-4,
+// radix-2 and odd prime butterflies with compile-time twiddles. Twiddles
+// that are quarter turns (1, -1, +-i) are resolved at compile time rather
+// than multiplied. For a handful of points this avoids the virtual call,
+// the stage loop and the twiddle loads of a plan-based transform; from a
+// few dozen points on, the SIMD kernels of those transforms catch up.
+// fwd() is normalized by 1/N and inv() is unnormalized, as for ComplexFFT;
+// the functions are static and take complex_t or complexf_t.
+//
+//   OTFFT::complex_t x[16], y[16];
+//   OTFFT::FixedFFT<16>::fwd(x);         // in place
+//   OTFFT::FixedFFT<16>::inv(x, y);      // x to y
+//
+// Sizes with a large prime factor (59, 61, ...) compile to an O(p^2) prime
+// butterfly; they work, but a mixed-radix transform is faster there.
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "detail/complex_traits.h"
+
+namespace OTFFT {
+namespace detail {
+
+// cos and sin of 2*pi*k/n as constant expressions: the angle is reduced on
+// integers to the first octant, then summed as a Taylor series
+constexpr double fixed_sin_series(double x2, double term, int i)
+{
+    return i > 12 ? term : term + fixed_sin_series(x2, -term * x2 / ((2 * i) * (2 * i + 1)), i + 1);
+}
+
+constexpr double fixed_cos_series(double x2, double term, int i)
+{
+    return i > 12 ? term : term + fixed_cos_series(x2, -term * x2 / ((2 * i - 1) * (2 * i)), i + 1);
+}
+
+constexpr double fixed_angle(long long a, long long d)
+{
+    return 6.283185307179586476925286766559 * double(a) / double(d);
+}
+
+constexpr double fixed_sin_x(double x) { return fixed_sin_series(x * x, x, 1); }
+constexpr double fixed_cos_x(double x) { return fixed_cos_series(x * x, 1.0, 1); }
+
+// Angle 2*pi*a/d with 0 <= a < d and d a multiple of 8
+constexpr double fixed_cos_reduced(long long a, long long d)
+{
+    return a > d / 2 ? fixed_cos_reduced(d - a, d)
+         : a > d / 4 ? -fixed_cos_reduced(d / 2 - a, d)
+         : a > d / 8 ? fixed_sin_x(fixed_angle(d / 4 - a, d))
+         : fixed_cos_x(fixed_angle(a, d));
+}
+
+constexpr double fixed_sin_reduced(long long a, long long d)
+{
+    return a > d / 2 ? -fixed_sin_reduced(d - a, d)
+         : a > d / 4 ? fixed_sin_reduced(d / 2 - a, d)
+         : a > d / 8 ? fixed_cos_x(fixed_angle(d / 4 - a, d))
+         : fixed_sin_x(fixed_angle(a, d));
+}
+
+constexpr double fixed_cos(int k, int n) { return fixed_cos_reduced(8LL * (k % n), 8LL * n); }
+constexpr double fixed_sin(int k, int n) { return fixed_sin_reduced(8LL * (k % n), 8LL * n); }
+
+// Radix of the first step of an N-point codelet: 4 while N is a multiple
+// of 4 (other than 4 itself), then the smallest prime factor
+constexpr int fixed_prime_factor(int n, int p)
+{
+    return p * p > n ? n : n % p == 0 ? p : fixed_prime_factor(n, p + 2);
+}
+
+constexpr int fixed_radix(int n)
+{
+    return n % 4 == 0 ? 4 : n % 2 == 0 ? 2 : fixed_prime_factor(n, 3);
+}
+
+// Multiplies (re, im) by W^Q for W = -i (forward) or +i (inverse)
+template <int Q, bool Inv>
+struct FixedQuarter;
+
+template <bool Inv>
+struct FixedQuarter<0, Inv> {
+    template <typename T> static void apply(T&, T&) {}
+};
+
+template <bool Inv>
+struct FixedQuarter<1, Inv> {
+    template <typename T> static void apply(T& re, T& im) {
+        const T r = re;
+        re = Inv ? -im : im;
+        im = Inv ? r : -r;
+    }
+};
+
+template <bool Inv>
+struct FixedQuarter<2, Inv> {
+    template <typename T> static void apply(T& re, T& im) {
+        re = -re;
+        im = -im;
+    }
+};
+
+template <bool Inv>
+struct FixedQuarter<3, Inv> {
+    template <typename T> static void apply(T& re, T& im) { FixedQuarter<1, !Inv>::apply(re, im); }
+};
+
+// Multiplies (re, im) by exp(-+2*pi*i*K/N), the sign by direction
+template <int K, int N, bool Inv, bool Quarter = (4 * (K % N)) % N == 0>
+struct FixedRotate {
+    template <typename T> static void apply(T& re, T& im) {
+        FixedQuarter<(4 * (K % N)) / N, Inv>::apply(re, im);
+    }
+};
+
+template <int K, int N, bool Inv>
+struct FixedRotate<K, N, Inv, false> {
+    static constexpr double c = fixed_cos(K, N);
+    static constexpr double s = Inv ? fixed_sin(K, N) : -fixed_sin(K, N);
+
+    template <typename T> static void apply(T& re, T& im) {
+        const T r = re;
+        re = r * T(c) - im * T(s);
+        im = r * T(s) + im * T(c);
+    }
+};
+
+// Compile-time loop: Body<I>::run(args...) for I = B..E-1
+template <template <int> class Body, int B, int E>
+struct FixedFor {
+    template <typename... A> static void run(A... args) {
+        Body<B>::run(args...);
+        FixedFor<Body, B + 1, E>::run(args...);
+    }
+};
+
+template <template <int> class Body, int E>
+struct FixedFor<Body, E, E> {
+    template <typename... A> static void run(A...) {}
+};
+
+// cos and sin of 2*pi*j/R for j = 0..R-1, for the looped butterflies
+template <int... I>
+struct FixedIndices {};
+
+template <int R, int... I>
+struct FixedMakeIndices : FixedMakeIndices<R - 1, R - 1, I...> {};
+
+template <int... I>
+struct FixedMakeIndices<0, I...> {
+    typedef FixedIndices<I...> type;
+};
+
+template <int R, typename I = typename FixedMakeIndices<R>::type>
+struct FixedRoots;
+
+template <int R, int... I>
+struct FixedRoots<R, FixedIndices<I...>> {
+    static constexpr double c[R] = { fixed_cos(I, R)... };
+    static constexpr double s[R] = { fixed_sin(I, R)... };
+};
+
+template <int R, int... I>
+constexpr double FixedRoots<R, FixedIndices<I...>>::c[R];
+template <int R, int... I>
+constexpr double FixedRoots<R, FixedIndices<I...>>::s[R];
+
+// R-point butterfly on re[], im[] in place: 2, 4, or an odd prime (which
+// pairs j with R-j so that only (R-1)^2/2 products remain). Primes up to 7
+// are unrolled with each product's constant inlined; above that, unrolling
+// costs seconds of compile time per size for little gain, so the larger
+// primes loop over a constant table instead.
+template <int R, bool Inv, bool Unrolled = (R <= 7)>
+struct FixedButterfly {
+    static const int H = (R - 1) / 2;
+
+    template <int J>
+    struct Pair {
+        template <typename T> static void run(const T* re, const T* im, T* tr, T* ti, T* ur, T* ui) {
+            tr[J] = re[J + 1] + re[R - 1 - J];
+            ti[J] = im[J + 1] + im[R - 1 - J];
+            ur[J] = re[J + 1] - re[R - 1 - J];
+            ui[J] = im[J + 1] - im[R - 1 - J];
+        }
+    };
+
+    // Output pair K+1 and R-1-K
+    template <int K>
+    struct Out {
+        template <int J>
+        struct Term {
+            static constexpr double c = fixed_cos((J + 1) * (K + 1), R);
+            static constexpr double s = fixed_sin((J + 1) * (K + 1), R);
+
+            template <typename T>
+            static void run(const T* tr, const T* ti, const T* ur, const T* ui, T* a, T* b) {
+                a[0] += tr[J] * T(c);
+                a[1] += ti[J] * T(c);
+                b[0] += ur[J] * T(s);
+                b[1] += ui[J] * T(s);
+            }
+        };
+
+        template <typename T>
+        static void run(T x0r, T x0i, const T* tr, const T* ti, const T* ur, const T* ui, T* re, T* im) {
+            T a[2] = { x0r, x0i };
+            T b[2] = { T(0), T(0) };
+            FixedFor<Term, 0, H>::run(tr, ti, ur, ui, a, b);
+            // X = a -+ i b
+            re[K + 1] = Inv ? a[0] - b[1] : a[0] + b[1];
+            im[K + 1] = Inv ? a[1] + b[0] : a[1] - b[0];
+            re[R - 1 - K] = Inv ? a[0] + b[1] : a[0] - b[1];
+            im[R - 1 - K] = Inv ? a[1] - b[0] : a[1] + b[0];
+        }
+    };
+
+    template <int J>
+    struct Sum {
+        template <typename T> static void run(const T* tr, const T* ti, T* x) {
+            x[0] += tr[J];
+            x[1] += ti[J];
+        }
+    };
+
+    template <typename T> static void run(T* re, T* im) {
+        T tr[H], ti[H], ur[H], ui[H];
+        FixedFor<Pair, 0, H>::run(static_cast<const T*>(re), static_cast<const T*>(im), tr, ti, ur, ui);
+        const T x0r = re[0], x0i = im[0];
+        T x[2] = { x0r, x0i };
+        FixedFor<Sum, 0, H>::run(static_cast<const T*>(tr), static_cast<const T*>(ti), x);
+        FixedFor<Out, 0, H>::run(x0r, x0i, static_cast<const T*>(tr), static_cast<const T*>(ti),
+                                 static_cast<const T*>(ur), static_cast<const T*>(ui), re, im);
+        re[0] = x[0];
+        im[0] = x[1];
+    }
+};
+
+template <int R, bool Inv>
+struct FixedButterfly<R, Inv, false> {
+    static const int H = (R - 1) / 2;
+    typedef FixedRoots<R> Roots;
+
+    template <typename T> static void run(T* re, T* im) {
+        T tr[H], ti[H], ur[H], ui[H];
+        const T x0r = re[0], x0i = im[0];
+        T sr = x0r, si = x0i;
+        for (int j = 0; j < H; ++j) {
+            tr[j] = re[j + 1] + re[R - 1 - j];
+            ti[j] = im[j + 1] + im[R - 1 - j];
+            ur[j] = re[j + 1] - re[R - 1 - j];
+            ui[j] = im[j + 1] - im[R - 1 - j];
+            sr += tr[j];
+            si += ti[j];
+        }
+        for (int k = 1; k <= H; ++k) {
+            T a0 = x0r, a1 = x0i, b0 = T(0), b1 = T(0);
+            int jk = k;  // (j+1)*k mod R
+            for (int j = 0; j < H; ++j) {
+                const T c = T(Roots::c[jk]), s = T(Roots::s[jk]);
+                a0 += tr[j] * c;
+                a1 += ti[j] * c;
+                b0 += ur[j] * s;
+                b1 += ui[j] * s;
+                jk += k;
+                if (jk >= R) jk -= R;
+            }
+            re[k] = Inv ? a0 - b1 : a0 + b1;
+            im[k] = Inv ? a1 + b0 : a1 - b0;
+            re[R - k] = Inv ? a0 + b1 : a0 - b1;
+            im[R - k] = Inv ? a1 - b0 : a1 + b0;
+        }
+        re[0] = sr;
+        im[0] = si;
+    }
+};
+
+template <bool Inv>
+struct FixedButterfly<2, Inv, true> {
+    template <typename T> static void run(T* re, T* im) {
+        const T r = re[0], i = im[0];
+        re[0] = r + re[1];
+        im[0] = i + im[1];
+        re[1] = r - re[1];
+        im[1] = i - im[1];
+    }
+};
+
+template <bool Inv>
+struct FixedButterfly<4, Inv, true> {
+    template <typename T> static void run(T* re, T* im) {
+        const T ar = re[0] + re[2], ai = im[0] + im[2];
+        const T br = re[0] - re[2], bi = im[0] - im[2];
+        const T cr = re[1] + re[3], ci = im[1] + im[3];
+        T dr = re[1] - re[3], di = im[1] - im[3];
+        FixedQuarter<1, Inv>::apply(dr, di);
+        re[0] = ar + cr;
+        im[0] = ai + ci;
+        re[1] = br + dr;
+        im[1] = bi + di;
+        re[2] = ar - cr;
+        im[2] = ai - ci;
+        re[3] = br - dr;
+        im[3] = bi - di;
+    }
+};
+
+// N-point DFT of in[0], in[S], ..., in[(N-1)S] (complex values) into out[]
+// contiguous, decimated in time: R sub-transforms of M = N/R points, then
+// for each k an R-point butterfly over out[k + j*M] twiddled by W_N^(jk)
+template <int N, int S, bool Inv>
+struct FixedDft {
+    static const int R = fixed_radix(N);
+    static const int M = N / R;
+
+    template <int J>
+    struct Sub {
+        template <typename T> static void run(const T* in, T* out) {
+            FixedDft<M, S * R, Inv>::run(in + 2 * J * S, out + 2 * J * M);
+        }
+    };
+
+    template <int K>
+    struct Column {
+        template <int J>
+        struct Load {
+            template <typename T> static void run(const T* out, T* re, T* im) {
+                re[J] = out[2 * (K + J * M)];
+                im[J] = out[2 * (K + J * M) + 1];
+                FixedRotate<J * K, N, Inv>::apply(re[J], im[J]);
+            }
+        };
+
+        template <int J>
+        struct Store {
+            template <typename T> static void run(const T* re, const T* im, T* out) {
+                out[2 * (K + J * M)] = re[J];
+                out[2 * (K + J * M) + 1] = im[J];
+            }
+        };
+
+        template <typename T> static void run(T* out) {
+            T re[R], im[R];
+            FixedFor<Load, 0, R>::run(static_cast<const T*>(out), re, im);
+            FixedButterfly<R, Inv>::run(re, im);
+            FixedFor<Store, 0, R>::run(static_cast<const T*>(re), static_cast<const T*>(im), out);
+        }
+    };
+
+    template <typename T> static void run(const T* in, T* out) {
+        FixedFor<Sub, 0, R>::run(in, out);
+        FixedFor<Column, 0, M>::run(out);
+    }
+};
+
+template <int S, bool Inv>
+struct FixedDft<1, S, Inv> {
+    template <typename T> static void run(const T* in, T* out) {
+        out[0] = in[0];
+        out[1] = in[1];
+    }
+};
+
+// The codelet writes to a local buffer, which the compiler knows aliases
+// nothing and can keep in registers, then scales it out
+template <int N, bool Inv, typename C>
+inline void fixed_transform(const C* x, C* y, typename complex_traits<C>::scalar f)
+{
+    typedef typename complex_traits<C>::scalar T;
+    T buf[2 * N];
+    FixedDft<N, 1, Inv>::run(scalars(x), buf);
+    T* out = scalars(y);
+    for (int i = 0; i < 2 * N; ++i) out[i] = buf[i] * f;
+}
+
+} // namespace detail
+
+template <int N>
+struct FixedFFT {
+    static_assert(N >= 1 && N <= 64, "OTFFT ext: FixedFFT sizes are 1 to 64");
+
+    static int size() { return N; }
+
+    // x to y, normalized by 1/N; y may equal x
+    template <typename C>
+    static void fwd(const C* x, C* y) {
+        typedef typename detail::complex_traits<C>::scalar T;
+        detail::fixed_transform<N, false>(x, y, T(1) / N);
+    }
+
+    // x to y, unnormalized; y may equal x
+    template <typename C>
+    static void inv(const C* x, C* y) {
+        typedef typename detail::complex_traits<C>::scalar T;
+        detail::fixed_transform<N, true>(x, y, T(1));
+    }
+
+    template <typename C>
+    static void fwd(C* x) { fwd(static_cast<const C*>(x), x); }
+
+    template <typename C>
+    static void inv(C* x) { inv(static_cast<const C*>(x), x); }
+};
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_FIXED_H
@@ -0,0 +1,106 @@
+#ifndef OTFFT_EXT_MIXED_RADIX_H
+#define OTFFT_EXT_MIXED_RADIX_H
+
+// Complex transforms of any size.
+//
+// Upstream OTFFT runs sizes that are not powers of two through Bluestein's
+// algorithm, at roughly the cost of three power-of-two transforms of twice
+// the size. Here, sizes with no prime factor above 7 (1000, 1536, 3000,
+// 48000, ...) run directly as Stockham transforms with radix-2, 3, 4, 5, 7
+// and 8 passes. Only sizes with a larger prime factor fall back to
+// Bluestein; bluestein() tells which path an object takes. fwd() is
+// normalized by 1/N and inv() is unnormalized, as for ComplexFFT.
+//
+//   auto fft = OTFFT::FactoryExt::createMixedRadixFFT(3000);
+//   fft->fwd(data);   // OTFFT::complex_t* data, 3000 values
+//
+// ComplexFFTf, RealFFTf and CompactRealFFT accept the same 7-smooth sizes
+// (even ones, with N/2 7-smooth, for the real transforms) but have no
+// Bluestein fallback.
+
+#include <memory>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/bluestein.h"
+#include "detail/complex_traits.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicMixedRadixFFT {
+public:
+    virtual ~BasicMixedRadixFFT() {}
+    virtual int size() const = 0;
+    // True if the size has a prime factor above 7
+    virtual bool bluestein() const = 0;
+    // In place on size() values
+    virtual void fwd(C* x) const = 0;
+    virtual void inv(C* x) const = 0;
+};
+
+typedef BasicMixedRadixFFT<complex_t> MixedRadixFFT;
+typedef BasicMixedRadixFFT<complexf_t> MixedRadixFFTf;
+
+typedef std::unique_ptr<MixedRadixFFT> MixedRadixFFTPtr;
+typedef std::unique_ptr<MixedRadixFFTf> MixedRadixFFTfPtr;
+
+namespace detail {
+
+template <typename C>
+class MixedRadixFFTImpl : public BasicMixedRadixFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    int n_;
+    std::shared_ptr<const StockhamPlan<T>> plan_;       // 7-smooth sizes
+    std::shared_ptr<const BluesteinPlan<T>> chirp_;     // all others
+
+    template <bool Inv>
+    void run(C* data) const {
+        T* x = reinterpret_cast<T*>(data);
+        const T scale = Inv ? T(1) : T(1) / n_;
+        if (chirp_) {
+            T* work = thread_scratch<T>(4 * size_t(chirp_->conv_size()));
+            chirp_->template run<Inv>(kern_, x, x, work, scale);
+            return;
+        }
+        T* work = thread_scratch<T>(2 * size_t(n_));
+        if (Inv) kern_.inv(*plan_, x, x, work, scale);
+        else kern_.fwd(*plan_, x, x, work, scale);
+    }
+
+public:
+    MixedRadixFFTImpl(int n, const KernelTable<T>& kern) : kern_(kern), n_(n) {
+        if (is_smooth(n)) plan_ = PlanCache::instance().complex_plan<T>(n, kern);
+        else chirp_ = PlanCache::instance().bluestein_plan<T>(n, kern);
+    }
+
+    int size() const override { return n_; }
+    bool bluestein() const override { return bool(chirp_); }
+    void fwd(C* x) const override { run<false>(x); }
+    void inv(C* x) const override { run<true>(x); }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline MixedRadixFFTPtr createMixedRadixFFT(int n)
+{
+    return MixedRadixFFTPtr(new detail::MixedRadixFFTImpl<complex_t>(n, detail::active_kernels<double>()));
+}
+
+inline MixedRadixFFTfPtr createMixedRadixFFTf(int n)
+{
+    return MixedRadixFFTfPtr(new detail::MixedRadixFFTImpl<complexf_t>(n, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_MIXED_RADIX_H
@@ -0,0 +1,372 @@
+#ifndef OTFFT_EXT_OUT_OF_CORE_H
+#define OTFFT_EXT_OUT_OF_CORE_H
+
+// Complex transforms of files larger than memory, such as 2^31 points and
+// up, run through memory-mapped files (POSIX mmap) with a bounded working
+// set.
+//
+// The files hold N interleaved {Re, Im} values of the scalar type in native
+// byte order and nothing else. A transform of N = R*C points is a six-step
+// FFT over the R x C row-major view of the input, done in two passes over
+// the data:
+//   1. columns: strips of adjacent columns, R segments of the file each,
+//      are transformed by the batch kernels (length R) in L2-sized pieces,
+//      twiddled by W_N^(k1*n2), and stored at the same place in a scratch
+//      file
+//   2. rows: blocks of consecutive rows of the scratch file, one sequential
+//      range each, are transformed (length C) and written transposed, so
+//      the output file is in natural order
+// While a strip or block is being transformed, the next one is requested
+// from the kernel with madvise(MADV_WILLNEED), so reading it overlaps the
+// arithmetic. The two together fill memory_bytes() of page cache; the
+// larger that budget, the longer the file segments pass 1 reads at a time.
+// The transform buffers themselves stay cache-sized.
+// The scratch file (N values) is created next to the output and unlinked
+// right away, so it never outlives the call. The output may be the input
+// file itself. fwd() is normalized by 1/N and inv() is unnormalized, as
+// for ComplexFFT.
+//
+//   auto fft = OTFFT::FactoryExt::createOutOfCoreFFT(1LL << 32);   // 64 GiB files
+//   fft->fwd("signal.bin", "spectrum.bin");
+
+// Windows has no POSIX mmap, so there the header declares nothing. It
+// defines OTFFT_EXT_HAS_OUT_OF_CORE where the transform is available, for
+// callers that are built on both.
+#if !defined(_WIN32)
+
+#define OTFFT_EXT_HAS_OUT_OF_CORE 1
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/columns.h"
+#include "detail/complex_traits.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicOutOfCoreFFT {
+public:
+    virtual ~BasicOutOfCoreFFT() {}
+    virtual long long size() const = 0;
+    // Bytes of the files in flight: the strip or block being transformed
+    // and the one being read ahead
+    virtual size_t memory_bytes() const = 0;
+    // Transforms the size() values in the file in and writes them to the
+    // file out, which is created or resized as needed; out may be in
+    virtual void fwd(const std::string& in, const std::string& out) const = 0;
+    virtual void inv(const std::string& in, const std::string& out) const = 0;
+};
+
+typedef BasicOutOfCoreFFT<complex_t> OutOfCoreFFT;
+typedef BasicOutOfCoreFFT<complexf_t> OutOfCoreFFTf;
+
+typedef std::unique_ptr<OutOfCoreFFT> OutOfCoreFFTPtr;
+typedef std::unique_ptr<OutOfCoreFFTf> OutOfCoreFFTfPtr;
+
+namespace detail {
+
+static const size_t kOutOfCoreMemory = size_t(256) << 20;
+static const long long kOutOfCoreMaxSize = 1LL << 40;
+static const size_t kOutOfCorePrefetchMin = 4096;
+
+// A whole file mapped shared; unmapped and closed on destruction
+class MappedFile {
+public:
+    MappedFile() : fd_(-1), data_(nullptr), bytes_(0) {}
+    ~MappedFile() { reset(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // An existing file of exactly bytes, read only
+    void open_read(const std::string& path, size_t bytes) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) fail("cannot open", path);
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) fail("cannot stat", path);
+        if (st.st_size < 0 || size_t(st.st_size) != bytes) {
+            reset();
+            throw std::invalid_argument("OTFFT ext: " + path + " does not hold the out-of-core transform size");
+        }
+        map(PROT_READ, bytes, path);
+    }
+
+    // Created if missing and resized to bytes
+    void open_write(const std::string& path, size_t bytes) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0666);
+        if (fd_ < 0) fail("cannot open", path);
+        if (::ftruncate(fd_, off_t(bytes)) != 0) fail("cannot resize", path);
+        map(PROT_READ | PROT_WRITE, bytes, path);
+    }
+
+    // A new file next to path, unlinked as soon as it is open
+    void open_scratch(const std::string& path, size_t bytes) {
+        std::string name = path + ".scratch.XXXXXX";
+        std::vector<char> buf(name.begin(), name.end());
+        buf.push_back('\0');
+        fd_ = ::mkstemp(buf.data());
+        if (fd_ < 0) fail("cannot create scratch file for", path);
+        ::unlink(buf.data());
+        if (::ftruncate(fd_, off_t(bytes)) != 0) fail("cannot resize scratch file for", path);
+        map(PROT_READ | PROT_WRITE, bytes, path);
+    }
+
+    char* data() const { return data_; }
+
+    // Asks the kernel to start reading [offset, offset + len) in the
+    // background; only a hint, so failures are ignored
+    void prefetch(size_t offset, size_t len) const {
+        static const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+        const size_t begin = offset / page * page;
+        ::madvise(data_ + begin, offset + len - begin, MADV_WILLNEED);
+    }
+
+    void reset() {
+        if (data_) ::munmap(data_, bytes_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        data_ = nullptr;
+        bytes_ = 0;
+    }
+
+private:
+    int fd_;
+    char* data_;
+    size_t bytes_;
+
+    void map(int prot, size_t bytes, const std::string& path) {
+        void* p = ::mmap(nullptr, bytes, prot, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) fail("cannot map", path);
+        data_ = static_cast<char*>(p);
+        bytes_ = bytes;
+    }
+
+    void fail(const char* what, const std::string& path) {
+        const int e = errno;
+        reset();
+        throw std::system_error(e, std::generic_category(), std::string("OTFFT ext: ") + what + " " + path);
+    }
+};
+
+// Largest power of two <= x, at least 1 and at most limit
+inline int floor_pow2(size_t x, int limit)
+{
+    int p = 1;
+    while (p < limit && size_t(2 * p) <= x) p *= 2;
+    return p;
+}
+
+template <typename C>
+class OutOfCoreFFTImpl : public BasicOutOfCoreFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    long long n_;
+    size_t memory_;
+    int rows_;    // R: length of the column transforms
+    int cols_;    // C: length of the row transforms
+    int strip_;   // columns per strip of pass 1
+    int block_;   // rows per block of pass 2
+    std::shared_ptr<const StockhamPlan<T>> col_plan_;
+    std::shared_ptr<const StockhamPlan<T>> row_plan_;
+    // W_N^m = hi[m >> lo_bits_] * lo[m & lo_mask], m = k1*n2 < N, in double
+    // so that float transforms of 2^31+ points keep their accuracy
+    int lo_bits_;
+    AlignedBuffer<double> lo_;
+    AlignedBuffer<double> hi_;
+
+    static size_t complex_bytes() { return 2 * sizeof(T); }
+
+    // W_N^m, or its conjugate
+    template <bool Inv>
+    void root(long long m, double* w) const {
+        const double* a = hi_.data() + 2 * (m >> lo_bits_);
+        const double* b = lo_.data() + 2 * (m & ((1LL << lo_bits_) - 1));
+        w[0] = a[0] * b[0] - a[1] * b[1];
+        w[1] = Inv ? -(a[0] * b[1] + a[1] * b[0]) : a[0] * b[1] + a[1] * b[0];
+    }
+
+    // p[t] *= W_N^(k1*(c0+t)) for t < count: two table products, then
+    // steps of W_N^k1 in double, at most one L2 piece of columns long
+    template <bool Inv>
+    void twiddle_segment(T* p, int k1, int c0, int count) const {
+        double w[2], s[2];
+        root<Inv>((long long)k1 * c0, w);
+        root<Inv>(k1, s);
+        for (int t = 0; t < count; ++t) {
+            const double xr = p[2 * t], xi = p[2 * t + 1];
+            p[2 * t] = T(xr * w[0] - xi * w[1]);
+            p[2 * t + 1] = T(xr * w[1] + xi * w[0]);
+            const double wr = w[0] * s[0] - w[1] * s[1];
+            w[1] = w[0] * s[1] + w[1] * s[0];
+            w[0] = wr;
+        }
+    }
+
+    // One range when the strip is the whole file; no hints for segments
+    // shorter than a page, which neighbouring strips share anyway
+    void prefetch_strip(const MappedFile& f, int c0) const {
+        const size_t seg = size_t(strip_) * complex_bytes();
+        if (strip_ == cols_) {
+            f.prefetch(0, size_t(rows_) * seg);
+        } else if (seg >= kOutOfCorePrefetchMin) {
+            for (int j = 0; j < rows_; ++j) f.prefetch((size_t(j) * cols_ + c0) * complex_bytes(), seg);
+        }
+    }
+
+    // Pass 1: column transforms and twiddles, x to y in the same layout.
+    // Each strip is transformed in L2-sized pieces while the next one is
+    // being read.
+    template <bool Inv>
+    void columns(const MappedFile& in, const T* x, T* y) const {
+        const int piece = nd_strip(rows_, complex_bytes(), kern_.lanes, strip_);
+        AlignedBuffer<T> buf(4 * size_t(rows_) * piece);
+        T* work = buf.data() + 2 * size_t(rows_) * piece;
+        const size_t seg = size_t(piece) * complex_bytes();
+        prefetch_strip(in, 0);
+        for (int s0 = 0; s0 < cols_; s0 += strip_) {
+            if (s0 + strip_ < cols_) prefetch_strip(in, s0 + strip_);
+            for (int c0 = s0; c0 < s0 + strip_; c0 += piece) {
+                for (int j = 0; j < rows_; ++j) {
+                    std::memcpy(buf.data() + 2 * size_t(j) * piece, x + 2 * (size_t(j) * cols_ + c0), seg);
+                }
+                if (Inv) kern_.inv_batch(*col_plan_, piece, buf.data(), work, T(1));
+                else kern_.fwd_batch(*col_plan_, piece, buf.data(), work, T(1));
+                for (int k1 = 1; k1 < rows_; ++k1) {
+                    twiddle_segment<Inv>(buf.data() + 2 * size_t(k1) * piece, k1, c0, piece);
+                }
+                for (int k1 = 0; k1 < rows_; ++k1) {
+                    std::memcpy(y + 2 * (size_t(k1) * cols_ + c0), buf.data() + 2 * size_t(k1) * piece, seg);
+                }
+            }
+        }
+    }
+
+    // Pass 2: row transforms of y, written to z transposed: row k1 of y
+    // becomes z[k2*R + k1]. Rows go through memory 16 at a time, so every
+    // output segment of 16 values is written whole.
+    template <bool Inv>
+    void rows(const MappedFile& scratch, const T* y, T* z) const {
+        const int group = std::min(16, block_);
+        AlignedBuffer<T> buf(2 * size_t(group + 1) * cols_);
+        T* work = buf.data() + 2 * size_t(group) * cols_;
+        const T scale = Inv ? T(1) : T(1.0 / double(n_));
+        const size_t range = size_t(block_) * cols_ * complex_bytes();
+        scratch.prefetch(0, range);
+        for (int b0 = 0; b0 < rows_; b0 += block_) {
+            if (b0 + block_ < rows_) scratch.prefetch(size_t(b0 + block_) * cols_ * complex_bytes(), range);
+            for (int r0 = b0; r0 < b0 + block_; r0 += group) {
+                for (int r = 0; r < group; ++r) {
+                    const T* row = y + 2 * size_t(r0 + r) * cols_;
+                    T* out = buf.data() + 2 * size_t(r) * cols_;
+                    if (Inv) kern_.inv(*row_plan_, row, out, work, scale);
+                    else kern_.fwd(*row_plan_, row, out, work, scale);
+                }
+                for (int k = 0; k < cols_; ++k) {
+                    T* dst = z + 2 * (size_t(k) * rows_ + r0);
+                    const T* src = buf.data() + 2 * size_t(k);
+                    for (int r = 0; r < group; ++r) {
+                        dst[2 * r] = src[2 * size_t(r) * cols_];
+                        dst[2 * r + 1] = src[2 * size_t(r) * cols_ + 1];
+                    }
+                }
+            }
+        }
+    }
+
+    template <bool Inv>
+    void run(const std::string& in_path, const std::string& out_path) const {
+        const size_t bytes = size_t(n_) * complex_bytes();
+        MappedFile in, scratch, out;
+        in.open_read(in_path, bytes);
+        scratch.open_scratch(out_path, bytes);
+        columns<Inv>(in, reinterpret_cast<const T*>(in.data()), reinterpret_cast<T*>(scratch.data()));
+        // The input is no longer read, so the output may replace it
+        in.reset();
+        out.open_write(out_path, bytes);
+        rows<Inv>(scratch, reinterpret_cast<const T*>(scratch.data()), reinterpret_cast<T*>(out.data()));
+    }
+
+public:
+    OutOfCoreFFTImpl(long long n, size_t memory, const KernelTable<T>& kern)
+        : kern_(kern), n_(n), memory_(memory), rows_(0), cols_(0), strip_(0), block_(0), lo_bits_(0) {
+        if (n < 4 || n > kOutOfCoreMaxSize || (n & (n - 1)) != 0) {
+            throw std::invalid_argument("OTFFT ext: out-of-core FFT size must be a power of two from 4 to 2^40");
+        }
+        if (sizeof(size_t) < 8 && n > (1LL << 26)) {
+            throw std::invalid_argument("OTFFT ext: out-of-core FFT size needs a 64-bit address space");
+        }
+        int log2n = 0;
+        while ((1LL << log2n) < n) ++log2n;
+        rows_ = 1 << (log2n / 2);
+        cols_ = int(n / rows_);
+        col_plan_ = PlanCache::instance().complex_plan<T>(rows_, kern);
+        row_plan_ = PlanCache::instance().complex_plan<T>(cols_, kern);
+        // A strip or block being transformed plus the next one being read
+        // fill the budget; at least a page per strip segment and one row
+        // per block, so no page of the input is read twice
+        strip_ = floor_pow2(std::max(memory / (2 * size_t(rows_) * complex_bytes()),
+                                     kOutOfCorePrefetchMin / complex_bytes()), cols_);
+        block_ = floor_pow2(memory / (2 * size_t(cols_) * complex_bytes()), rows_);
+        lo_bits_ = (log2n + 1) / 2;
+        const int lo = 1 << lo_bits_, hi = int(n >> lo_bits_);
+        lo_ = AlignedBuffer<double>(2 * size_t(lo));
+        hi_ = AlignedBuffer<double>(2 * size_t(hi));
+        const double theta = -2.0 * M_PI / double(n);
+        for (int j = 0; j < lo; ++j) {
+            lo_[2 * j] = cos(theta * j);
+            lo_[2 * j + 1] = sin(theta * j);
+        }
+        for (int j = 0; j < hi; ++j) {
+            hi_[2 * j] = cos(theta * (double(j) * lo));
+            hi_[2 * j + 1] = sin(theta * (double(j) * lo));
+        }
+    }
+
+    long long size() const override { return n_; }
+    size_t memory_bytes() const override { return memory_; }
+    void fwd(const std::string& in, const std::string& out) const override { run<false>(in, out); }
+    void inv(const std::string& in, const std::string& out) const override { run<true>(in, out); }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// memory: bytes of page cache the passes keep in flight (see memory_bytes())
+inline OutOfCoreFFTPtr createOutOfCoreFFT(long long n, size_t memory = detail::kOutOfCoreMemory)
+{
+    return OutOfCoreFFTPtr(new detail::OutOfCoreFFTImpl<complex_t>(n, memory, detail::active_kernels<double>()));
+}
+
+inline OutOfCoreFFTfPtr createOutOfCoreFFTf(long long n, size_t memory = detail::kOutOfCoreMemory)
+{
+    return OutOfCoreFFTfPtr(new detail::OutOfCoreFFTImpl<complexf_t>(n, memory, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // !_WIN32
+
+#endif // OTFFT_EXT_OUT_OF_CORE_H
@@ -0,0 +1,226 @@
+#ifndef OTFFT_EXT_PARALLEL_H
+#define OTFFT_EXT_PARALLEL_H
+
+// Multithreaded complex transforms of large sizes, run on an Executor
+// (see executor.h).
+//
+// From kParallelMinSize (2^18) points up, a transform of N = R*C points
+// runs as a six-step FFT over the C x R row-major view of x:
+//   1. R column transforms of length C, in strips of adjacent columns
+//   2. twiddle x[k2][n1] by W_N^(n1*k2)
+//   3. C row transforms of length R
+//   4. transpose to R x C
+// Steps 1, 2+3 and 4 are one parallel_for each. Every task works on a
+// cache-sized block, and no pass walks the whole array with a large
+// stride. Smaller sizes run the single-threaded kernels on the calling
+// thread. fwd() is normalized by 1/N and inv() is unnormalized, as for
+// ComplexFFT.
+//
+//   auto fft = OTFFT::FactoryExt::createParallelComplexFFT(1 << 20);            // default pool
+//   auto fft = OTFFT::FactoryExt::createParallelComplexFFT(1 << 20, &my_exec);  // own threads
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "executor.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/columns.h"
+#include "detail/complex_traits.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicParallelComplexFFT {
+public:
+    virtual ~BasicParallelComplexFFT() {}
+    virtual int size() const = 0;
+    // In place on size() values
+    virtual void fwd(C* x) const = 0;
+    virtual void inv(C* x) const = 0;
+};
+
+typedef BasicParallelComplexFFT<complex_t> ParallelComplexFFT;
+typedef BasicParallelComplexFFT<complexf_t> ParallelComplexFFTf;
+
+typedef std::unique_ptr<ParallelComplexFFT> ParallelComplexFFTPtr;
+typedef std::unique_ptr<ParallelComplexFFTf> ParallelComplexFFTfPtr;
+
+namespace detail {
+
+static const int kParallelMinSize = 1 << 18;
+
+// Start of part t of count items split into parts pieces
+inline int parallel_split(int count, int parts, int t)
+{
+    return int(ptrdiff_t(count) * t / parts);
+}
+
+template <typename C>
+class ParallelComplexFFTImpl : public BasicParallelComplexFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    Executor& exec_;
+    int n_;
+    int rows_;  // C: length of the column transforms
+    int cols_;  // R: length of the row transforms
+    std::shared_ptr<const StockhamPlan<T>> whole_;  // below kParallelMinSize
+    std::shared_ptr<const StockhamPlan<T>> col_plan_;
+    std::shared_ptr<const StockhamPlan<T>> row_plan_;
+    // W_N^m = hi[m >> lo_bits_] * lo[m & lo_mask], m = n1*k2 < N
+    int lo_bits_;
+    AlignedBuffer<T> lo_;
+    AlignedBuffer<T> hi_;
+
+    int tasks(int items) const { return std::max(1, std::min(items, 8 * exec_.concurrency())); }
+
+    // W_N^m, or its conjugate
+    template <bool Inv>
+    void twiddle(ptrdiff_t m, T* w) const {
+        const T* a = hi_.data() + 2 * (m >> lo_bits_);
+        const T* b = lo_.data() + 2 * (m & ((ptrdiff_t(1) << lo_bits_) - 1));
+        w[0] = a[0] * b[0] - a[1] * b[1];
+        w[1] = Inv ? -(a[0] * b[1] + a[1] * b[0]) : a[0] * b[1] + a[1] * b[0];
+    }
+
+    // row[n1] *= W_N^(n1*k2) with n1 = 16*a + b, as W_N^(16*a*k2) * W_N^(b*k2):
+    // two table products per 16 values, and a plain complex multiply loop
+    template <bool Inv>
+    void twiddle_row(T* row, int k2) const {
+        T u[32], v[2];
+        for (int b = 0; b < 16; ++b) twiddle<Inv>(ptrdiff_t(b) * k2, u + 2 * b);
+        for (int a = 0; a < cols_ / 16; ++a) {
+            twiddle<Inv>(ptrdiff_t(16) * a * k2, v);
+            T* p = row + 32 * a;
+            for (int b = 0; b < 16; ++b) {
+                const T wr = v[0] * u[2 * b] - v[1] * u[2 * b + 1];
+                const T wi = v[0] * u[2 * b + 1] + v[1] * u[2 * b];
+                const T xr = p[2 * b], xi = p[2 * b + 1];
+                p[2 * b] = xr * wr - xi * wi;
+                p[2 * b + 1] = xr * wi + xi * wr;
+            }
+        }
+    }
+
+    template <bool Inv>
+    void run(C* data) const {
+        T* x = reinterpret_cast<T*>(data);
+        const T scale = Inv ? T(1) : T(1) / n_;
+        if (whole_) {
+            T* work = thread_scratch<T>(2 * size_t(n_));
+            if (Inv) kern_.inv(*whole_, x, x, work, scale);
+            else kern_.fwd(*whole_, x, x, work, scale);
+            return;
+        }
+        const int rows = rows_, cols = cols_;
+        // Steps 3 and 4 go through y; slot 1 keeps it clear of the kernel
+        // scratch the calling thread uses when it runs tasks itself
+        T* y = thread_scratch<T, 1>(2 * size_t(n_));
+
+        // 1. Columns, in whole strips
+        const int strip = nd_strip(rows, 2 * sizeof(T), kern_.lanes, cols);
+        const int strips = (cols + strip - 1) / strip;
+        const int col_tasks = tasks(strips);
+        exec_.parallel_for(col_tasks, [&](int t) {
+            const ptrdiff_t c0 = ptrdiff_t(parallel_split(strips, col_tasks, t)) * strip;
+            const ptrdiff_t c1 = std::min<ptrdiff_t>(ptrdiff_t(parallel_split(strips, col_tasks, t + 1)) * strip, cols);
+            nd_column_range<T, Inv>(kern_, *col_plan_, cols, c0, c1, x, T(1));
+        });
+
+        // 2 + 3. Twiddles and row transforms, into y
+        const int row_tasks = tasks(rows);
+        exec_.parallel_for(row_tasks, [&](int t) {
+            T* work = thread_scratch<T>(2 * size_t(cols));
+            for (int k2 = parallel_split(rows, row_tasks, t); k2 < parallel_split(rows, row_tasks, t + 1); ++k2) {
+                T* row = x + 2 * ptrdiff_t(k2) * cols;
+                twiddle_row<Inv>(row, k2);
+                T* out = y + 2 * ptrdiff_t(k2) * cols;
+                if (Inv) kern_.inv(*row_plan_, row, out, work, scale);
+                else kern_.fwd(*row_plan_, row, out, work, scale);
+            }
+        });
+
+        // 4. y (rows x cols) transposed into x (cols x rows), in tiles
+        const int tile = 16;
+        const int bands = cols / tile;
+        const int tr_tasks = tasks(bands);
+        exec_.parallel_for(tr_tasks, [&](int t) {
+            const int k1_end = parallel_split(bands, tr_tasks, t + 1) * tile;
+            for (int k1_0 = parallel_split(bands, tr_tasks, t) * tile; k1_0 < k1_end; k1_0 += tile) {
+                for (int k2_0 = 0; k2_0 < rows; k2_0 += tile) {
+                    for (int k1 = k1_0; k1 < k1_0 + tile; ++k1) {
+                        T* dst = x + 2 * (ptrdiff_t(k1) * rows + k2_0);
+                        const T* src = y + 2 * (ptrdiff_t(k2_0) * cols + k1);
+                        for (int j = 0; j < tile; ++j) {
+                            dst[2 * j] = src[2 * ptrdiff_t(j) * cols];
+                            dst[2 * j + 1] = src[2 * ptrdiff_t(j) * cols + 1];
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+public:
+    ParallelComplexFFTImpl(int n, Executor& exec, const KernelTable<T>& kern)
+        : kern_(kern), exec_(exec), n_(n), rows_(0), cols_(0), lo_bits_(0) {
+        if (!is_power_of_two(n)) {
+            throw std::invalid_argument("OTFFT ext: parallel FFT size must be a power of two");
+        }
+        if (n < kParallelMinSize) {
+            whole_ = PlanCache::instance().complex_plan<T>(n, kern);
+            return;
+        }
+        const int log2n = ilog2(n);
+        rows_ = 1 << (log2n / 2);
+        cols_ = n / rows_;
+        col_plan_ = PlanCache::instance().complex_plan<T>(rows_, kern);
+        row_plan_ = PlanCache::instance().complex_plan<T>(cols_, kern);
+        lo_bits_ = (log2n + 1) / 2;
+        const int lo = 1 << lo_bits_, hi = n >> lo_bits_;
+        lo_.resize(2 * size_t(lo));
+        hi_.resize(2 * size_t(hi));
+        const double theta = -2.0 * M_PI / n;
+        for (int j = 0; j < lo; ++j) {
+            lo_[2 * j] = T(cos(theta * j));
+            lo_[2 * j + 1] = T(sin(theta * j));
+        }
+        for (int j = 0; j < hi; ++j) {
+            hi_[2 * j] = T(cos(theta * (double(j) * lo)));
+            hi_[2 * j + 1] = T(sin(theta * (double(j) * lo)));
+        }
+    }
+
+    int size() const override { return n_; }
+    void fwd(C* x) const override { run<false>(x); }
+    void inv(C* x) const override { run<true>(x); }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// executor: nullptr for default_executor(); it must outlive the object
+inline ParallelComplexFFTPtr createParallelComplexFFT(int n, Executor* executor = nullptr)
+{
+    return ParallelComplexFFTPtr(new detail::ParallelComplexFFTImpl<complex_t>(
+        n, executor ? *executor : default_executor(), detail::active_kernels<double>()));
+}
+
+inline ParallelComplexFFTfPtr createParallelComplexFFTf(int n, Executor* executor = nullptr)
+{
+    return ParallelComplexFFTfPtr(new detail::ParallelComplexFFTImpl<complexf_t>(
+        n, executor ? *executor : default_executor(), detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_PARALLEL_H
@@ -0,0 +1,305 @@
+#ifndef OTFFT_EXT_PARTIAL_H
+#define OTFFT_EXT_PARTIAL_H
+
+// Complex forward transforms that compute only a chosen list of bins.
+//
+// A PartialFFT is created for a size N and a list of bins and writes just
+// those bins of the spectrum, normalized by 1/N like ComplexFFT::fwd. It
+// picks one of three methods from a cost estimate:
+//   PARTIAL_GOERTZEL  a bank of Goertzel recurrences, one bin per SIMD lane:
+//                     O(N) per vector of bins, no FFT at all. Cheapest for
+//                     up to a vector or two of bins, and for sizes with a
+//                     prime factor above 7 unless most bins are wanted.
+//   PARTIAL_PRUNED    N = P*Q: Q interleaved P-point FFTs through the batch
+//                     kernels, then for each bin k a Q-term sum
+//                     X[k] = sum_q W_N^(qk) Y_q[k mod P]. Costs about
+//                     N log P + bins*Q, so P grows with the bin count.
+//   PARTIAL_FULL      the whole transform, then a gather.
+// Passing a method to the factory forces it; the benchmark's partial table
+// shows where the estimates cross over.
+//
+//   const int bins[] = {50, 100, 150, 200};
+//   auto pfft = OTFFT::FactoryExt::createPartialFFT(8192, bins, 4);
+//   pfft->fwd(x, y);   // y[j] = X[bins[j]] / 8192
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/bluestein.h"
+#include "detail/complex_traits.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+enum PartialMethod { PARTIAL_AUTO, PARTIAL_GOERTZEL, PARTIAL_PRUNED, PARTIAL_FULL };
+
+template <typename C>
+class BasicPartialFFT {
+public:
+    virtual ~BasicPartialFFT() {}
+    virtual int size() const = 0;
+    // Number of bins computed, and the j-th of them
+    virtual int bins() const = 0;
+    virtual int bin(int j) const = 0;
+    // The method in use (never PARTIAL_AUTO)
+    virtual PartialMethod method() const = 0;
+    // x: size() values (only read) -> y: bins() values, y[j] = X[bin(j)] / N
+    virtual void fwd(const C* x, C* y) const = 0;
+};
+
+typedef BasicPartialFFT<complex_t> PartialFFT;
+typedef BasicPartialFFT<complexf_t> PartialFFTf;
+
+typedef std::unique_ptr<PartialFFT> PartialFFTPtr;
+typedef std::unique_ptr<PartialFFTf> PartialFFTfPtr;
+
+namespace detail {
+
+// Rough operation counts in vector instructions of w real lanes, only
+// meant to rank the methods against each other
+inline double full_fft_cost(int n, int w)
+{
+    if (is_smooth(n)) return 5.0 * n * std::log2(double(n)) / w;
+    int m = 1;
+    while (m < 2 * n - 1) m *= 2;
+    // The chirp products around the two transforms are scalar
+    return 2 * full_fft_cost(m, w) + 6.0 * m + 12.0 * n;
+}
+
+// One group of w bins is bound by the latency of its recurrence, more
+// groups by throughput
+inline double goertzel_cost(int n, int bins, int w)
+{
+    return n * (1.0 + 3.0 * ((bins + w - 1) / w));
+}
+
+// Copy in, Q batched P-point FFTs (which fill only Q of the w/2 complex
+// lanes when Q is smaller), and per bin a Q-term product (vector) and sum
+// (scalar)
+inline double pruned_cost(int n, int p, int bins, int w)
+{
+    const int q = n / p;
+    const double fill = std::max(1.0, w / 2.0 / q);
+    return 2.0 * n / w + fill * 5.0 * n * std::log2(double(p)) / w + bins * (8.0 * q / w + 2.0 * q);
+}
+
+// Cheapest P for the pruned method among the 7-smooth divisors 1 < P < N,
+// or 0 if there is none
+inline int pruned_factor(int n, int bins, int w)
+{
+    int best = 0;
+    for (int d = 1; ptrdiff_t(d) * d <= n; ++d) {
+        if (n % d != 0) continue;
+        const int pair[] = {d, n / d};
+        for (int p : pair) {
+            if (p < 2 || p >= n || !is_smooth(p)) continue;
+            if (!best || pruned_cost(n, p, bins, w) < pruned_cost(n, best, bins, w)) best = p;
+        }
+    }
+    return best;
+}
+
+static const int kGoertzelSegment = 256;
+
+template <typename C>
+class PartialFFTImpl : public BasicPartialFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    int n_;
+    std::vector<int> bins_;
+    PartialMethod method_;
+    // PARTIAL_GOERTZEL: 2 cos(w) per bin, padded to whole groups, and
+    // {e^(iw), e^(-iw*kGoertzelSegment)} per bin to combine the segments
+    int groups_;
+    AlignedBuffer<T> coef_;
+    AlignedBuffer<T> rot_;
+    // PARTIAL_PRUNED: W_N^(qk) / N rows of Q values per bin
+    int p_;
+    AlignedBuffer<T> tw_;
+    std::shared_ptr<const StockhamPlan<T>> plan_;    // size P, or N for PARTIAL_FULL
+    std::shared_ptr<const BluesteinPlan<T>> chirp_;  // PARTIAL_FULL, N not 7-smooth
+
+    void init_goertzel() {
+        const int w = 2 * kern_.lanes;
+        const int count = int(bins_.size());
+        groups_ = (count + w - 1) / w;
+        coef_.resize(size_t(groups_) * w);
+        rot_.resize(4 * size_t(count));
+        for (size_t b = 0; b < coef_.size(); ++b) {
+            const double theta = b < bins_.size() ? 2.0 * M_PI * bins_[b] / n_ : 0.0;
+            coef_[b] = T(2.0 * cos(theta));
+            if (b < bins_.size()) {
+                const double step = -2.0 * M_PI * double((long long)bins_[b] * kGoertzelSegment % n_) / n_;
+                rot_[4 * b] = T(cos(theta));
+                rot_[4 * b + 1] = T(sin(theta));
+                rot_[4 * b + 2] = T(cos(step));
+                rot_[4 * b + 3] = T(sin(step));
+            }
+        }
+    }
+
+    void init_pruned(int p) {
+        p_ = p;
+        const int q = n_ / p;
+        plan_ = PlanCache::instance().complex_plan<T>(p, kern_);
+        tw_.resize(2 * bins_.size() * q);
+        for (size_t j = 0; j < bins_.size(); ++j) {
+            for (int i = 0; i < q; ++i) {
+                // q*k mod N keeps the angle exact
+                const double theta = -2.0 * M_PI * double((long long)i * bins_[j] % n_) / n_;
+                tw_[2 * (j * q + i)] = T(cos(theta) / n_);
+                tw_[2 * (j * q + i) + 1] = T(sin(theta) / n_);
+            }
+        }
+    }
+
+    // The recurrences run over segments of kGoertzelSegment samples whose
+    // sums are rotated into place: the rounding error of a Goertzel sum
+    // grows with the square of its length, which over all of N is too much
+    // for single precision.
+    void run_goertzel(const T* x, T* y) const {
+        const int w = 2 * kern_.lanes;
+        const size_t count = bins_.size();
+        T* state = thread_scratch<T>(4 * size_t(groups_) * w + 2 * count);
+        T* ph = state + 4 * size_t(groups_) * w;  // e^(-iw*end) of the segment
+        for (size_t b = 0; b < count; ++b) {
+            ph[2 * b] = T(1);
+            ph[2 * b + 1] = T(0);
+            y[2 * b] = y[2 * b + 1] = T(0);
+        }
+        for (int start = 0; start < n_; start += kGoertzelSegment) {
+            const int len = std::min(kGoertzelSegment, n_ - start);
+            kern_.goertzel(len, x + 2 * ptrdiff_t(start), groups_, coef_.data(), state);
+            const bool last = start + len == n_;  // e^(-iw*N) = 1
+            for (size_t b = 0; b < count; ++b) {
+                const T* st = state + 4 * (b / w) * w + b % w;
+                const T* r = rot_.data() + 4 * b;
+                T* p = ph + 2 * b;
+                if (!last) {
+                    const T pr = p[0] * r[2] - p[1] * r[3];
+                    p[1] = p[0] * r[3] + p[1] * r[2];
+                    p[0] = pr;
+                }
+                const T pr = last ? T(1) : p[0], pi = last ? T(0) : p[1];
+                // The segment sum is e^(-iw*end) (e^(iw) s1 - s2)
+                const T zr = r[0] * st[0] - r[1] * st[w] - st[2 * w];
+                const T zi = r[0] * st[w] + r[1] * st[0] - st[3 * w];
+                y[2 * b] += zr * pr - zi * pi;
+                y[2 * b + 1] += zr * pi + zi * pr;
+            }
+        }
+        const T f = T(1) / n_;
+        for (size_t b = 0; b < 2 * count; ++b) y[b] *= f;
+    }
+
+    void run_pruned(const T* x, T* y) const {
+        const int q = n_ / p_;
+        T* buf = thread_scratch<T>(6 * size_t(n_) + 2 * size_t(q));
+        T* work = buf + 2 * size_t(n_);
+        T* acc = work + 2 * size_t(n_);
+        // x[p*Q + q] is element p of transform q: the batch layout
+        std::copy(x, x + 2 * size_t(n_), buf);
+        kern_.fwd_batch(*plan_, q, buf, work, T(1));
+        for (size_t j = 0; j < bins_.size(); ++j) {
+            std::fill(acc, acc + 2 * q, T(0));
+            kern_.cmac(q, buf + 2 * size_t(bins_[j] % p_) * q, tw_.data() + 2 * j * q, acc);
+            T re = 0, im = 0;
+            for (int i = 0; i < q; ++i) {
+                re += acc[2 * i];
+                im += acc[2 * i + 1];
+            }
+            y[2 * j] = re;
+            y[2 * j + 1] = im;
+        }
+    }
+
+    void run_full(const T* x, T* y) const {
+        const T scale = T(1) / n_;
+        T* out;
+        if (chirp_) {
+            out = thread_scratch<T>(2 * size_t(n_) + 4 * size_t(chirp_->conv_size()));
+            chirp_->template run<false>(kern_, x, out, out + 2 * size_t(n_), scale);
+        } else {
+            out = thread_scratch<T>(4 * size_t(n_));
+            kern_.fwd(*plan_, x, out, out + 2 * size_t(n_), scale);
+        }
+        for (size_t j = 0; j < bins_.size(); ++j) {
+            y[2 * j] = out[2 * bins_[j]];
+            y[2 * j + 1] = out[2 * bins_[j] + 1];
+        }
+    }
+
+public:
+    PartialFFTImpl(int n, const int* bins, int count, PartialMethod method, const KernelTable<T>& kern)
+        : kern_(kern), n_(n), bins_(bins, bins + std::max(count, 0)), method_(method), groups_(0), p_(0) {
+        if (n < 1 || count < 1) {
+            throw std::invalid_argument("OTFFT ext: partial FFT needs a size and at least one bin");
+        }
+        for (int k : bins_) {
+            if (k < 0 || k >= n) {
+                throw std::invalid_argument("OTFFT ext: partial FFT bin out of range");
+            }
+        }
+        const int w = 2 * kern.lanes;
+        int p = pruned_factor(n, count, w);
+        if (method_ == PARTIAL_AUTO) {
+            const double full = full_fft_cost(n, w);
+            const double goertzel = goertzel_cost(n, count, w);
+            const double pruned = p ? pruned_cost(n, p, count, w) : full;
+            method_ = goertzel <= std::min(full, pruned) ? PARTIAL_GOERTZEL
+                    : pruned < full ? PARTIAL_PRUNED : PARTIAL_FULL;
+        }
+        if (method_ == PARTIAL_PRUNED && !p) {
+            throw std::invalid_argument("OTFFT ext: partial FFT size has no factor for pruning");
+        }
+        if (method_ == PARTIAL_GOERTZEL) init_goertzel();
+        else if (method_ == PARTIAL_PRUNED) init_pruned(p);
+        else if (is_smooth(n)) plan_ = PlanCache::instance().complex_plan<T>(n, kern);
+        else chirp_ = PlanCache::instance().bluestein_plan<T>(n, kern);
+    }
+
+    int size() const override { return n_; }
+    int bins() const override { return int(bins_.size()); }
+    int bin(int j) const override { return bins_[j]; }
+    PartialMethod method() const override { return method_; }
+
+    void fwd(const C* x, C* y) const override {
+        const T* in = reinterpret_cast<const T*>(x);
+        T* out = reinterpret_cast<T*>(y);
+        if (method_ == PARTIAL_GOERTZEL) run_goertzel(in, out);
+        else if (method_ == PARTIAL_PRUNED) run_pruned(in, out);
+        else run_full(in, out);
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// bins: count bin indices in [0, n), copied
+inline PartialFFTPtr createPartialFFT(int n, const int* bins, int count, PartialMethod method = PARTIAL_AUTO)
+{
+    return PartialFFTPtr(new detail::PartialFFTImpl<complex_t>(n, bins, count, method,
+                                                               detail::active_kernels<double>()));
+}
+
+inline PartialFFTfPtr createPartialFFTf(int n, const int* bins, int count, PartialMethod method = PARTIAL_AUTO)
+{
+    return PartialFFTfPtr(new detail::PartialFFTImpl<complexf_t>(n, bins, count, method,
+                                                                 detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_PARTIAL_H
@@ -0,0 +1,370 @@
+#ifndef OTFFT_EXT_PIPELINE_H
+#define OTFFT_EXT_PIPELINE_H
+
+// Real-time block pipeline: an acquisition thread hands in blocks of
+// samples, a dedicated transform thread turns them into spectra, and an
+// analysis thread reads the spectra, with no lock and no allocation after
+// construction.
+//
+// All blocks live in one ring of capacity() preallocated slots. A slot
+// holds an input block and the spectrum made from it, each 64-byte aligned,
+// and moves through three counters, each advanced by only one thread:
+//   submitted    producer: acquire_input(), fill, submit_input()
+//   transformed  transform thread: input -> spectrum, in place in the slot
+//   released     consumer: acquire_spectrum(), read, release_spectrum()
+// The counters sit on separate cache lines, and the producer and consumer
+// keep a private copy of the counter they wait on, so they touch the other
+// side's line only when the ring looks full or empty. Nothing is copied:
+// the producer writes into the slot, the transform reads from it and
+// writes the spectrum next to it, and the consumer reads it there.
+//
+// The transform thread is started by the constructor, optionally pinned to
+// one CPU (Linux), and runs one transform before the constructor returns
+// so that its scratch buffers are allocated up front. While idle it spins
+// with a pause instruction, then yields (at once on a single CPU), and
+// never sleeps on a lock.
+// When the ring is full, acquire_input() returns nullptr instead of
+// blocking the producer; overruns() counts those calls. Real pipelines
+// (RealFFT, N/2+1 bins) take even 7-smooth sizes, and complex ones
+// (ComplexFFT, N bins) take 7-smooth sizes. Spectra are normalized by 1/N
+// like fwd() of the other transforms.
+//
+//   auto p = OTFFT::FactoryExt::createRealFFTPipeline(4096, 8, 3);  // thread on CPU 3
+//   // acquisition thread
+//   if (double* x = p->acquire_input()) { read_adc(x, 4096); p->submit_input(); }
+//   // analysis thread
+//   OTFFT::PipelineBlock info;
+//   const OTFFT::complex_t* y = p->wait_spectrum(&info);  // 2049 bins
+//   use(y);
+//   p->release_spectrum();
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+enum PipelineTransform {
+    PIPELINE_REAL,     // N reals in, N/2+1 bins out
+    PIPELINE_COMPLEX   // N complex values in, N bins out
+};
+
+// Bookkeeping of one block, in steady_clock nanoseconds
+struct PipelineBlock {
+    unsigned long long sequence;  // 0, 1, 2, ... in submission order
+    long long submitted_ns;       // submit_input()
+    long long transformed_ns;     // spectrum written
+};
+
+template <typename C>
+class BasicFFTPipeline {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicFFTPipeline() {}
+    virtual int size() const = 0;
+    virtual PipelineTransform transform() const = 0;
+    // Blocks in flight at most
+    virtual int capacity() const = 0;
+    // Scalars of an input block: N reals, or N interleaved {Re, Im} pairs
+    virtual int input_length() const = 0;
+    // Values of a spectrum: N/2+1 or N
+    virtual int bins() const = 0;
+    // False if the transform thread could not be pinned to the CPU asked for
+    virtual bool pinned() const = 0;
+
+    // Producer thread only. The next free input block, or nullptr if all
+    // capacity() blocks are in flight
+    virtual real_type* acquire_input() = 0;
+    // Hands the block from acquire_input() to the transform thread
+    virtual void submit_input() = 0;
+    // acquire_input() calls that found the ring full
+    virtual unsigned long long overruns() const = 0;
+
+    // Consumer thread only. The oldest spectrum not yet released, or
+    // nullptr if none is ready; valid until release_spectrum()
+    virtual const C* acquire_spectrum(PipelineBlock* info = nullptr) = 0;
+    // The same, waiting (spinning, then yielding) until one is ready
+    virtual const C* wait_spectrum(PipelineBlock* info = nullptr) = 0;
+    // Returns the slot of the spectrum from acquire_spectrum() to the ring
+    virtual void release_spectrum() = 0;
+};
+
+typedef BasicFFTPipeline<complex_t> FFTPipeline;
+typedef BasicFFTPipeline<complexf_t> FFTPipelinef;
+
+typedef std::unique_ptr<FFTPipeline> FFTPipelinePtr;
+typedef std::unique_ptr<FFTPipelinef> FFTPipelinefPtr;
+
+namespace detail {
+
+// Busy-wait hint: lets the sibling hyperthread run and saves power
+inline void cpu_relax()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __asm__ __volatile__("pause");
+#elif defined(_M_X64)
+    _mm_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Checks of an empty or full ring before a waiting thread yields its CPU;
+// none on a single CPU, where spinning only delays the thread waited for
+static const int kPipelineSpins = 4096;
+
+inline int pipeline_spins()
+{
+    static const int spins = std::thread::hardware_concurrency() == 1 ? 0 : kPipelineSpins;
+    return spins;
+}
+
+inline long long steady_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Pins the calling thread to one CPU; false where that is not supported
+inline bool pin_current_thread(int cpu)
+{
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// A counter alone on its cache line
+struct alignas(kAlign) PipelineCounter {
+    std::atomic<unsigned long long> value;
+
+    PipelineCounter() : value(0) {}
+};
+static_assert(sizeof(PipelineCounter) == kAlign, "OTFFT ext: PipelineCounter must fill one cache line");
+
+template <typename C>
+class FFTPipelineImpl : public BasicFFTPipeline<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    PipelineTransform transform_;
+    int n_;
+    int capacity_;            // a power of two
+    int cpu_;
+    std::shared_ptr<const RealPlan<T>> real_plan_;
+    std::shared_ptr<const StockhamPlan<T>> complex_plan_;
+    size_t input_stride_;     // scalars per input block, rounded up to kAlign
+    size_t output_stride_;    // scalars per spectrum, rounded up to kAlign
+    AlignedBuffer<T> inputs_;
+    AlignedBuffer<T> outputs_;
+    AlignedBuffer<PipelineBlock> blocks_;
+
+    PipelineCounter submitted_;
+    PipelineCounter transformed_;
+    PipelineCounter released_;
+    PipelineCounter overruns_;
+    // Polled by the worker while it spins, so on a line the producer and
+    // consumer never write
+    alignas(kAlign) std::atomic<bool> stop_;
+    std::atomic<int> started_;  // 0 starting, 1 pinned, -1 not pinned
+
+    // Producer side: its next block, and the last released count it saw
+    alignas(kAlign) unsigned long long produce_;
+    unsigned long long released_seen_;
+    // Consumer side: its next block, and the last transformed count it saw
+    alignas(kAlign) unsigned long long consume_;
+    unsigned long long transformed_seen_;
+
+    std::thread worker_;
+
+    size_t slot(unsigned long long i) const { return size_t(i & (capacity_ - 1)); }
+    T* input(size_t s) { return inputs_.data() + s * input_stride_; }
+    T* output(size_t s) { return outputs_.data() + s * output_stride_; }
+
+    void run_transform(size_t s) {
+        if (transform_ == PIPELINE_REAL) {
+            real_plan_->fwd(kern_, input(s), output(s), thread_scratch<T>(size_t(n_)), false);
+        } else {
+            kern_.fwd(*complex_plan_, input(s), output(s), thread_scratch<T>(2 * size_t(n_)), T(1) / T(n_));
+        }
+    }
+
+    void worker() {
+        const bool pinned = cpu_ >= 0 && pin_current_thread(cpu_);
+        // Allocates this thread's scratch before anything is timed
+        run_transform(0);
+        started_.store(pinned || cpu_ < 0 ? 1 : -1);
+        const int max_spins = pipeline_spins();
+        unsigned long long next = 0;
+        while (true) {
+            int spins = 0;
+            while (submitted_.value.load(std::memory_order_acquire) == next) {
+                if (stop_.load(std::memory_order_relaxed)) return;
+                if (++spins < max_spins) cpu_relax();
+                else std::this_thread::yield();
+            }
+            const size_t s = slot(next);
+            run_transform(s);
+            blocks_[s].transformed_ns = steady_ns();
+            transformed_.value.store(++next, std::memory_order_release);
+        }
+    }
+
+public:
+    // Before C++17 new only aligns to alignof(std::max_align_t), which would
+    // let the counters straddle cache lines
+    static void* operator new(size_t bytes) { return aligned_malloc(bytes); }
+    static void operator delete(void* p) { aligned_free(p); }
+
+    FFTPipelineImpl(PipelineTransform transform, int n, int capacity, int cpu, const KernelTable<T>& kern)
+        : kern_(kern), transform_(transform), n_(n), capacity_(1), cpu_(cpu), input_stride_(0),
+          output_stride_(0), stop_(false), started_(0), produce_(0), released_seen_(0), consume_(0),
+          transformed_seen_(0) {
+        if (capacity < 1 || capacity > (1 << 16)) {
+            throw std::invalid_argument("OTFFT ext: pipeline capacity must be from 1 to 65536 blocks");
+        }
+        while (capacity_ < capacity) capacity_ *= 2;
+        size_t in_len, out_len;
+        if (transform == PIPELINE_REAL) {
+            real_plan_ = PlanCache::instance().real_plan<T>(n, kern);
+            in_len = size_t(n);
+            out_len = 2 * (size_t(n) / 2 + 1);
+        } else {
+            complex_plan_ = PlanCache::instance().complex_plan<T>(n, kern);
+            in_len = out_len = 2 * size_t(n);
+        }
+        const size_t per_line = kAlign / sizeof(T);
+        input_stride_ = (in_len + per_line - 1) / per_line * per_line;
+        output_stride_ = (out_len + per_line - 1) / per_line * per_line;
+        inputs_ = AlignedBuffer<T>(input_stride_ * capacity_);
+        outputs_ = AlignedBuffer<T>(output_stride_ * capacity_);
+        blocks_ = AlignedBuffer<PipelineBlock>(size_t(capacity_));
+        // Touch every page now rather than on the first blocks
+        for (size_t i = 0; i < inputs_.size(); ++i) inputs_[i] = T(0);
+        for (size_t i = 0; i < outputs_.size(); ++i) outputs_[i] = T(0);
+        for (int s = 0; s < capacity_; ++s) blocks_[s] = PipelineBlock();
+        worker_ = std::thread(&FFTPipelineImpl::worker, this);
+        while (started_.load() == 0) std::this_thread::yield();
+    }
+
+    ~FFTPipelineImpl() {
+        stop_.store(true);
+        worker_.join();
+    }
+
+    FFTPipelineImpl(const FFTPipelineImpl&) = delete;
+    FFTPipelineImpl& operator=(const FFTPipelineImpl&) = delete;
+
+    int size() const override { return n_; }
+    PipelineTransform transform() const override { return transform_; }
+    int capacity() const override { return capacity_; }
+    int input_length() const override { return transform_ == PIPELINE_REAL ? n_ : 2 * n_; }
+    int bins() const override { return transform_ == PIPELINE_REAL ? n_ / 2 + 1 : n_; }
+    bool pinned() const override { return started_.load() > 0 && cpu_ >= 0; }
+
+    T* acquire_input() override {
+        if (produce_ - released_seen_ == (unsigned long long)capacity_) {
+            released_seen_ = released_.value.load(std::memory_order_acquire);
+            if (produce_ - released_seen_ == (unsigned long long)capacity_) {
+                overruns_.value.store(overruns_.value.load(std::memory_order_relaxed) + 1,
+                                      std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return input(slot(produce_));
+    }
+
+    void submit_input() override {
+        PipelineBlock& b = blocks_[slot(produce_)];
+        b.sequence = produce_;
+        b.submitted_ns = steady_ns();
+        submitted_.value.store(++produce_, std::memory_order_release);
+    }
+
+    unsigned long long overruns() const override { return overruns_.value.load(std::memory_order_relaxed); }
+
+    const C* acquire_spectrum(PipelineBlock* info) override {
+        if (consume_ == transformed_seen_) {
+            transformed_seen_ = transformed_.value.load(std::memory_order_acquire);
+            if (consume_ == transformed_seen_) return nullptr;
+        }
+        const size_t s = slot(consume_);
+        if (info) *info = blocks_[s];
+        return reinterpret_cast<const C*>(output(s));
+    }
+
+    const C* wait_spectrum(PipelineBlock* info) override {
+        const int max_spins = pipeline_spins();
+        for (int spins = 0;; ++spins) {
+            if (const C* y = acquire_spectrum(info)) return y;
+            if (spins < max_spins) cpu_relax();
+            else std::this_thread::yield();
+        }
+    }
+
+    void release_spectrum() override {
+        released_.value.store(++consume_, std::memory_order_release);
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// capacity: blocks in flight, rounded up to a power of two; cpu: CPU to pin
+// the transform thread to, or -1 to leave it unpinned
+inline FFTPipelinePtr createRealFFTPipeline(int n, int capacity = 8, int cpu = -1)
+{
+    return FFTPipelinePtr(new detail::FFTPipelineImpl<complex_t>(PIPELINE_REAL, n, capacity, cpu,
+                                                                 detail::active_kernels<double>()));
+}
+
+inline FFTPipelinefPtr createRealFFTPipelinef(int n, int capacity = 8, int cpu = -1)
+{
+    return FFTPipelinefPtr(new detail::FFTPipelineImpl<complexf_t>(PIPELINE_REAL, n, capacity, cpu,
+                                                                   detail::active_kernels<float>()));
+}
+
+inline FFTPipelinePtr createComplexFFTPipeline(int n, int capacity = 8, int cpu = -1)
+{
+    return FFTPipelinePtr(new detail::FFTPipelineImpl<complex_t>(PIPELINE_COMPLEX, n, capacity, cpu,
+                                                                 detail::active_kernels<double>()));
+}
+
+inline FFTPipelinefPtr createComplexFFTPipelinef(int n, int capacity = 8, int cpu = -1)
+{
+    return FFTPipelinefPtr(new detail::FFTPipelineImpl<complexf_t>(PIPELINE_COMPLEX, n, capacity, cpu,
+                                                                   detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_PIPELINE_H
@@ -0,0 +1,241 @@
+#ifndef OTFFT_EXT_PLAN_CACHE_H
+#define OTFFT_EXT_PLAN_CACHE_H
+
+// Process-wide cache of immutable FFT plans.
+//
+// Plans are keyed by (kind, size, precision, kernel layout) and handed out as
+// shared_ptr<const ...>, so creating a transform for a size that was seen
+// before is a map lookup instead of a twiddle-table build. Plans hold no
+// scratch: every thread executes them with its own thread-local work buffer.
+// The cache keeps at most max_entries plans / max_bytes of twiddle data and
+// evicts the least recently used plan beyond that; an evicted plan stays
+// alive for as long as objects still reference it.
+// The per-thread work buffers are not plans and the limits do not cover
+// them: each keeps the largest size its thread has run until trim_scratch()
+// (or clear()), after which it shrinks to what its next call needs.
+//
+//   OTFFT::PlanCache::instance().set_limits(32, 16 << 20);
+//   OTFFT::PlanCache::Stats st = OTFFT::PlanCache::instance().stats();
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "detail/aligned.h"
+#include "detail/bluestein.h"
+#include "detail/real.h"
+#include "detail/roots.h"
+#include "detail/split_plan.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+namespace detail {
+
+// Bumped by PlanCache::trim_scratch(); a thread_scratch buffer that sees a
+// new value shrinks to the size it is asked for
+inline std::atomic<unsigned>& scratch_generation()
+{
+    static std::atomic<unsigned> generation(0);
+    return generation;
+}
+
+} // namespace detail
+
+class PlanCache {
+public:
+    enum Kind { COMPLEX, REAL, SPLIT, BLUESTEIN, ROOTS };
+
+    struct Stats {
+        size_t hits;
+        size_t misses;
+        size_t evictions;
+        size_t entries;
+        size_t bytes;  // twiddle bytes held by the cache
+    };
+
+    static PlanCache& instance() {
+        static PlanCache cache;
+        return cache;
+    }
+
+    // Complex plan of size n laid out for the given kernel set
+    template <typename T>
+    std::shared_ptr<const detail::StockhamPlan<T>> complex_plan(int n, const detail::KernelTable<T>& kern) {
+        return get<detail::StockhamPlan<T> >(Key(COMPLEX, n, sizeof(T), kern.lanes, kern.max_radix));
+    }
+
+    // Real plan of size n (a complex plan of size n/2 plus split twiddles)
+    template <typename T>
+    std::shared_ptr<const detail::RealPlan<T>> real_plan(int n, const detail::KernelTable<T>& kern) {
+        return get<detail::RealPlan<T> >(Key(REAL, n, sizeof(T), kern.lanes, kern.max_radix));
+    }
+
+    // Split-complex plan of size n (a complex plan plus expanded early-stage
+    // twiddles)
+    template <typename T>
+    std::shared_ptr<const detail::SplitPlan<T>> split_plan(int n, const detail::KernelTable<T>& kern) {
+        return get<detail::SplitPlan<T> >(Key(SPLIT, n, sizeof(T), kern.lanes, kern.max_radix));
+    }
+
+    // Bluestein plan of size n (a power-of-two complex plan of at least
+    // 2n-1 points plus the chirp tables)
+    template <typename T>
+    std::shared_ptr<const detail::BluesteinPlan<T>> bluestein_plan(int n, const detail::KernelTable<T>& kern) {
+        return get<detail::BluesteinPlan<T> >(Key(BLUESTEIN, n, sizeof(T), kern.lanes, kern.max_radix));
+    }
+
+    // Table of the n-th roots of unity, shared by every kernel set
+    template <typename T>
+    std::shared_ptr<const detail::RootTable<T>> root_table(int n) {
+        return get<detail::RootTable<T> >(Key(ROOTS, n, sizeof(T), 0, 0));
+    }
+
+    // Zero disables the corresponding limit; both 0 turn caching off.
+    void set_limits(size_t max_entries, size_t max_bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_entries_ = max_entries;
+        max_bytes_ = max_bytes;
+        evict();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats st = { hits_, misses_, evictions_, entries_.size(), bytes_ };
+        return st;
+    }
+
+    void reset_stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hits_ = misses_ = evictions_ = 0;
+    }
+
+    // Also trims the per-thread scratch
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        lru_.clear();
+        bytes_ = 0;
+        trim_scratch();
+    }
+
+    // Every thread's scratch shrinks to what its next transform needs. A
+    // thread that runs none keeps its buffers until it exits.
+    static void trim_scratch() {
+        detail::scratch_generation().fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    struct Key {
+        int kind;
+        int n;
+        int precision;  // sizeof the scalar type
+        int lanes;
+        int radix;  // max_radix of the kernel set
+
+        Key(Kind k, int size, size_t prec, int l, int r)
+            : kind(k), n(size), precision(int(prec)), lanes(l), radix(r) {}
+        bool operator<(const Key& o) const {
+            if (kind != o.kind) return kind < o.kind;
+            if (n != o.n) return n < o.n;
+            if (precision != o.precision) return precision < o.precision;
+            if (lanes != o.lanes) return lanes < o.lanes;
+            return radix < o.radix;
+        }
+    };
+
+    struct Entry {
+        std::shared_ptr<const void> plan;
+        size_t bytes;
+        std::list<Key>::iterator lru;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+    std::list<Key> lru_;  // most recently used first
+    size_t max_entries_;
+    size_t max_bytes_;
+    size_t bytes_;
+    size_t hits_;
+    size_t misses_;
+    size_t evictions_;
+
+    PlanCache()
+        : max_entries_(64), max_bytes_(64 << 20), bytes_(0), hits_(0), misses_(0), evictions_(0) {}
+    PlanCache(const PlanCache&) = delete;
+    PlanCache& operator=(const PlanCache&) = delete;
+
+    template <typename P>
+    std::shared_ptr<const P> get(const Key& key) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::map<Key, Entry>::iterator it = entries_.find(key);
+            if (it != entries_.end()) {
+                ++hits_;
+                lru_.splice(lru_.begin(), lru_, it->second.lru);
+                return std::static_pointer_cast<const P>(it->second.plan);
+            }
+            ++misses_;
+        }
+
+        // Build outside the lock so that a large plan does not stall lookups
+        // of other sizes; if two threads race, the first insert wins.
+        std::shared_ptr<const P> plan = std::make_shared<P>(key.n, key.lanes, key.radix);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<Key, Entry>::iterator it = entries_.find(key);
+        if (it != entries_.end()) {
+            return std::static_pointer_cast<const P>(it->second.plan);
+        }
+        if (max_entries_ == 0 && max_bytes_ == 0) return plan;
+        lru_.push_front(key);
+        Entry e = { plan, plan->twiddle_bytes(), lru_.begin() };
+        entries_.insert(std::make_pair(key, e));
+        bytes_ += e.bytes;
+        evict();
+        return plan;
+    }
+
+    // Called with mutex_ held
+    void evict() {
+        while (!lru_.empty() &&
+               ((max_entries_ && entries_.size() > max_entries_) ||
+                (max_bytes_ && bytes_ > max_bytes_) ||
+                (!max_entries_ && !max_bytes_))) {
+            std::map<Key, Entry>::iterator it = entries_.find(lru_.back());
+            bytes_ -= it->second.bytes;
+            entries_.erase(it);
+            lru_.pop_back();
+            ++evictions_;
+        }
+    }
+};
+
+namespace detail {
+
+// Per-thread scratch for executing shared plans. The buffer only grows
+// until PlanCache::trim_scratch(), and stays valid until the next call from
+// the same thread with the same Slot; a caller that must keep a buffer
+// across kernel calls (which use slot 0) takes another slot.
+template <typename T, int Slot = 0>
+inline T* thread_scratch(size_t count)
+{
+    static thread_local AlignedBuffer<T> buf;
+    static thread_local unsigned generation = 0;
+    const unsigned current = scratch_generation().load(std::memory_order_relaxed);
+    if (generation != current) {
+        generation = current;
+        if (buf.size() > count) buf.resize(count);
+    }
+    if (buf.size() < count) buf.resize(count);
+    return buf.data();
+}
+
+} // namespace detail
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_PLAN_CACHE_H
@@ -0,0 +1,105 @@
+#ifndef OTFFT_EXT_REAL_COMPACT_H
+#define OTFFT_EXT_REAL_COMPACT_H
+
+// Real transforms that store only the non-redundant half of the spectrum.
+//
+// Upstream RealFFT (and RealFFTf) write all N bins, the upper half being
+// the conjugate mirror of the lower one. These objects write and read only
+// what FFTW's r2c/c2r and MKL's CCE format hold:
+//   HALF_SPECTRUM    N/2+1 bins, X[0] .. X[N/2]
+//   PACKED_NYQUIST   N/2 values, X[0] .. X[N/2-1] with the (real) Nyquist
+//                    bin X[N/2] stored in the imaginary part of the (real)
+//                    DC bin, the layout of pffft, IPP "Perm" and vDSP
+//
+// fwd() is normalized by 1/N and inv() is unnormalized, as for RealFFT.
+// inv() only reads the spectrum. Sizes must be even, with no prime factor
+// above 7.
+//
+//   auto rfft = OTFFT::FactoryExt::createCompactRealFFT(N);
+//   std::vector<OTFFT::complex_t> spectrum(rfft->bins());   // N/2+1
+//   rfft->fwd(x, spectrum.data());
+
+#include <memory>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+
+namespace OTFFT {
+
+enum RealSpectrumLayout { HALF_SPECTRUM, PACKED_NYQUIST };
+
+template <typename C>
+class BasicCompactRealFFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicCompactRealFFT() {}
+    virtual int size() const = 0;
+    virtual RealSpectrumLayout layout() const = 0;
+    // Complex values in a spectrum: N/2+1, or N/2 when packed
+    virtual int bins() const = 0;
+
+    // x: N reals -> y: bins() values
+    virtual void fwd(const real_type* x, C* y) const = 0;
+    // y: bins() values (only read) -> x: N reals
+    virtual void inv(const C* y, real_type* x) const = 0;
+};
+
+typedef BasicCompactRealFFT<complex_t> CompactRealFFT;
+typedef BasicCompactRealFFT<complexf_t> CompactRealFFTf;
+
+typedef std::unique_ptr<CompactRealFFT> CompactRealFFTPtr;
+typedef std::unique_ptr<CompactRealFFTf> CompactRealFFTfPtr;
+
+namespace detail {
+
+template <typename C>
+class CompactRealFFTImpl : public BasicCompactRealFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+    RealSpectrumLayout layout_;
+
+public:
+    CompactRealFFTImpl(int n, RealSpectrumLayout layout, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().real_plan<T>(n, kern)), layout_(layout) {}
+
+    int size() const override { return plan_->size(); }
+    RealSpectrumLayout layout() const override { return layout_; }
+    int bins() const override { return layout_ == PACKED_NYQUIST ? size() / 2 : size() / 2 + 1; }
+
+    void fwd(const T* x, C* y) const override {
+        plan_->fwd(kern_, x, reinterpret_cast<T*>(y), thread_scratch<T>(size_t(size())),
+                   layout_ == PACKED_NYQUIST);
+    }
+
+    void inv(const C* y, T* x) const override {
+        plan_->inv(kern_, reinterpret_cast<const T*>(y), x, thread_scratch<T>(size_t(size())),
+                   layout_ == PACKED_NYQUIST);
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline CompactRealFFTPtr createCompactRealFFT(int n, RealSpectrumLayout layout = HALF_SPECTRUM)
+{
+    return CompactRealFFTPtr(new detail::CompactRealFFTImpl<complex_t>(n, layout, detail::active_kernels<double>()));
+}
+
+inline CompactRealFFTfPtr createCompactRealFFTf(int n, RealSpectrumLayout layout = HALF_SPECTRUM)
+{
+    return CompactRealFFTfPtr(new detail::CompactRealFFTImpl<complexf_t>(n, layout, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_REAL_COMPACT_H
@@ -0,0 +1,240 @@
+#ifndef OTFFT_EXT_SLIDING_DFT_H
+#define OTFFT_EXT_SLIDING_DFT_H
+
+// Sliding DFT of a real signal: selected bins of the spectrum of the last N
+// samples, updated per sample in O(bins) instead of an O(N log N) transform
+// per hop.
+//
+// The textbook recursion X_k <- W^-k (X_k + x_new - x_old) turns every bin
+// by a rounded twiddle once per sample, so its errors compound without
+// bound. This is the modulated form instead: each bin accumulates
+// (x_new - x_old) W^(k*t) for the absolute sample index t, and the output is
+// demodulated by W^(-k*t) when read. The twiddle rows W^(k*t) advance by one
+// complex multiply per sample in the SIMD kernels and are reloaded exactly
+// from the shared table of N-th roots every kSlidingRefresh samples, so
+// only the additive rounding of the accumulators remains (a random walk).
+// A damping factor r < 1 makes that decay as well: sample t samples old
+// then weighs r^t, a window that tapers to r^(N-1) at its far end.
+//
+// process() takes chunks of any length and writes the bins after every hop
+// samples, normalized by 1/N like RealFFT; before N samples have arrived
+// the missing ones count as zero. Like STFT, the object carries stream
+// state and does not allocate after construction.
+//
+//   auto sdft = OTFFT::FactoryExt::createSlidingDFT(4096, 16);  // bins 0..N/2
+//   std::vector<OTFFT::complex_t> frames(sdft->frame_count(len) * sdft->bins());
+//   int k = sdft->process(chunk, len, frames.data());
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/complex_traits.h"
+#include "detail/roots.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicSlidingDFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicSlidingDFT() {}
+    virtual int size() const = 0;  // window length N
+    virtual int hop() const = 0;
+    virtual int bins() const = 0;
+    virtual int bin(int j) const = 0;
+    virtual double damping() const = 0;
+
+    // Number of spectra the next process() of count samples will write
+    virtual int frame_count(int count) const = 0;
+    // Appends count samples and writes frame_count(count) spectra of bins()
+    // values each to frames; returns that number
+    virtual int process(const real_type* in, int count, C* frames) = 0;
+    // The bins of the last size() samples as of now, between hops
+    virtual void spectrum(C* out) const = 0;
+    // Forgets the samples seen so far
+    virtual void reset() = 0;
+};
+
+typedef BasicSlidingDFT<complex_t> SlidingDFT;
+typedef BasicSlidingDFT<complexf_t> SlidingDFTf;
+
+typedef std::unique_ptr<SlidingDFT> SlidingDFTPtr;
+typedef std::unique_ptr<SlidingDFTf> SlidingDFTfPtr;
+
+namespace detail {
+
+static const int kSlidingRefresh = 64;
+
+template <typename C>
+class SlidingDFTImpl : public BasicSlidingDFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    int n_;
+    int hop_;
+    double damping_;
+    T r_;
+    T rn_;                 // r^N of the rounded r: weight of the sample leaving
+    std::vector<int> bins_;
+    int padded_;           // bins rounded up to whole vectors
+    std::shared_ptr<const RootTable<T>> roots_;
+    AlignedBuffer<T> ring_;   // the last N samples
+    AlignedBuffer<T> step_;   // W^k per bin
+    AlignedBuffer<T> row_;    // W^(k*t) for the next sample t
+    AlignedBuffer<T> acc_;    // modulated sums
+    AlignedBuffer<T> d_;      // x_new - r^N x_old of one kernel call
+    int pos_;                 // next sample index mod N
+    int phase_;               // samples since the last spectrum
+    int fresh_;               // samples since the rows were reloaded
+
+    void load_rows() {
+        for (size_t b = 0; b < bins_.size(); ++b) {
+            const T* w = roots_->at((long long)bins_[b] * pos_);
+            row_[2 * b] = w[0];
+            row_[2 * b + 1] = w[1];
+        }
+    }
+
+public:
+    SlidingDFTImpl(int n, const int* bins, int count, int hop, double damping, const KernelTable<T>& kern)
+        : kern_(kern), n_(n), hop_(hop), damping_(damping), r_(T(damping)), rn_(T(std::pow(double(r_), n))),
+          bins_(bins, bins + std::max(count, 0)), padded_(0), pos_(0), phase_(0), fresh_(0) {
+        if (n < 1 || count < 1 || hop < 1) {
+            throw std::invalid_argument("OTFFT ext: sliding DFT needs a size, a hop and at least one bin");
+        }
+        if (!(damping > 0.0 && damping <= 1.0)) {
+            throw std::invalid_argument("OTFFT ext: sliding DFT damping must be in (0, 1]");
+        }
+        for (int k : bins_) {
+            if (k < 0 || k >= n) {
+                throw std::invalid_argument("OTFFT ext: sliding DFT bin out of range");
+            }
+        }
+        roots_ = PlanCache::instance().root_table<T>(n);
+        padded_ = (count + kern.lanes - 1) / kern.lanes * kern.lanes;
+        ring_ = AlignedBuffer<T>(size_t(n));
+        step_ = AlignedBuffer<T>(2 * size_t(padded_));
+        row_ = AlignedBuffer<T>(2 * size_t(padded_));
+        acc_ = AlignedBuffer<T>(2 * size_t(padded_));
+        d_ = AlignedBuffer<T>(size_t(kSlidingRefresh));
+        // Padding bins turn by 1 and are never read
+        for (int b = 0; b < padded_; ++b) {
+            const T* w = roots_->at(b < count ? bins_[b] : 0);
+            step_[2 * b] = w[0];
+            step_[2 * b + 1] = w[1];
+        }
+        reset();
+    }
+
+    int size() const override { return n_; }
+    int hop() const override { return hop_; }
+    int bins() const override { return int(bins_.size()); }
+    int bin(int j) const override { return bins_[j]; }
+    double damping() const override { return damping_; }
+
+    int frame_count(int count) const override { return (phase_ + count) / hop_; }
+
+    int process(const T* in, int count, C* frames) override {
+        int written = 0;
+        while (count > 0) {
+            const int len = std::min(count, std::min(hop_ - phase_, kSlidingRefresh - fresh_));
+            for (int s = 0; s < len; ++s) {
+                d_[s] = in[s] - rn_ * ring_[pos_];
+                ring_[pos_] = in[s];
+                if (++pos_ == n_) pos_ = 0;
+            }
+            kern_.sliding(padded_, len, d_.data(), r_, step_.data(), row_.data(), acc_.data());
+            in += len;
+            count -= len;
+            fresh_ += len;
+            phase_ += len;
+            if (fresh_ == kSlidingRefresh) {
+                load_rows();
+                fresh_ = 0;
+            }
+            if (phase_ == hop_) {
+                spectrum(frames + size_t(written) * bins_.size());
+                ++written;
+                phase_ = 0;
+            }
+        }
+        return written;
+    }
+
+    // X_k = W^(-k*t) acc_k / N for the next sample index t, where W^(k*t)
+    // is the current row (at most kSlidingRefresh products from exact)
+    void spectrum(C* out) const override {
+        T* y = scalars(out);
+        const T f = T(1) / n_;
+        const T* w = row_.data();
+        const T* a = acc_.data();
+        for (size_t i = 0; i < 2 * bins_.size(); i += 2) {
+            y[i] = (a[i] * w[i] + a[i + 1] * w[i + 1]) * f;
+            y[i + 1] = (a[i + 1] * w[i] - a[i] * w[i + 1]) * f;
+        }
+    }
+
+    void reset() override {
+        std::fill(ring_.data(), ring_.data() + ring_.size(), T(0));
+        std::fill(acc_.data(), acc_.data() + acc_.size(), T(0));
+        for (int b = 0; b < padded_; ++b) {
+            row_[2 * b] = T(1);
+            row_[2 * b + 1] = T(0);
+        }
+        pos_ = phase_ = fresh_ = 0;
+    }
+};
+
+// Bins 0..N/2, the non-redundant half of a real signal's spectrum
+inline std::vector<int> half_spectrum_bins(int n)
+{
+    std::vector<int> bins(std::max(n / 2 + 1, 0));
+    for (size_t k = 0; k < bins.size(); ++k) bins[k] = int(k);
+    return bins;
+}
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// bins: indices in [0, n); damping: r in (0, 1], 1 for the plain sliding DFT
+inline SlidingDFTPtr createSlidingDFT(int n, const int* bins, int count, int hop = 1, double damping = 1.0)
+{
+    return SlidingDFTPtr(new detail::SlidingDFTImpl<complex_t>(n, bins, count, hop, damping,
+                                                              detail::active_kernels<double>()));
+}
+
+inline SlidingDFTfPtr createSlidingDFTf(int n, const int* bins, int count, int hop = 1, double damping = 1.0)
+{
+    return SlidingDFTfPtr(new detail::SlidingDFTImpl<complexf_t>(n, bins, count, hop, damping,
+                                                                detail::active_kernels<float>()));
+}
+
+// All bins 0..n/2
+inline SlidingDFTPtr createSlidingDFT(int n, int hop = 1, double damping = 1.0)
+{
+    const std::vector<int> bins = detail::half_spectrum_bins(n);
+    return createSlidingDFT(n, bins.data(), int(bins.size()), hop, damping);
+}
+
+inline SlidingDFTfPtr createSlidingDFTf(int n, int hop = 1, double damping = 1.0)
+{
+    const std::vector<int> bins = detail::half_spectrum_bins(n);
+    return createSlidingDFTf(n, bins.data(), int(bins.size()), hop, damping);
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_SLIDING_DFT_H
@@ -0,0 +1,97 @@
+#ifndef OTFFT_EXT_SPLIT_H
+#define OTFFT_EXT_SPLIT_H
+
+// Complex transforms on split-format data: separate arrays of real and
+// imaginary parts instead of interleaved complex_t.
+//
+// The butterflies run on the split arrays directly. Each vector register
+// holds only real or only imaginary parts, so complex products need no
+// shuffles. There is no interleave before or deinterleave after the
+// transform. Plans come from the PlanCache like those of the interleaved
+// objects.
+//
+//   auto fft = OTFFT::FactoryExt::createSplitComplexFFT(N);
+//   fft->fwd(re, im);   // in place, normalized by 1/N like ComplexFFT
+
+#include <memory>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/complex_traits.h"
+#include "detail/split_plan.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicSplitComplexFFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicSplitComplexFFT() {}
+    virtual int size() const = 0;
+
+    // fwd is normalized by 1/N and inv is unnormalized, as for ComplexFFT.
+    // The output arrays may be the input arrays (in place).
+    virtual void fwd(const real_type* in_re, const real_type* in_im,
+                     real_type* out_re, real_type* out_im) const = 0;
+    virtual void inv(const real_type* in_re, const real_type* in_im,
+                     real_type* out_re, real_type* out_im) const = 0;
+
+    void fwd(real_type* re, real_type* im) const { fwd(re, im, re, im); }
+    void inv(real_type* re, real_type* im) const { inv(re, im, re, im); }
+};
+
+typedef BasicSplitComplexFFT<complex_t> SplitComplexFFT;
+typedef BasicSplitComplexFFT<complexf_t> SplitComplexFFTf;
+
+typedef std::unique_ptr<SplitComplexFFT> SplitComplexFFTPtr;
+typedef std::unique_ptr<SplitComplexFFTf> SplitComplexFFTfPtr;
+
+namespace detail {
+
+template <typename C>
+class SplitComplexFFTImpl : public BasicSplitComplexFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const SplitPlan<T>> plan_;
+
+public:
+    SplitComplexFFTImpl(int n, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().split_plan<T>(n, kern)) {}
+
+    int size() const override { return plan_->size(); }
+
+    using BasicSplitComplexFFT<C>::fwd;
+    using BasicSplitComplexFFT<C>::inv;
+
+    void fwd(const T* in_re, const T* in_im, T* out_re, T* out_im) const override {
+        const int n = size();
+        kern_.fwd_split(*plan_, in_re, in_im, out_re, out_im, thread_scratch<T>(2 * size_t(n)), T(1) / n);
+    }
+    void inv(const T* in_re, const T* in_im, T* out_re, T* out_im) const override {
+        kern_.inv_split(*plan_, in_re, in_im, out_re, out_im, thread_scratch<T>(2 * size_t(size())), T(1));
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline SplitComplexFFTPtr createSplitComplexFFT(int n)
+{
+    return SplitComplexFFTPtr(new detail::SplitComplexFFTImpl<complex_t>(n, detail::active_kernels<double>()));
+}
+
+inline SplitComplexFFTfPtr createSplitComplexFFTf(int n)
+{
+    return SplitComplexFFTfPtr(new detail::SplitComplexFFTImpl<complexf_t>(n, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_SPLIT_H
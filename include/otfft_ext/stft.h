@@ -0,0 +1,283 @@
+#ifndef OTFFT_EXT_STFT_H
+#define OTFFT_EXT_STFT_H
+
+// Streaming short-time Fourier transform of a real signal.
+//
+// STFT::process() takes chunks of any length, keeps the part of the stream
+// the next frame still needs in a ring buffer of N samples, and writes one
+// spectrum of N/2+1 bins (normalized by 1/N, like RealFFT) per hop of H
+// samples. The analysis window is applied while a frame is assembled from
+// the ring and the new chunk, so the FFT reads the windowed frame directly
+// instead of after separate copy and multiply passes. ISTFT::process()
+// inverts spectra and overlap-adds them with the synthesis window fused
+// into the accumulation, emitting H samples per spectrum; output sample t
+// is exact once every frame covering it was added, i.e. for t >= N - H.
+//
+// Neither object allocates after construction. They carry stream state, so
+// each stream needs its own object; plans still come from the PlanCache.
+//
+//   auto stft = OTFFT::FactoryExt::createSTFT(1024, 256);   // periodic Hann
+//   std::vector<OTFFT::complex_t> frames(stft->frame_count(len) * stft->bins());
+//   int k = stft->process(chunk, len, frames.data());
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/aligned.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+
+namespace OTFFT {
+
+template <typename C>
+class BasicSTFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicSTFT() {}
+    virtual int size() const = 0;  // frame length N
+    virtual int hop() const = 0;
+    int bins() const { return size() / 2 + 1; }
+
+    // Number of spectra the next process() of count samples will write
+    virtual int frame_count(int count) const = 0;
+    // Appends count samples and writes frame_count(count) spectra of bins()
+    // values each to frames; returns that number
+    virtual int process(const real_type* in, int count, C* frames) = 0;
+    // Forgets the buffered samples
+    virtual void reset() = 0;
+};
+
+template <typename C>
+class BasicISTFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicISTFT() {}
+    virtual int size() const = 0;
+    virtual int hop() const = 0;
+    int bins() const { return size() / 2 + 1; }
+
+    // Reads count spectra of bins() values and writes count*hop() samples
+    virtual void process(const C* frames, int count, real_type* out) = 0;
+    // Clears the overlap-add accumulator
+    virtual void reset() = 0;
+};
+
+typedef BasicSTFT<complex_t> STFT;
+typedef BasicSTFT<complexf_t> STFTf;
+typedef BasicISTFT<complex_t> ISTFT;
+typedef BasicISTFT<complexf_t> ISTFTf;
+
+typedef std::unique_ptr<STFT> STFTPtr;
+typedef std::unique_ptr<STFTf> STFTfPtr;
+typedef std::unique_ptr<ISTFT> ISTFTPtr;
+typedef std::unique_ptr<ISTFTf> ISTFTfPtr;
+
+namespace detail {
+
+inline void check_stft_hop(int n, int hop)
+{
+    if (hop < 1 || hop > n) {
+        throw std::invalid_argument("OTFFT ext: STFT hop must be between 1 and the frame size");
+    }
+}
+
+// Periodic Hann window, the default analysis window
+template <typename T>
+inline void hann_window(int n, T* w)
+{
+    for (int j = 0; j < n; ++j) w[j] = T(0.5 - 0.5 * cos(2.0 * M_PI * j / n));
+}
+
+// y[j] = w[j] * x[j]
+template <typename T>
+inline void window_copy(int m, const T* w, const T* x, T* y)
+{
+    for (int j = 0; j < m; ++j) y[j] = w[j] * x[j];
+}
+
+// y[j] += w[j] * x[j]
+template <typename T>
+inline void window_add(int m, const T* w, const T* x, T* y)
+{
+    for (int j = 0; j < m; ++j) y[j] += w[j] * x[j];
+}
+
+template <typename C>
+class STFTImpl : public BasicSTFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+    int hop_;
+    AlignedBuffer<T> window_;
+    AlignedBuffer<T> ring_;   // samples [head_, head_ + fill_) of the stream tail
+    AlignedBuffer<T> frame_;  // windowed frame
+    AlignedBuffer<T> work_;
+    int head_;
+    int fill_;
+
+    void push(const T* x, int m) {
+        const int n = size();
+        const int pos = (head_ + fill_) % n;
+        const int first = std::min(m, n - pos);
+        std::memcpy(ring_.data() + pos, x, first * sizeof(T));
+        std::memcpy(ring_.data(), x + first, (m - first) * sizeof(T));
+        fill_ += m;
+    }
+
+public:
+    STFTImpl(int n, int hop, const T* window, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().real_plan<T>(n, kern)), hop_(hop),
+          window_(n), ring_(n), frame_(n), work_(n), head_(0), fill_(0) {
+        check_stft_hop(n, hop);
+        if (window) std::memcpy(window_.data(), window, n * sizeof(T));
+        else hann_window(n, window_.data());
+    }
+
+    int size() const override { return plan_->size(); }
+    int hop() const override { return hop_; }
+
+    int frame_count(int count) const override {
+        const ptrdiff_t total = ptrdiff_t(fill_) + count;
+        return total < size() ? 0 : int((total - size()) / hop_ + 1);
+    }
+
+    int process(const T* in, int count, C* frames) override {
+        const int n = size();
+        const ptrdiff_t total = ptrdiff_t(fill_) + count;
+        const T* w = window_.data();
+        ptrdiff_t start = 0;
+        int k = 0;
+        for (; start + n <= total; start += hop_, ++k) {
+            // Frame samples [0, r) are still in the ring, possibly wrapped
+            const int r = int(std::max<ptrdiff_t>(0, std::min<ptrdiff_t>(n, fill_ - start)));
+            const int pos = int((head_ + start) % n);
+            const int r1 = std::min(r, n - pos);
+            window_copy(r1, w, ring_.data() + pos, frame_.data());
+            window_copy(r - r1, w + r1, ring_.data(), frame_.data() + r1);
+            if (r < n) window_copy(n - r, w + r, in + (start + r - fill_), frame_.data() + r);
+            plan_->fwd(kern_, frame_.data(), scalars(frames + ptrdiff_t(k) * this->bins()), work_.data());
+        }
+        // Keep samples [start, total) of this call's stream for the next one
+        if (start <= fill_) {
+            head_ = int((head_ + start) % n);
+            fill_ -= int(start);
+            push(in, count);
+        } else {
+            const int skip = int(start - fill_);
+            head_ = 0;
+            fill_ = 0;
+            push(in + skip, count - skip);
+        }
+        return k;
+    }
+
+    void reset() override {
+        head_ = 0;
+        fill_ = 0;
+    }
+};
+
+template <typename C>
+class ISTFTImpl : public BasicISTFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+    int hop_;
+    AlignedBuffer<T> synth_;  // analysis window over its overlap-added square
+    AlignedBuffer<T> acc_;    // overlap-add ring, starting at head_
+    AlignedBuffer<T> frame_;
+    AlignedBuffer<T> work_;
+    int head_;
+
+public:
+    ISTFTImpl(int n, int hop, const T* window, const KernelTable<T>& kern)
+        : kern_(kern), plan_(PlanCache::instance().real_plan<T>(n, kern)), hop_(hop),
+          synth_(n), acc_(n), frame_(n), work_(n), head_(0) {
+        check_stft_hop(n, hop);
+        if (window) std::memcpy(synth_.data(), window, n * sizeof(T));
+        else hann_window(n, synth_.data());
+        // Dual window: with s[j] = w[j] / sum_m w[j + m*hop]^2 the windowed
+        // frames overlap-add back to the signal for any window and hop
+        AlignedBuffer<double> norm(hop);
+        for (int j = 0; j < hop; ++j) norm[j] = 0;
+        for (int j = 0; j < n; ++j) norm[j % hop] += double(synth_[j]) * synth_[j];
+        for (int j = 0; j < hop; ++j) {
+            if (norm[j] == 0) {
+                throw std::invalid_argument("OTFFT ext: ISTFT window leaves samples uncovered at this hop");
+            }
+        }
+        for (int j = 0; j < n; ++j) synth_[j] = T(synth_[j] / norm[j % hop]);
+        reset();
+    }
+
+    int size() const override { return plan_->size(); }
+    int hop() const override { return hop_; }
+
+    void process(const C* frames, int count, T* out) override {
+        const int n = size();
+        const T* s = synth_.data();
+        T* acc = acc_.data();
+        for (int k = 0; k < count; ++k) {
+            plan_->inv(kern_, scalars(frames + ptrdiff_t(k) * this->bins()), frame_.data(), work_.data());
+            const int n1 = n - head_;
+            window_add(n1, s, frame_.data(), acc + head_);
+            window_add(head_, s + n1, frame_.data() + n1, acc);
+            // No later frame reaches the next hop samples: emit and clear them
+            T* y = out + ptrdiff_t(k) * hop_;
+            const int h1 = std::min(hop_, n1);
+            std::memcpy(y, acc + head_, h1 * sizeof(T));
+            std::memcpy(y + h1, acc, (hop_ - h1) * sizeof(T));
+            std::memset(acc + head_, 0, h1 * sizeof(T));
+            std::memset(acc, 0, (hop_ - h1) * sizeof(T));
+            head_ = (head_ + hop_) % n;
+        }
+    }
+
+    void reset() override {
+        std::memset(acc_.data(), 0, acc_.size() * sizeof(T));
+        head_ = 0;
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+// window: n analysis samples, or nullptr for a periodic Hann window
+inline STFTPtr createSTFT(int n, int hop, const double* window = nullptr)
+{
+    return STFTPtr(new detail::STFTImpl<complex_t>(n, hop, window, detail::active_kernels<double>()));
+}
+
+inline STFTfPtr createSTFTf(int n, int hop, const float* window = nullptr)
+{
+    return STFTfPtr(new detail::STFTImpl<complexf_t>(n, hop, window, detail::active_kernels<float>()));
+}
+
+// window: the analysis window the spectra were computed with
+inline ISTFTPtr createISTFT(int n, int hop, const double* window = nullptr)
+{
+    return ISTFTPtr(new detail::ISTFTImpl<complex_t>(n, hop, window, detail::active_kernels<double>()));
+}
+
+inline ISTFTfPtr createISTFTf(int n, int hop, const float* window = nullptr)
+{
+    return ISTFTfPtr(new detail::ISTFTImpl<complexf_t>(n, hop, window, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_STFT_H
@@ -0,0 +1,345 @@
+#ifndef OTFFT_EXT_WISDOM_H
+#define OTFFT_EXT_WISDOM_H
+
+// Measuring planner for complex transforms, and the "wisdom" it leaves.
+//
+// Upstream OTFFT::Factory and the FactoryExt transforms each pick their
+// variant by a fixed rule: upstream by its own, the extension by taking the
+// best ISA level and the radix that level prefers. Neither looks at what
+// actually runs fastest on this machine. createTunedFFT(n, TUNE_MEASURE)
+// times the candidates for the size:
+//   - upstream's ComplexFFT (complex_t only)
+//   - the extension kernels of every SIMD level up to CpuDispatch::active(),
+//     each with plans of radix-4 and with plans of radix-8 passes
+// and keeps the fastest, recording it in the process-wide Wisdom. Later
+// calls for that size and precision, in either mode, use the recorded
+// variant without measuring. Wisdom::save() writes the table as a
+// versioned text file, and Wisdom::load() merges one back. The file named
+// by the OTFFT_EXT_WISDOM environment variable is loaded when the table is
+// first used. Entries for ISA levels above the active one are ignored.
+// TUNE_ESTIMATE never measures: without wisdom it returns upstream's
+// transform for complex_t and the extension default for complexf_t.
+// fwd() is normalized by 1/N and inv() is unnormalized, as for ComplexFFT.
+//
+//   auto fft = OTFFT::FactoryExt::createTunedFFT(4096);   // measures once
+//   OTFFT::Wisdom::instance().save("app.wisdom");
+//   // later runs: OTFFT_EXT_WISDOM=app.wisdom, and nothing is measured
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "mixed_radix.h"
+#include "detail/complex_traits.h"
+
+namespace OTFFT {
+
+enum TuneMode {
+    TUNE_ESTIMATE,  // wisdom or the default variant, never measures
+    TUNE_MEASURE    // wisdom, or time the candidates and record the fastest
+};
+
+// One candidate of the planner
+struct FFTVariant {
+    bool upstream;  // OTFFT::Factory's transform; isa and radix unused
+    IsaLevel isa;
+    int radix;      // largest pass of the extension plans, 4 or 8
+
+    FFTVariant() : upstream(true), isa(ISA_SCALAR), radix(4) {}
+    FFTVariant(IsaLevel level, int max_radix) : upstream(false), isa(level), radix(max_radix) {}
+
+    bool operator==(const FFTVariant& o) const {
+        return upstream == o.upstream && (upstream || (isa == o.isa && radix == o.radix));
+    }
+
+    // "upstream" or "<isa> <radix>", as in the wisdom file
+    std::string name() const {
+        if (upstream) return "upstream";
+        std::ostringstream s;
+        s << CpuDispatch::name(isa) << ' ' << radix;
+        return s.str();
+    }
+};
+
+class Wisdom {
+public:
+    // First line of the file; tables of another version are not loaded
+    static const int kVersion = 1;
+
+    static Wisdom& instance() {
+        static Wisdom wisdom;
+        return wisdom;
+    }
+
+    // The variant recorded for n points of the given precision (sizeof the
+    // scalar type); false if there is none or it needs a higher ISA level
+    // than CpuDispatch::active()
+    bool lookup(int n, int precision, FFTVariant& v) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::pair<int, int>, FFTVariant>::const_iterator it = entries_.find(std::make_pair(precision, n));
+        if (it == entries_.end()) return false;
+        if (!it->second.upstream && it->second.isa > CpuDispatch::active()) return false;
+        v = it->second;
+        return true;
+    }
+
+    void record(int n, int precision, const FFTVariant& v) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[std::make_pair(precision, n)] = v;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    // "otfft-ext-wisdom <version>", then one "<float|double> <n> <variant>"
+    // line per entry
+    bool save(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out << "otfft-ext-wisdom " << kVersion << '\n';
+        for (const auto& e : entries_) {
+            out << (e.first.first == int(sizeof(float)) ? "float " : "double ") << e.first.second << ' '
+                << e.second.name() << '\n';
+        }
+        return bool(out);
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path.c_str());
+        return save(out) && bool(out.flush());
+    }
+
+    // Merges the entries of a table of this version; on a version mismatch
+    // or a malformed line returns false and changes nothing
+    bool load(std::istream& in) {
+        std::string line;
+        std::ostringstream header;
+        header << "otfft-ext-wisdom " << kVersion;
+        if (!std::getline(in, line) || line != header.str()) return false;
+        std::map<std::pair<int, int>, FFTVariant> read;
+        while (std::getline(in, line)) {
+            std::istringstream s(line);
+            std::string prec, variant;
+            int n = 0;
+            if (!(s >> prec)) continue;  // blank line
+            if (!(s >> n >> variant) || n < 1 || (prec != "float" && prec != "double")) return false;
+            const int precision = prec == "float" ? int(sizeof(float)) : int(sizeof(double));
+            FFTVariant v;
+            if (variant != "upstream") {
+                IsaLevel level;
+                if (!CpuDispatch::parse(variant.c_str(), level) || !(s >> v.radix)) return false;
+                if (v.radix != 4 && v.radix != 8) return false;
+                v = FFTVariant(level, v.radix);
+            } else if (precision != int(sizeof(double))) {
+                return false;
+            }
+            read[std::make_pair(precision, n)] = v;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& e : read) entries_[e.first] = e.second;
+        return true;
+    }
+
+    bool load(const std::string& path) {
+        std::ifstream in(path.c_str());
+        return in && load(in);
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::pair<int, int>, FFTVariant> entries_;  // (precision, n)
+
+    Wisdom() {
+        const char* path = std::getenv("OTFFT_EXT_WISDOM");
+        if (path) load(std::string(path));
+    }
+    Wisdom(const Wisdom&) = delete;
+    Wisdom& operator=(const Wisdom&) = delete;
+};
+
+template <typename C>
+class BasicTunedFFT {
+public:
+    virtual ~BasicTunedFFT() {}
+    virtual int size() const = 0;
+    // The variant this object runs
+    virtual FFTVariant variant() const = 0;
+    // In place on size() values
+    virtual void fwd(C* x) const = 0;
+    virtual void inv(C* x) const = 0;
+};
+
+typedef BasicTunedFFT<complex_t> TunedFFT;
+typedef BasicTunedFFT<complexf_t> TunedFFTf;
+
+typedef std::unique_ptr<TunedFFT> TunedFFTPtr;
+typedef std::unique_ptr<TunedFFTf> TunedFFTfPtr;
+
+namespace detail {
+
+// Upstream's transform, a candidate for complex_t only
+template <typename C>
+struct UpstreamFFT {
+    static const bool available = false;
+    static ComplexFFTPtr create(int) { return ComplexFFTPtr(); }
+    static void fwd(ComplexFFT&, C*) {}
+    static void inv(ComplexFFT&, C*) {}
+};
+
+template <>
+struct UpstreamFFT<complex_t> {
+    static const bool available = true;
+    static ComplexFFTPtr create(int n) { return Factory::createComplexFFT(n); }
+    static void fwd(ComplexFFT& f, complex_t* x) { f.fwd(x); }
+    static void inv(ComplexFFT& f, complex_t* x) { f.inv(x); }
+};
+
+template <typename C>
+class TunedFFTImpl : public BasicTunedFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    int n_;
+    FFTVariant variant_;
+    ComplexFFTPtr upstream_;
+    std::unique_ptr<BasicMixedRadixFFT<C>> ext_;
+
+public:
+    TunedFFTImpl(int n, const FFTVariant& v) : n_(n), variant_(v) {
+        if (v.upstream) upstream_ = UpstreamFFT<C>::create(n);
+        else ext_.reset(new MixedRadixFFTImpl<C>(n, kernels<T>(v.isa, v.radix)));
+    }
+
+    int size() const override { return n_; }
+    FFTVariant variant() const override { return variant_; }
+
+    void fwd(C* x) const override {
+        if (ext_) ext_->fwd(x);
+        else UpstreamFFT<C>::fwd(*upstream_, x);
+    }
+
+    void inv(C* x) const override {
+        if (ext_) ext_->inv(x);
+        else UpstreamFFT<C>::inv(*upstream_, x);
+    }
+};
+
+// Per candidate, the best of kTuneBatches timed batches of back-to-back
+// calls, each at least kTuneBatchSeconds long; batches that come out
+// shorter double the call count and count as warmup
+static const int kTuneBatches = 4;
+static const double kTuneBatchSeconds = 1e-3;
+
+template <typename F>
+inline double tune_time(F&& f)
+{
+    typedef std::chrono::steady_clock clock;
+    double best = HUGE_VAL;
+    for (int reps = 1, batch = 0; batch < kTuneBatches;) {
+        const clock::time_point t0 = clock::now();
+        for (int i = 0; i < reps; ++i) f();
+        const double s = std::chrono::duration<double>(clock::now() - t0).count();
+        if (s < kTuneBatchSeconds) {
+            reps *= 2;
+            continue;
+        }
+        best = std::min(best, s / reps);
+        ++batch;
+    }
+    return best;
+}
+
+template <typename C>
+inline FFTVariant default_variant()
+{
+    typedef typename complex_traits<C>::scalar T;
+    if (UpstreamFFT<C>::available) return FFTVariant();
+    const IsaLevel level = CpuDispatch::active();
+    return FFTVariant(level, kernels<T>(level).max_radix);
+}
+
+// Upstream, then every SIMD level up to the active one (scalar only when
+// there is nothing else) with both radices
+template <typename C>
+inline std::vector<FFTVariant> tune_candidates()
+{
+    std::vector<FFTVariant> v;
+    if (UpstreamFFT<C>::available) v.push_back(FFTVariant());
+    const IsaLevel top = CpuDispatch::active();
+    for (int i = top > ISA_SCALAR ? 1 : 0; i <= top; ++i) {
+        v.push_back(FFTVariant(IsaLevel(i), 4));
+        v.push_back(FFTVariant(IsaLevel(i), 8));
+    }
+    return v;
+}
+
+template <typename C>
+inline BasicTunedFFT<C>* create_tuned(int n, TuneMode mode)
+{
+    typedef typename complex_traits<C>::scalar T;
+    if (n < 1 || n > (1 << 29)) {
+        throw std::invalid_argument("OTFFT ext: transform size out of range");
+    }
+    const int precision = int(sizeof(T));
+    FFTVariant v;
+    if (Wisdom::instance().lookup(n, precision, v)) return new TunedFFTImpl<C>(n, v);
+    if (mode == TUNE_ESTIMATE) return new TunedFFTImpl<C>(n, default_variant<C>());
+
+    // fwd then inv (normalized once), so the data keeps its magnitude over
+    // the repetitions
+    std::vector<C> x(n);
+    for (int i = 0; i < n; ++i) x[i] = C(T(std::sin(0.37 * i)), T(std::cos(0.011 * i)));
+    std::unique_ptr<TunedFFTImpl<C>> best;
+    double best_time = HUGE_VAL;
+    for (const FFTVariant& c : tune_candidates<C>()) {
+        std::unique_ptr<TunedFFTImpl<C>> f(new TunedFFTImpl<C>(n, c));
+        const double t = tune_time([&]() {
+            f->fwd(x.data());
+            f->inv(x.data());
+        });
+        if (t < best_time) {
+            best_time = t;
+            best = std::move(f);
+        }
+    }
+    Wisdom::instance().record(n, precision, best->variant());
+    return best.release();
+}
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline TunedFFTPtr createTunedFFT(int n, TuneMode mode = TUNE_MEASURE)
+{
+    return TunedFFTPtr(detail::create_tuned<complex_t>(n, mode));
+}
+
+inline TunedFFTfPtr createTunedFFTf(int n, TuneMode mode = TUNE_MEASURE)
+{
+    return TunedFFTfPtr(detail::create_tuned<complexf_t>(n, mode));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_WISDOM_H
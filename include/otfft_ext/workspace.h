@@ -0,0 +1,162 @@
+#ifndef OTFFT_EXT_WORKSPACE_H
+#define OTFFT_EXT_WORKSPACE_H
+
+// Transforms that run on caller-supplied workspace, and an Arena that packs
+// the twiddle tables and workspaces of many plans into a few contiguous
+// blocks.
+//
+// workspace_size() is the scratch in bytes one call needs. Any pointer to
+// that many bytes works; 64-byte alignment (as Arena hands out) keeps
+// vectors from straddling cache lines. Built without an arena, an object
+// shares its plan through the PlanCache like the other FactoryExt objects.
+// Built on an arena, it gets a private plan whose tables live in the arena,
+// and the arena must outlive it. plan_bytes() reports the twiddle bytes
+// either way. fwd() is normalized by 1/N and inv() is unnormalized. Real
+// spectra hold the N/2+1 non-redundant bins.
+//
+//   OTFFT::Arena arena;
+//   auto fft = OTFFT::FactoryExt::createWorkspaceComplexFFT(N, &arena);
+//   void* work = arena.allocate(fft->workspace_size());
+//   fft->fwd(x, work);
+
+#include <memory>
+
+#include "otfft.h"
+#include "fft_float.h"
+#include "cpu_dispatch.h"
+#include "plan_cache.h"
+#include "detail/arena.h"
+#include "detail/complex_traits.h"
+#include "detail/real.h"
+#include "detail/stockham.h"
+
+namespace OTFFT {
+
+typedef detail::Arena Arena;
+
+template <typename C>
+class BasicWorkspaceComplexFFT {
+public:
+    virtual ~BasicWorkspaceComplexFFT() {}
+    virtual int size() const = 0;
+    virtual size_t plan_bytes() const = 0;
+    virtual size_t workspace_size() const = 0;
+
+    // In place on size() values; work: workspace_size() bytes
+    virtual void fwd(C* x, void* work) const = 0;
+    virtual void inv(C* x, void* work) const = 0;
+};
+
+template <typename C>
+class BasicWorkspaceRealFFT {
+public:
+    typedef typename detail::complex_traits<C>::scalar real_type;
+
+    virtual ~BasicWorkspaceRealFFT() {}
+    virtual int size() const = 0;
+    virtual size_t plan_bytes() const = 0;
+    virtual size_t workspace_size() const = 0;
+
+    // x: N reals -> y: N/2+1 bins
+    virtual void fwd(const real_type* x, C* y, void* work) const = 0;
+    // y: N/2+1 bins (only read) -> x: N reals
+    virtual void inv(const C* y, real_type* x, void* work) const = 0;
+};
+
+typedef BasicWorkspaceComplexFFT<complex_t> WorkspaceComplexFFT;
+typedef BasicWorkspaceComplexFFT<complexf_t> WorkspaceComplexFFTf;
+typedef BasicWorkspaceRealFFT<complex_t> WorkspaceRealFFT;
+typedef BasicWorkspaceRealFFT<complexf_t> WorkspaceRealFFTf;
+
+typedef std::unique_ptr<WorkspaceComplexFFT> WorkspaceComplexFFTPtr;
+typedef std::unique_ptr<WorkspaceComplexFFTf> WorkspaceComplexFFTfPtr;
+typedef std::unique_ptr<WorkspaceRealFFT> WorkspaceRealFFTPtr;
+typedef std::unique_ptr<WorkspaceRealFFTf> WorkspaceRealFFTfPtr;
+
+namespace detail {
+
+template <typename C>
+class WorkspaceComplexFFTImpl : public BasicWorkspaceComplexFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const StockhamPlan<T>> plan_;
+
+public:
+    WorkspaceComplexFFTImpl(int n, Arena* arena, const KernelTable<T>& kern)
+        : kern_(kern),
+          plan_(arena ? std::make_shared<const StockhamPlan<T> >(n, kern.lanes, kern.max_radix, arena)
+                      : PlanCache::instance().complex_plan<T>(n, kern)) {}
+
+    int size() const override { return plan_->size(); }
+    size_t plan_bytes() const override { return plan_->twiddle_bytes(); }
+    size_t workspace_size() const override { return 2 * size_t(size()) * sizeof(T); }
+
+    void fwd(C* x, void* work) const override {
+        T* p = reinterpret_cast<T*>(x);
+        kern_.fwd(*plan_, p, p, static_cast<T*>(work), T(1) / size());
+    }
+    void inv(C* x, void* work) const override {
+        T* p = reinterpret_cast<T*>(x);
+        kern_.inv(*plan_, p, p, static_cast<T*>(work), T(1));
+    }
+};
+
+template <typename C>
+class WorkspaceRealFFTImpl : public BasicWorkspaceRealFFT<C> {
+    typedef typename complex_traits<C>::scalar T;
+
+    const KernelTable<T>& kern_;
+    std::shared_ptr<const RealPlan<T>> plan_;
+
+public:
+    WorkspaceRealFFTImpl(int n, Arena* arena, const KernelTable<T>& kern)
+        : kern_(kern),
+          plan_(arena ? std::make_shared<const RealPlan<T> >(n, kern.lanes, kern.max_radix, arena)
+                      : PlanCache::instance().real_plan<T>(n, kern)) {}
+
+    int size() const override { return plan_->size(); }
+    size_t plan_bytes() const override { return plan_->twiddle_bytes(); }
+    size_t workspace_size() const override { return size_t(size()) * sizeof(T); }
+
+    void fwd(const T* x, C* y, void* work) const override {
+        plan_->fwd(kern_, x, reinterpret_cast<T*>(y), static_cast<T*>(work));
+    }
+    void inv(const C* y, T* x, void* work) const override {
+        plan_->inv(kern_, reinterpret_cast<const T*>(y), x, static_cast<T*>(work));
+    }
+};
+
+} // namespace detail
+
+namespace FactoryExt {
+
+inline WorkspaceComplexFFTPtr createWorkspaceComplexFFT(int n, Arena* arena = nullptr)
+{
+    return WorkspaceComplexFFTPtr(
+        new detail::WorkspaceComplexFFTImpl<complex_t>(n, arena, detail::active_kernels<double>()));
+}
+
+inline WorkspaceComplexFFTfPtr createWorkspaceComplexFFTf(int n, Arena* arena = nullptr)
+{
+    return WorkspaceComplexFFTfPtr(
+        new detail::WorkspaceComplexFFTImpl<complexf_t>(n, arena, detail::active_kernels<float>()));
+}
+
+inline WorkspaceRealFFTPtr createWorkspaceRealFFT(int n, Arena* arena = nullptr)
+{
+    return WorkspaceRealFFTPtr(
+        new detail::WorkspaceRealFFTImpl<complex_t>(n, arena, detail::active_kernels<double>()));
+}
+
+inline WorkspaceRealFFTfPtr createWorkspaceRealFFTf(int n, Arena* arena = nullptr)
+{
+    return WorkspaceRealFFTfPtr(
+        new detail::WorkspaceRealFFTImpl<complexf_t>(n, arena, detail::active_kernels<float>()));
+}
+
+} // namespace FactoryExt
+
+} // namespace OTFFT
+
+#endif // OTFFT_EXT_WORKSPACE_H
@@ -4,10 +4,36 @@
 #include <chrono>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <sstream>
+#include <cstdio>
+#include <fstream>
+#include <thread>
 
 // Include OTFFT headers
 #include "otfft.h"
 #include "otfft_fwd.h"
+#include "otfft_ext/fft_float.h"
+#include "otfft_ext/batch.h"
+#include "otfft_ext/cpu_dispatch.h"
+#include "otfft_ext/plan_cache.h"
+#include "otfft_ext/stft.h"
+#include "otfft_ext/convolution.h"
+#include "otfft_ext/fft_nd.h"
+#include "otfft_ext/split.h"
+#include "otfft_ext/real_compact.h"
+#include "otfft_ext/workspace.h"
+#include "otfft_ext/parallel.h"
+#include "otfft_ext/mixed_radix.h"
+#include "otfft_ext/partial.h"
+#include "otfft_ext/sliding_dft.h"
+#include "otfft_ext/fixed.h"
+#include "otfft_ext/wisdom.h"
+#include "otfft_ext/out_of_core.h"
+#include "otfft_ext/pipeline.h"
+#include "otfft_ext/dct.h"
 
 using namespace std;
 using complex_t = OTFFT::complex_t;
@@ -101,6 +127,1172 @@ void test_real_fft(int N) {
     cout << "  Total time:   " << fixed << setprecision(2) << (fwd_time + inv_time) << " μs" << endl;
 }
 
+// Test single-precision complex and real FFT (round trip)
+void test_float_fft(int N) {
+    cout << "\n--- Testing Float FFT (size: " << N << ") ---" << endl;
+    
+    vector<OTFFT::complexf_t> data(N), orig(N);
+    vector<float> realInput(N), realOutput(N);
+    for (int i = 0; i < N; ++i) {
+        double t = 2.0 * M_PI * i / N;
+        realInput[i] = float(sin(t) + 0.5 * sin(5.0 * t));
+        data[i] = orig[i] = OTFFT::complexf_t(realInput[i], 0.0f);
+    }
+    
+    auto fft = OTFFT::FactoryExt::createComplexFFTf(N);
+    auto rfft = OTFFT::FactoryExt::createRealFFTf(N);
+    
+    fft->fwd(data.data());
+    // sin(t) lands in bin 1 with magnitude 1/2 after the 1/N normalization
+    double bin_err = fabs(data[1].Im + 0.5);
+    fft->inv(data.data());
+    
+    vector<OTFFT::complexf_t> spectrum(N);
+    rfft->fwd(realInput.data(), spectrum.data());
+    rfft->inv(spectrum.data(), realOutput.data());
+    
+    double max_err = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, (double)fabs(data[i].Re - orig[i].Re));
+        max_err = max(max_err, (double)fabs(realOutput[i] - realInput[i]));
+    }
+    if (bin_err > 1e-4 || max_err > 1e-4) {
+        throw runtime_error("float FFT round trip error too large");
+    }
+    
+    double fwd_time = measure_time([&]() {
+        fft->fwd(data.data());
+    });
+    double rfwd_time = measure_time([&]() {
+        rfft->fwd(realInput.data(), spectrum.data());
+    });
+    
+    cout << "  Round trip max error: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Forward FFT:  " << fixed << setprecision(2) << fwd_time << " μs" << endl;
+    cout << "  Forward RFFT: " << fixed << setprecision(2) << rfwd_time << " μs" << endl;
+}
+
+// Test batched complex/real FFT against the single-transform objects
+void test_batch_fft(int N) {
+    cout << "\n--- Testing Batched FFT (size: " << N << ", 8 transforms) ---" << endl;
+    
+    const int count = 8;
+    vector<complex_t> data(N * count), ref(N * count);
+    vector<double> realInput(N * count), realOutput(N * count);
+    for (int i = 0; i < N * count; ++i) {
+        double t = 2.0 * M_PI * i / N;
+        realInput[i] = sin(t) + 0.5 * sin(5.0 * t) + 0.01 * (i / N);
+        data[i] = ref[i] = complex_t(realInput[i], 0.0);
+    }
+    
+    auto fft = OTFFT::Factory::createComplexFFT(N);
+    auto batch = OTFFT::FactoryExt::createBatchComplexFFT(N);
+    auto rbatch = OTFFT::FactoryExt::createBatchRealFFT(N);
+    
+    for (int b = 0; b < count; ++b) fft->fwd(ref.data() + b * N);
+    batch->fwd(count, data.data(), 1, N);
+    
+    double max_err = 0.0;
+    for (int i = 0; i < N * count; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - ref[i].Re) + fabs(data[i].Im - ref[i].Im));
+    }
+    
+    vector<complex_t> spectrum((N/2 + 1) * count);
+    rbatch->fwd(count, realInput.data(), 1, N, spectrum.data(), 1, N/2 + 1);
+    rbatch->inv(count, spectrum.data(), 1, N/2 + 1, realOutput.data(), 1, N);
+    for (int i = 0; i < N * count; ++i) {
+        max_err = max(max_err, fabs(realOutput[i] - realInput[i]));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("batched FFT mismatch");
+    }
+    
+    double batch_time = measure_time([&]() {
+        batch->fwd(count, data.data(), 1, N);
+    });
+    
+    cout << "  Max error vs single FFT: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Batched FFT: " << fixed << setprecision(2) << batch_time / count << " μs per transform" << endl;
+}
+
+// Test that repeated plan creation is served by the plan cache
+void test_plan_cache(int N) {
+    cout << "\n--- Testing Plan Cache (size: " << N << ") ---" << endl;
+    
+    OTFFT::PlanCache& cache = OTFFT::PlanCache::instance();
+    auto first = OTFFT::FactoryExt::createComplexFFTf(N);
+    OTFFT::PlanCache::Stats before = cache.stats();
+    auto second = OTFFT::FactoryExt::createComplexFFTf(N);
+    OTFFT::PlanCache::Stats after = cache.stats();
+    if (after.hits != before.hits + 1 || after.misses != before.misses) {
+        throw runtime_error("plan cache miss for a cached size");
+    }
+    
+    vector<OTFFT::complexf_t> a(N), b(N);
+    for (int i = 0; i < N; ++i) {
+        a[i] = b[i] = OTFFT::complexf_t(float(sin(0.3 * i)), float(cos(0.7 * i)));
+    }
+    first->fwd(a.data());
+    second->fwd(b.data());
+    for (int i = 0; i < N; ++i) {
+        if (a[i].Re != b[i].Re || a[i].Im != b[i].Im) {
+            throw runtime_error("cached plan result mismatch");
+        }
+    }
+    
+    // The same transform again on scratch trimmed back to its size
+    cache.trim_scratch();
+    for (int i = 0; i < N; ++i) {
+        b[i] = OTFFT::complexf_t(float(sin(0.3 * i)), float(cos(0.7 * i)));
+    }
+    second->fwd(b.data());
+    for (int i = 0; i < N; ++i) {
+        if (a[i].Re != b[i].Re || a[i].Im != b[i].Im) {
+            throw runtime_error("result mismatch after trimming the scratch");
+        }
+    }
+    
+    double create_time = measure_time([&]() {
+        auto fft = OTFFT::FactoryExt::createComplexFFTf(N);
+    });
+    
+    cout << "  Cache: " << after.hits << " hits, " << after.misses << " misses, "
+         << after.entries << " plans, " << after.bytes << " bytes" << endl;
+    cout << "  Cached plan creation: " << fixed << setprecision(2) << create_time << " μs" << endl;
+}
+
+// Test that every kernel level this CPU supports gives the scalar result
+void test_cpu_dispatch(int N) {
+    cout << "\n--- Testing CPU Dispatch (size: " << N << ", detected: "
+         << OTFFT::CpuDispatch::name(OTFFT::CpuDispatch::detected()) << ") ---" << endl;
+    
+    vector<OTFFT::complexf_t> input(N), ref(N), data(N);
+    vector<OTFFT::complex_t> inputd(N), refd(N), datad(N);
+    for (int i = 0; i < N; ++i) {
+        input[i] = OTFFT::complexf_t(float(sin(0.3 * i)), float(cos(0.7 * i)));
+        inputd[i] = OTFFT::complex_t(sin(0.3 * i), cos(0.7 * i));
+    }
+    
+    // Single precision through ComplexFFTf, double (radix-8 and 512-bit
+    // kernels at the AVX-512 level) through the batch API
+    double max_err = 0.0, max_err_d = 0.0;
+    for (int level = OTFFT::ISA_SCALAR; level <= OTFFT::CpuDispatch::detected(); ++level) {
+        OTFFT::CpuDispatch::force(OTFFT::IsaLevel(level));
+        auto fft = OTFFT::FactoryExt::createComplexFFTf(N);
+        auto fftd = OTFFT::FactoryExt::createBatchComplexFFT(N);
+        OTFFT::CpuDispatch::reset();
+        
+        data = input;
+        fft->fwd(data.data());
+        datad = inputd;
+        fftd->fwd(1, datad.data(), 1, N);
+        if (level == OTFFT::ISA_SCALAR) {
+            ref = data;
+            refd = datad;
+        }
+        for (int i = 0; i < N; ++i) {
+            max_err = max(max_err, double(fabs(data[i].Re - ref[i].Re) + fabs(data[i].Im - ref[i].Im)));
+            max_err_d = max(max_err_d, fabs(datad[i].Re - refd[i].Re) + fabs(datad[i].Im - refd[i].Im));
+        }
+    }
+    if (max_err > 1e-5 || max_err_d > 1e-12) {
+        throw runtime_error("ISA level results differ");
+    }
+    
+    cout << "  Max error vs scalar kernels: " << scientific << setprecision(2) << max_err
+         << " (float), " << max_err_d << " (double)" << endl;
+}
+
+// Test streaming STFT against windowed RealFFT frames and the ISTFT round trip
+void test_stft(int N) {
+    const int hop = N / 4;
+    cout << "\n--- Testing STFT (size: " << N << ", hop: " << hop << ") ---" << endl;
+    
+    const int len = 8 * N;
+    vector<double> signal(len), window(N), frame(N);
+    for (int i = 0; i < len; ++i) {
+        signal[i] = sin(0.05 * i) + 0.5 * cos(0.31 * i);
+    }
+    for (int j = 0; j < N; ++j) {
+        window[j] = 0.5 - 0.5 * cos(2.0 * M_PI * j / N);
+    }
+    
+    auto stft = OTFFT::FactoryExt::createSTFT(N, hop);
+    auto istft = OTFFT::FactoryExt::createISTFT(N, hop);
+    auto rfft = OTFFT::Factory::createRealFFT(N);
+    
+    // Feed uneven chunks; frames must match windowed RealFFTs of the stream
+    vector<complex_t> frames, chunk_frames, ref(N);
+    for (int pos = 0, chunk = 1; pos < len; pos += chunk, chunk = chunk * 3 % 97 + 1) {
+        chunk = min(chunk, len - pos);
+        chunk_frames.resize(stft->frame_count(chunk) * stft->bins());
+        int k = stft->process(signal.data() + pos, chunk, chunk_frames.data());
+        frames.insert(frames.end(), chunk_frames.begin(), chunk_frames.begin() + k * stft->bins());
+    }
+    const int count = int(frames.size()) / stft->bins();
+    if (count != (len - N) / hop + 1) {
+        throw runtime_error("STFT frame count mismatch");
+    }
+    
+    double max_err = 0.0;
+    for (int f = 0; f < count; ++f) {
+        for (int j = 0; j < N; ++j) frame[j] = window[j] * signal[f * hop + j];
+        rfft->fwd(frame.data(), ref.data());
+        for (int b = 0; b < stft->bins(); ++b) {
+            const complex_t& y = frames[f * stft->bins() + b];
+            max_err = max(max_err, fabs(y.Re - ref[b].Re) + fabs(y.Im - ref[b].Im));
+        }
+    }
+    
+    // Samples covered by a full set of overlapping frames come back exactly
+    vector<double> output(count * hop);
+    istft->process(frames.data(), count, output.data());
+    for (int i = N - hop; i < count * hop; ++i) {
+        max_err = max(max_err, fabs(output[i] - signal[i]));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("STFT mismatch");
+    }
+    
+    cout << "  Frames: " << count << ", max error: " << scientific << setprecision(2) << max_err << endl;
+}
+
+// Test partitioned convolution against a direct time-domain FIR filter
+void test_convolution(int N) {
+    const int taps = 3 * N + 5, block = N / 4;
+    cout << "\n--- Testing Convolution (taps: " << taps << ", block: " << block << ") ---" << endl;
+    
+    const int len = 4 * taps;
+    vector<double> h(taps), signal(len), output(len);
+    for (int k = 0; k < taps; ++k) {
+        h[k] = exp(-3.0 * k / taps) * sin(0.2 * k);
+    }
+    for (int i = 0; i < len; ++i) {
+        signal[i] = sin(0.05 * i) + 0.5 * cos(0.31 * i);
+    }
+    
+    // Uneven chunks, the last half in place
+    auto conv = OTFFT::FactoryExt::createConvolution(h.data(), taps, block);
+    int pos = 0;
+    for (int chunk = 1; pos < len / 2; pos += chunk, chunk = chunk * 5 % 211 + 1) {
+        chunk = min(chunk, len / 2 - pos);
+        conv->process(signal.data() + pos, chunk, output.data() + pos);
+    }
+    copy(signal.begin() + pos, signal.end(), output.begin() + pos);
+    conv->process(output.data() + pos, len - pos, output.data() + pos);
+    
+    double max_err = 0.0;
+    for (int t = 0; t < len; ++t) {
+        double ref = 0.0;
+        for (int k = 0; k < taps && k <= t - block; ++k) ref += h[k] * signal[t - block - k];
+        max_err = max(max_err, fabs(output[t] - ref));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("convolution mismatch");
+    }
+    
+    cout << "  Max error vs direct convolution: " << scientific << setprecision(2) << max_err << endl;
+}
+
+// Test 2D/3D transforms against 1D transforms along each axis
+void test_fft_nd(int N) {
+    const int rows = 16, depth = 4;
+    cout << "\n--- Testing 2D/3D FFT (" << rows << "x" << N << ", " << depth << "x" << rows << "x" << N << ") ---" << endl;
+    
+    const int total = depth * rows * N;
+    vector<double> realInput(total), realOutput(total);
+    vector<complex_t> data(total), ref(total), column(max(rows, depth));
+    for (int i = 0; i < total; ++i) {
+        realInput[i] = sin(0.013 * i) + 0.5 * cos(0.7 * (i % N)) + 0.1 * (i % 7);
+    }
+    for (int i = 0; i < total; ++i) {
+        data[i] = ref[i] = complex_t(realInput[i], 0.25 * realInput[total - 1 - i]);
+    }
+    
+    // 3D reference: contiguous rows, then columns of each slab, then depth
+    auto row_fft = OTFFT::Factory::createComplexFFT(N);
+    auto col_fft = OTFFT::Factory::createComplexFFT(rows);
+    auto depth_fft = OTFFT::Factory::createComplexFFT(depth);
+    for (int r = 0; r < depth * rows; ++r) row_fft->fwd(ref.data() + r * N);
+    for (int d = 0; d < depth; ++d) {
+        for (int c = 0; c < N; ++c) {
+            complex_t* p = ref.data() + d * rows * N + c;
+            for (int r = 0; r < rows; ++r) column[r] = p[r * N];
+            col_fft->fwd(column.data());
+            for (int r = 0; r < rows; ++r) p[r * N] = column[r];
+        }
+    }
+    for (int i = 0; i < rows * N; ++i) {
+        for (int d = 0; d < depth; ++d) column[d] = ref[d * rows * N + i];
+        depth_fft->fwd(column.data());
+        for (int d = 0; d < depth; ++d) ref[d * rows * N + i] = column[d];
+    }
+    
+    auto fft3 = OTFFT::FactoryExt::createComplexFFT3D(depth, rows, N);
+    fft3->fwd(data.data());
+    double max_err = 0.0;
+    for (int i = 0; i < total; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - ref[i].Re) + fabs(data[i].Im - ref[i].Im));
+    }
+    fft3->inv(data.data());
+    for (int i = 0; i < total; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - realInput[i]) + fabs(data[i].Im - 0.25 * realInput[total - 1 - i]));
+    }
+    
+    // 2D real-to-complex: the first N/2+1 bins of each row of the complex 2D transform
+    const int bins = N / 2 + 1;
+    for (int i = 0; i < rows * N; ++i) data[i] = complex_t(realInput[i], 0.0);
+    auto fft2 = OTFFT::FactoryExt::createComplexFFT2D(rows, N);
+    auto rfft2 = OTFFT::FactoryExt::createRealFFT2D(rows, N);
+    vector<complex_t> spectrum(rows * bins);
+    fft2->fwd(data.data());
+    rfft2->fwd(realInput.data(), spectrum.data());
+    for (int r = 0; r < rows; ++r) {
+        for (int k = 0; k < bins; ++k) {
+            const complex_t& a = spectrum[r * bins + k];
+            const complex_t& b = data[r * N + k];
+            max_err = max(max_err, fabs(a.Re - b.Re) + fabs(a.Im - b.Im));
+        }
+    }
+    rfft2->inv(spectrum.data(), realOutput.data());
+    for (int i = 0; i < rows * N; ++i) {
+        max_err = max(max_err, fabs(realOutput[i] - realInput[i]));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("multi-dimensional FFT mismatch");
+    }
+    
+    double fwd_time = measure_time([&]() {
+        fft2->fwd(data.data());
+    }, 100);
+    
+    cout << "  Max error vs 1D transforms: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  2D Forward FFT: " << fixed << setprecision(2) << fwd_time << " μs" << endl;
+}
+
+void test_split_fft(int N) {
+    cout << "\n--- Testing split-complex FFT (N=" << N << ") ---" << endl;
+    
+    vector<complex_t> data(N);
+    vector<double> re(N), im(N), outRe(N), outIm(N);
+    for (int i = 0; i < N; ++i) {
+        re[i] = sin(2.0 * M_PI * i / N) + 0.3 * cos(0.11 * i);
+        im[i] = 0.5 * cos(6.0 * M_PI * i / N) - 0.2 * sin(0.07 * i);
+        data[i] = complex_t(re[i], im[i]);
+    }
+    
+    auto ref = OTFFT::Factory::createComplexFFT(N);
+    auto fft = OTFFT::FactoryExt::createSplitComplexFFT(N);
+    ref->fwd(data.data());
+    fft->fwd(re.data(), im.data(), outRe.data(), outIm.data());
+    double max_err = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, fabs(outRe[i] - data[i].Re) + fabs(outIm[i] - data[i].Im));
+    }
+    fft->inv(outRe.data(), outIm.data());
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, fabs(outRe[i] - re[i]) + fabs(outIm[i] - im[i]));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("split-complex FFT mismatch");
+    }
+    
+    double fwd_time = measure_time([&]() {
+        fft->fwd(re.data(), im.data(), outRe.data(), outIm.data());
+    }, 1000);
+    
+    cout << "  Max error vs interleaved: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Split Forward FFT: " << fixed << setprecision(2) << fwd_time << " μs" << endl;
+}
+
+void test_compact_real_fft(int N) {
+    cout << "\n--- Testing compact real FFT (N=" << N << ", " << N / 2 + 1 << " bins) ---" << endl;
+    
+    vector<double> realInput(N), realOutput(N);
+    for (int i = 0; i < N; ++i) {
+        realInput[i] = sin(2.0 * M_PI * 3.0 * i / N) + 0.4 * cos(0.21 * i) + (i % 2 ? 0.1 : -0.1);
+    }
+    vector<complex_t> full(N);
+    OTFFT::Factory::createRealFFT(N)->fwd(realInput.data(), full.data());
+    
+    auto rfft = OTFFT::FactoryExt::createCompactRealFFT(N);
+    auto packed = OTFFT::FactoryExt::createCompactRealFFT(N, OTFFT::PACKED_NYQUIST);
+    if (rfft->bins() != N / 2 + 1 || packed->bins() != N / 2) {
+        throw runtime_error("compact real FFT bin count mismatch");
+    }
+    vector<complex_t> half(rfft->bins()), pack(packed->bins());
+    rfft->fwd(realInput.data(), half.data());
+    packed->fwd(realInput.data(), pack.data());
+    double max_err = 0.0;
+    for (int k = 0; k <= N / 2; ++k) {
+        max_err = max(max_err, fabs(half[k].Re - full[k].Re) + fabs(half[k].Im - full[k].Im));
+    }
+    max_err = max(max_err, fabs(pack[0].Re - full[0].Re) + fabs(pack[0].Im - full[N / 2].Re));
+    for (int k = 1; k < N / 2; ++k) {
+        max_err = max(max_err, fabs(pack[k].Re - full[k].Re) + fabs(pack[k].Im - full[k].Im));
+    }
+    rfft->inv(half.data(), realOutput.data());
+    for (int i = 0; i < N; ++i) max_err = max(max_err, fabs(realOutput[i] - realInput[i]));
+    packed->inv(pack.data(), realOutput.data());
+    for (int i = 0; i < N; ++i) max_err = max(max_err, fabs(realOutput[i] - realInput[i]));
+    if (max_err > 1e-9) {
+        throw runtime_error("compact real FFT mismatch");
+    }
+    
+    double fwd_time = measure_time([&]() {
+        rfft->fwd(realInput.data(), half.data());
+    }, 1000);
+    
+    cout << "  Max error vs RealFFT: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Compact Forward RFFT: " << fixed << setprecision(2) << fwd_time << " μs" << endl;
+}
+
+void test_workspace(int N) {
+    cout << "\n--- Testing caller workspace and arena (N=" << N << ") ---" << endl;
+    
+    vector<complex_t> data(N), ref(N), spectrum(N / 2 + 1);
+    vector<double> realInput(N), realOutput(N);
+    for (int i = 0; i < N; ++i) {
+        realInput[i] = sin(2.0 * M_PI * 5.0 * i / N) + 0.3 * cos(0.17 * i);
+        data[i] = ref[i] = complex_t(realInput[i], 0.5 * sin(0.05 * i));
+    }
+    
+    // Plans and workspaces for both transforms packed into one arena
+    OTFFT::Arena arena;
+    auto fft = OTFFT::FactoryExt::createWorkspaceComplexFFT(N, &arena);
+    void* work = arena.allocate(fft->workspace_size());
+    auto rfft = OTFFT::FactoryExt::createWorkspaceRealFFT(N, &arena);
+    void* rwork = arena.allocate(rfft->workspace_size());
+    const size_t expected = fft->plan_bytes() + fft->workspace_size() + rfft->plan_bytes() + rfft->workspace_size();
+    if (arena.used() < expected || arena.blocks() != 1) {
+        throw runtime_error("arena accounting mismatch");
+    }
+    
+    OTFFT::Factory::createComplexFFT(N)->fwd(ref.data());
+    fft->fwd(data.data(), work);
+    double max_err = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - ref[i].Re) + fabs(data[i].Im - ref[i].Im));
+    }
+    vector<complex_t> full(N);
+    OTFFT::Factory::createRealFFT(N)->fwd(realInput.data(), full.data());
+    rfft->fwd(realInput.data(), spectrum.data(), rwork);
+    for (int k = 0; k <= N / 2; ++k) {
+        max_err = max(max_err, fabs(spectrum[k].Re - full[k].Re) + fabs(spectrum[k].Im - full[k].Im));
+    }
+    rfft->inv(spectrum.data(), realOutput.data(), rwork);
+    for (int i = 0; i < N; ++i) max_err = max(max_err, fabs(realOutput[i] - realInput[i]));
+    
+    // Without an arena the plan comes from the PlanCache; the caller's
+    // workspace is still used
+    auto shared = OTFFT::FactoryExt::createWorkspaceComplexFFT(N);
+    vector<complex_t> heapWork(N);
+    shared->inv(data.data(), heapWork.data());
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - realInput[i]) + fabs(data[i].Im - 0.5 * sin(0.05 * i)));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("workspace FFT mismatch");
+    }
+    
+    double fwd_time = measure_time([&]() {
+        fft->fwd(data.data(), work);
+        fft->inv(data.data(), work);
+    }, 1000);
+    
+    cout << "  Max error vs Factory: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Arena bytes for 2 plans: " << arena.used() << endl;
+    cout << "  Forward+Inverse FFT: " << fixed << setprecision(2) << fwd_time << " μs" << endl;
+}
+
+// Runs every task on the calling thread, in reverse order: stands in for
+// an application's own executor
+class SerialExecutor : public OTFFT::Executor {
+public:
+    int concurrency() const override { return 1; }
+    void parallel_for(int count, const std::function<void(int)>& task) override {
+        for (int i = count - 1; i >= 0; --i) task(i);
+    }
+};
+
+void test_parallel_fft(int N) {
+    // 2^18 points and up take the six-step path
+    const int n = N * 256;
+    cout << "\n--- Testing parallel FFT (n=" << n << ") ---" << endl;
+    
+    vector<complex_t> data(n), ref(n), work(n);
+    for (int i = 0; i < n; ++i) {
+        data[i] = ref[i] = complex_t(sin(0.001 * i) + 0.1 * (i % 5), cos(0.013 * i));
+    }
+    auto single = OTFFT::FactoryExt::createWorkspaceComplexFFT(n);
+    single->fwd(ref.data(), work.data());
+    
+    OTFFT::WorkStealingPool pool(4);
+    SerialExecutor serial;
+    auto fft = OTFFT::FactoryExt::createParallelComplexFFT(n, &pool);
+    auto own = OTFFT::FactoryExt::createParallelComplexFFT(n, &serial);
+    vector<complex_t> copy(data);
+    fft->fwd(data.data());
+    own->fwd(copy.data());
+    double max_err = 0.0;
+    for (int i = 0; i < n; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - ref[i].Re) + fabs(data[i].Im - ref[i].Im));
+        max_err = max(max_err, fabs(copy[i].Re - ref[i].Re) + fabs(copy[i].Im - ref[i].Im));
+    }
+    fft->inv(data.data());
+    for (int i = 0; i < n; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - (sin(0.001 * i) + 0.1 * (i % 5))) + fabs(data[i].Im - cos(0.013 * i)));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("parallel FFT mismatch");
+    }
+    
+    double fwd_time = measure_time([&]() {
+        fft->fwd(data.data());
+        fft->inv(data.data());
+    }, 10);
+    
+    cout << "  Max error vs single-threaded: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Forward+Inverse FFT (4 threads): " << fixed << setprecision(2) << fwd_time << " μs" << endl;
+}
+
+// Test mixed-radix and Bluestein sizes around N against a direct DFT
+void test_mixed_radix_fft(int N) {
+    // 2^k*3, 2^k*5, 2^k*7, 2^k*105 and N+1 (which has a prime factor above 7)
+    const int ns[] = {3 * N / 4, 5 * N / 8, 7 * N / 8, 105 * N / 128, N + 1};
+    cout << "\n--- Testing Mixed-Radix FFT (sizes around " << N << ") ---" << endl;
+    
+    double max_err = 0.0;
+    for (int n : ns) {
+        vector<complex_t> data(n), ref(n);
+        for (int i = 0; i < n; ++i) {
+            data[i] = complex_t(sin(0.37 * i) + 0.1 * (i % 7), cos(0.011 * i * i));
+        }
+        for (int k = 0; k < n; ++k) {
+            double re = 0.0, im = 0.0;
+            for (int i = 0; i < n; ++i) {
+                const double t = -2.0 * M_PI * double((long long)i * k % n) / n;
+                re += data[i].Re * cos(t) - data[i].Im * sin(t);
+                im += data[i].Re * sin(t) + data[i].Im * cos(t);
+            }
+            ref[k] = complex_t(re / n, im / n);
+        }
+        vector<complex_t> orig(data);
+        auto fft = OTFFT::FactoryExt::createMixedRadixFFT(n);
+        if (fft->bluestein() == OTFFT::detail::is_smooth(n)) {
+            throw runtime_error("mixed-radix FFT picked the wrong algorithm");
+        }
+        fft->fwd(data.data());
+        for (int k = 0; k < n; ++k) {
+            max_err = max(max_err, fabs(data[k].Re - ref[k].Re) + fabs(data[k].Im - ref[k].Im));
+        }
+        fft->inv(data.data());
+        for (int i = 0; i < n; ++i) {
+            max_err = max(max_err, fabs(data[i].Re - orig[i].Re) + fabs(data[i].Im - orig[i].Im));
+        }
+        
+        // Single precision, and the real transform at even smooth sizes
+        auto fftf = OTFFT::FactoryExt::createMixedRadixFFTf(n);
+        vector<OTFFT::complexf_t> dataf(n);
+        for (int i = 0; i < n; ++i) dataf[i] = OTFFT::complexf_t(float(orig[i].Re), float(orig[i].Im));
+        fftf->fwd(dataf.data());
+        double errf = 0.0;
+        for (int k = 0; k < n; ++k) {
+            errf = max(errf, fabs(dataf[k].Re - ref[k].Re) + fabs(dataf[k].Im - ref[k].Im));
+        }
+        if (n % 2 == 0 && OTFFT::detail::is_smooth(n)) {
+            auto rfft = OTFFT::FactoryExt::createRealFFTf(n);
+            vector<float> x(n), back(n);
+            vector<OTFFT::complexf_t> spectrum(n);
+            for (int i = 0; i < n; ++i) x[i] = float(orig[i].Re);
+            rfft->fwd(x.data(), spectrum.data());
+            rfft->inv(spectrum.data(), back.data());
+            for (int i = 0; i < n; ++i) errf = max(errf, double(fabs(back[i] - x[i])));
+        }
+        if (errf > 1e-4) {
+            throw runtime_error("single-precision mixed-radix FFT mismatch");
+        }
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("mixed-radix FFT mismatch");
+    }
+    
+    const int n = 3 * N / 4;
+    vector<complex_t> data(n, complex_t(1.0, 0.5));
+    auto fft = OTFFT::FactoryExt::createMixedRadixFFT(n);
+    auto chirp = OTFFT::FactoryExt::createMixedRadixFFT(N + 1);
+    vector<complex_t> data1(N + 1, complex_t(1.0, 0.5));
+    double mixed_time = measure_time([&]() {
+        fft->fwd(data.data());
+    });
+    double chirp_time = measure_time([&]() {
+        chirp->fwd(data1.data());
+    });
+    
+    cout << "  Max error vs direct DFT: " << scientific << setprecision(2) << max_err << endl;
+    cout << "  Forward FFT (n=" << n << "):  " << fixed << setprecision(2) << mixed_time << " μs" << endl;
+    cout << "  Forward FFT (n=" << N + 1 << ", Bluestein): " << fixed << setprecision(2) << chirp_time << " μs" << endl;
+}
+
+void test_partial_fft(int N) {
+    cout << "\n--- Testing Partial FFT (N=" << N << ") ---" << endl;
+    
+    // Harmonics of bin 3, plus N+1 (a prime factor above 7, no pruning)
+    const int ns[] = {N, N + 1};
+    double max_err = 0.0, max_errf = 0.0;
+    for (int n : ns) {
+        vector<int> bins;
+        for (int k = 3; k < n; k += 3 * (1 + int(bins.size()) / 8)) bins.push_back(k);
+        vector<complex_t> data(n);
+        vector<OTFFT::complexf_t> dataf(n);
+        for (int i = 0; i < n; ++i) {
+            data[i] = complex_t(sin(0.37 * i) + 0.1 * (i % 7), cos(0.011 * i * i));
+            dataf[i] = OTFFT::complexf_t(float(data[i].Re), float(data[i].Im));
+        }
+        vector<complex_t> ref(bins.size());
+        for (size_t j = 0; j < bins.size(); ++j) {
+            double re = 0.0, im = 0.0;
+            for (int i = 0; i < n; ++i) {
+                const double t = -2.0 * M_PI * double((long long)i * bins[j] % n) / n;
+                re += data[i].Re * cos(t) - data[i].Im * sin(t);
+                im += data[i].Re * sin(t) + data[i].Im * cos(t);
+            }
+            ref[j] = complex_t(re / n, im / n);
+        }
+        
+        const OTFFT::PartialMethod methods[] = {
+            OTFFT::PARTIAL_AUTO, OTFFT::PARTIAL_GOERTZEL, OTFFT::PARTIAL_PRUNED, OTFFT::PARTIAL_FULL
+        };
+        for (OTFFT::PartialMethod m : methods) {
+            if (m == OTFFT::PARTIAL_PRUNED && n == N + 1) continue;
+            auto pfft = OTFFT::FactoryExt::createPartialFFT(n, bins.data(), int(bins.size()), m);
+            auto pfftf = OTFFT::FactoryExt::createPartialFFTf(n, bins.data(), int(bins.size()), m);
+            if (m != OTFFT::PARTIAL_AUTO && pfft->method() != m) {
+                throw runtime_error("partial FFT ignored the requested method");
+            }
+            vector<complex_t> out(bins.size());
+            vector<OTFFT::complexf_t> outf(bins.size());
+            pfft->fwd(data.data(), out.data());
+            pfftf->fwd(dataf.data(), outf.data());
+            for (size_t j = 0; j < bins.size(); ++j) {
+                max_err = max(max_err, fabs(out[j].Re - ref[j].Re) + fabs(out[j].Im - ref[j].Im));
+                max_errf = max(max_errf, fabs(outf[j].Re - ref[j].Re) + fabs(outf[j].Im - ref[j].Im));
+            }
+        }
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("partial FFT mismatch");
+    }
+    if (max_errf > 1e-4) {
+        throw runtime_error("single-precision partial FFT mismatch");
+    }
+    
+    // A handful of bins, as for a line-frequency monitor
+    int few[8];
+    for (int j = 0; j < 8; ++j) few[j] = (j + 1) * N / 16;
+    vector<complex_t> data(N, complex_t(1.0, 0.5)), out(8), spectrum(N);
+    auto pfft = OTFFT::FactoryExt::createPartialFFT(N, few, 8);
+    auto goertzel = OTFFT::FactoryExt::createPartialFFT(N, few, 8, OTFFT::PARTIAL_GOERTZEL);
+    auto full = OTFFT::Factory::createComplexFFT(N);
+    double auto_time = measure_time([&]() {
+        pfft->fwd(data.data(), out.data());
+    });
+    double goertzel_time = measure_time([&]() {
+        goertzel->fwd(data.data(), out.data());
+    });
+    double full_time = measure_time([&]() {
+        spectrum = data;
+        full->fwd(spectrum.data());
+    });
+    
+    static const char* const names[] = {"auto", "Goertzel", "pruned", "full"};
+    cout << "  Max error vs direct DFT: " << scientific << setprecision(2) << max_err
+         << " (float " << max_errf << ")" << endl;
+    cout << "  8 bins, auto (" << names[pfft->method()] << "): " << fixed << setprecision(2) << auto_time << " μs" << endl;
+    cout << "  8 bins, Goertzel: " << fixed << setprecision(2) << goertzel_time << " μs" << endl;
+    cout << "  Full ComplexFFT:  " << fixed << setprecision(2) << full_time << " μs" << endl;
+}
+
+// Test the sliding DFT against RealFFTs of the window behind each hop
+void test_sliding_dft(int N) {
+    const int hop = N / 8;
+    cout << "\n--- Testing Sliding DFT (size: " << N << ", hop: " << hop << ") ---" << endl;
+    
+    const int len = 4 * N;
+    vector<double> signal(len), frame(N);
+    for (int i = 0; i < len; ++i) {
+        signal[i] = sin(0.05 * i) + 0.5 * cos(0.31 * i) + 0.1 * (i % 5);
+    }
+    
+    auto sdft = OTFFT::FactoryExt::createSlidingDFT(N, hop);
+    auto sdftf = OTFFT::FactoryExt::createSlidingDFTf(N, hop);
+    auto rfft = OTFFT::Factory::createRealFFT(N);
+    const int nb = sdft->bins();
+    
+    // Uneven chunks; the frame after sample t covers t-N+1..t, zeros first
+    vector<float> signalf(signal.begin(), signal.end());
+    vector<complex_t> frames(size_t(len / hop) * nb), ref(N);
+    vector<OTFFT::complexf_t> framesf(frames.size());
+    int count = 0, countf = 0;
+    for (int pos = 0, chunk = 1; pos < len; pos += chunk, chunk = chunk * 3 % 97 + 1) {
+        chunk = min(chunk, len - pos);
+        count += sdft->process(signal.data() + pos, chunk, frames.data() + size_t(count) * nb);
+        countf += sdftf->process(signalf.data() + pos, chunk, framesf.data() + size_t(countf) * nb);
+    }
+    if (count != len / hop || countf != count) {
+        throw runtime_error("sliding DFT frame count mismatch");
+    }
+    
+    double max_err = 0.0, max_errf = 0.0;
+    for (int f = 0; f < count; ++f) {
+        const int end = (f + 1) * hop;
+        for (int j = 0; j < N; ++j) frame[j] = end - N + j >= 0 ? signal[end - N + j] : 0.0;
+        rfft->fwd(frame.data(), ref.data());
+        for (int b = 0; b < nb; ++b) {
+            const complex_t& y = frames[size_t(f) * nb + b];
+            const OTFFT::complexf_t& yf = framesf[size_t(f) * nb + b];
+            max_err = max(max_err, fabs(y.Re - ref[b].Re) + fabs(y.Im - ref[b].Im));
+            max_errf = max(max_errf, fabs(yf.Re - ref[b].Re) + fabs(yf.Im - ref[b].Im));
+        }
+    }
+    
+    // A few bins with damping: sample j samples old weighs r^j
+    const int bins[] = {1, N / 3, N - 1};
+    const double r = 0.999;
+    auto damped = OTFFT::FactoryExt::createSlidingDFT(N, bins, 3, 1, r);
+    vector<complex_t> spectra(3 * size_t(len)), out(3);
+    damped->process(signal.data(), len, spectra.data());
+    damped->spectrum(out.data());
+    for (int b = 0; b < 3; ++b) {
+        double re = 0.0, im = 0.0;
+        for (int j = 0; j < N; ++j) {
+            const double t = -2.0 * M_PI * double((long long)bins[b] * j % N) / N;
+            const double w = pow(r, N - 1 - j) * signal[len - N + j];
+            re += w * cos(t);
+            im += w * sin(t);
+        }
+        max_err = max(max_err, fabs(out[b].Re - re / N) + fabs(out[b].Im - im / N));
+    }
+    if (max_err > 1e-9) {
+        throw runtime_error("sliding DFT mismatch");
+    }
+    if (max_errf > 1e-4) {
+        throw runtime_error("single-precision sliding DFT mismatch");
+    }
+    
+    // One hop of updates against one RealFFT of the window
+    double sdft_time = measure_time([&]() {
+        sdft->process(signal.data(), hop, frames.data());
+    });
+    double fft_time = measure_time([&]() {
+        rfft->fwd(frame.data(), ref.data());
+    });
+    
+    cout << "  Frames: " << count << ", max error: " << scientific << setprecision(2) << max_err
+         << " (float " << max_errf << ")" << endl;
+    cout << "  Sliding DFT, " << hop << " samples: " << fixed << setprecision(2) << sdft_time << " μs" << endl;
+    cout << "  RealFFT per hop:       " << fixed << setprecision(2) << fft_time << " μs" << endl;
+}
+
+// Test the measuring planner and the round trip of its wisdom through a file
+void test_tuned_fft(int N) {
+    cout << "\n--- Testing Tuned FFT (N=" << N << ") ---" << endl;
+    
+    OTFFT::Wisdom& wisdom = OTFFT::Wisdom::instance();
+    wisdom.clear();
+    auto tuned = OTFFT::FactoryExt::createTunedFFT(N);
+    auto tunedf = OTFFT::FactoryExt::createTunedFFTf(N);
+    auto fft = OTFFT::Factory::createComplexFFT(N);
+    
+    vector<complex_t> data(N), ref(N);
+    vector<OTFFT::complexf_t> dataf(N);
+    for (int i = 0; i < N; ++i) {
+        data[i] = ref[i] = complex_t(sin(0.37 * i) + 0.1 * (i % 7), cos(0.011 * i * i));
+        dataf[i] = OTFFT::complexf_t(float(data[i].Re), float(data[i].Im));
+    }
+    tuned->fwd(data.data());
+    tunedf->fwd(dataf.data());
+    fft->fwd(ref.data());
+    double max_err = 0.0, max_errf = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, fabs(data[i].Re - ref[i].Re) + fabs(data[i].Im - ref[i].Im));
+        max_errf = max(max_errf, fabs(dataf[i].Re - ref[i].Re) + fabs(dataf[i].Im - ref[i].Im));
+    }
+    if (max_err > 1e-12) {
+        throw runtime_error("tuned FFT mismatch");
+    }
+    if (max_errf > 1e-5) {
+        throw runtime_error("single-precision tuned FFT mismatch");
+    }
+    
+    // Saved, forgotten and loaded back, the wisdom gives the same variants
+    // without measuring; a table of another version is refused
+    const char* path = "otfft_ext_test.wisdom";
+    if (wisdom.size() != 2 || !wisdom.save(path)) {
+        throw runtime_error("tuned FFT did not record its wisdom");
+    }
+    wisdom.clear();
+    const bool loaded = wisdom.load(path);
+    remove(path);
+    auto estimated = OTFFT::FactoryExt::createTunedFFT(N, OTFFT::TUNE_ESTIMATE);
+    auto estimatedf = OTFFT::FactoryExt::createTunedFFTf(N, OTFFT::TUNE_ESTIMATE);
+    if (!loaded || !(estimated->variant() == tuned->variant()) || !(estimatedf->variant() == tunedf->variant())) {
+        throw runtime_error("wisdom round trip mismatch");
+    }
+    istringstream old("otfft-ext-wisdom 0\ndouble 64 upstream\n");
+    if (wisdom.load(old) || wisdom.size() != 2) {
+        throw runtime_error("wisdom of another version was loaded");
+    }
+    
+    double tuned_time = measure_time([&]() {
+        tuned->fwd(data.data());
+    });
+    double fft_time = measure_time([&]() {
+        fft->fwd(ref.data());
+    });
+    
+    cout << "  Variant: " << tuned->variant().name() << " (float " << tunedf->variant().name() << ")" << endl;
+    cout << "  Max error vs ComplexFFT: " << scientific << setprecision(2) << max_err
+         << " (float " << max_errf << ")" << endl;
+    cout << "  Tuned FFT:  " << fixed << setprecision(2) << tuned_time << " μs" << endl;
+    cout << "  ComplexFFT: " << fixed << setprecision(2) << fft_time << " μs" << endl;
+}
+
+#ifdef OTFFT_EXT_HAS_OUT_OF_CORE
+// Test the file-to-file transform against ComplexFFT, with a memory budget
+// small enough for many strips and blocks, then the inverse in place on the
+// output file
+void test_out_of_core_fft(int N) {
+    cout << "\n--- Testing Out-of-Core FFT (N=" << N << ") ---" << endl;
+    
+    const char* in_path = "otfft_ext_test_ooc.in";
+    const char* out_path = "otfft_ext_test_ooc.out";
+    auto write_file = [](const char* path, const void* p, size_t bytes) {
+        ofstream f(path, ios::binary);
+        f.write(static_cast<const char*>(p), streamsize(bytes));
+        if (!f.flush()) throw runtime_error(string("cannot write ") + path);
+    };
+    auto read_file = [](const char* path, void* p, size_t bytes) {
+        ifstream f(path, ios::binary);
+        if (!f.read(static_cast<char*>(p), streamsize(bytes))) throw runtime_error(string("cannot read ") + path);
+    };
+    
+    auto ooc = OTFFT::FactoryExt::createOutOfCoreFFT(N, 4096);
+    auto oocf = OTFFT::FactoryExt::createOutOfCoreFFTf(N, 4096);
+    auto fft = OTFFT::Factory::createComplexFFT(N);
+    
+    vector<complex_t> data(N), ref(N), out(N);
+    vector<OTFFT::complexf_t> dataf(N), outf(N);
+    for (int i = 0; i < N; ++i) {
+        data[i] = ref[i] = complex_t(sin(0.37 * i) + 0.1 * (i % 7), cos(0.011 * i * i));
+        dataf[i] = OTFFT::complexf_t(float(data[i].Re), float(data[i].Im));
+    }
+    write_file(in_path, data.data(), N * sizeof(complex_t));
+    ooc->fwd(in_path, out_path);
+    read_file(out_path, out.data(), N * sizeof(complex_t));
+    fft->fwd(ref.data());
+    double max_err = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_err = max(max_err, fabs(out[i].Re - ref[i].Re) + fabs(out[i].Im - ref[i].Im));
+    }
+    if (max_err > 1e-12) {
+        throw runtime_error("out-of-core FFT mismatch");
+    }
+    
+    ooc->inv(out_path, out_path);
+    read_file(out_path, out.data(), N * sizeof(complex_t));
+    double max_rt = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_rt = max(max_rt, fabs(out[i].Re - data[i].Re) + fabs(out[i].Im - data[i].Im));
+    }
+    if (max_rt > 1e-12) {
+        throw runtime_error("out-of-core FFT in-place round trip mismatch");
+    }
+    
+    write_file(in_path, dataf.data(), N * sizeof(OTFFT::complexf_t));
+    oocf->fwd(in_path, out_path);
+    read_file(out_path, outf.data(), N * sizeof(OTFFT::complexf_t));
+    double max_errf = 0.0;
+    for (int i = 0; i < N; ++i) {
+        max_errf = max(max_errf, fabs(outf[i].Re - ref[i].Re) + fabs(outf[i].Im - ref[i].Im));
+    }
+    if (max_errf > 1e-5) {
+        throw runtime_error("single-precision out-of-core FFT mismatch");
+    }
+    
+    // A file of the wrong length is refused
+    bool refused = false;
+    try {
+        ooc->fwd(in_path, out_path);
+    } catch (const invalid_argument&) {
+        refused = true;
+    }
+    
+    write_file(in_path, data.data(), N * sizeof(complex_t));
+    double ooc_time = measure_time([&]() {
+        ooc->fwd(in_path, out_path);
+    }, 20);
+    remove(in_path);
+    remove(out_path);
+    if (!refused) {
+        throw runtime_error("out-of-core FFT accepted a file of the wrong size");
+    }
+    
+    cout << "  Max error vs ComplexFFT: " << scientific << setprecision(2) << max_err
+         << " (float " << max_errf << ", round trip " << max_rt << ")" << endl;
+    cout << "  Out-of-core FFT (4 KiB budget): " << fixed << setprecision(2) << ooc_time << " μs" << endl;
+}
+#endif // OTFFT_EXT_HAS_OUT_OF_CORE
+
+// Test the threaded block pipeline against the one-shot transforms
+void test_fft_pipeline(int N) {
+    cout << "\n--- Testing FFT pipeline (N=" << N << ") ---" << endl;
+    
+    const int blocks = 64;
+    auto signal = [N](unsigned long long b, int i) {
+        return sin(0.37 * i + 0.5 * double(b)) + 0.1 * ((i + int(b)) % 7);
+    };
+    auto pipe = OTFFT::FactoryExt::createRealFFTPipeline(N, 4, 0);
+    auto rfft = OTFFT::FactoryExt::createCompactRealFFT(N);
+    if (pipe->capacity() != 4 || pipe->input_length() != N || pipe->bins() != N / 2 + 1) {
+        throw runtime_error("FFT pipeline shape mismatch");
+    }
+    
+    // Acquisition thread: retries while the ring is full
+    thread producer([&]() {
+        for (int b = 0; b < blocks; ++b) {
+            double* x;
+            while (!(x = pipe->acquire_input())) this_thread::yield();
+            for (int i = 0; i < N; ++i) x[i] = signal(b, i);
+            pipe->submit_input();
+        }
+    });
+    vector<double> x(N);
+    vector<complex_t> ref(N / 2 + 1);
+    double max_err = 0.0, total_us = 0.0;
+    bool in_order = true;
+    for (int b = 0; b < blocks; ++b) {
+        OTFFT::PipelineBlock info;
+        const complex_t* y = pipe->wait_spectrum(&info);
+        in_order = in_order && info.sequence == (unsigned long long)b && info.transformed_ns >= info.submitted_ns;
+        for (int i = 0; i < N; ++i) x[i] = signal(info.sequence, i);
+        rfft->fwd(x.data(), ref.data());
+        for (int k = 0; k <= N / 2; ++k) {
+            max_err = max(max_err, fabs(y[k].Re - ref[k].Re) + fabs(y[k].Im - ref[k].Im));
+        }
+        total_us += (OTFFT::detail::steady_ns() - info.submitted_ns) * 1e-3;
+        pipe->release_spectrum();
+    }
+    producer.join();
+    if (!in_order) {
+        throw runtime_error("FFT pipeline block order mismatch");
+    }
+    if (max_err > 1e-12) {
+        throw runtime_error("FFT pipeline real spectrum mismatch");
+    }
+    
+    // A full ring refuses the next block instead of blocking
+    auto cpipe = OTFFT::FactoryExt::createComplexFFTPipelinef(N, 3);
+    auto fft = OTFFT::Factory::createComplexFFT(N);
+    vector<complex_t> data(N);
+    for (int i = 0; i < N; ++i) data[i] = complex_t(sin(0.37 * i) + 0.1 * (i % 7), cos(0.011 * i * i));
+    for (int b = 0; b < cpipe->capacity(); ++b) {
+        float* z = cpipe->acquire_input();
+        if (!z) {
+            throw runtime_error("FFT pipeline refused a block with free slots");
+        }
+        for (int i = 0; i < N; ++i) {
+            z[2 * i] = float(data[i].Re);
+            z[2 * i + 1] = float(data[i].Im);
+        }
+        cpipe->submit_input();
+    }
+    if (cpipe->capacity() != 4 || cpipe->acquire_input() || cpipe->overruns() != 1) {
+        throw runtime_error("FFT pipeline overrun mismatch");
+    }
+    fft->fwd(data.data());
+    double max_errf = 0.0;
+    for (int b = 0; b < cpipe->capacity(); ++b) {
+        const OTFFT::complexf_t* y = cpipe->wait_spectrum();
+        for (int k = 0; k < N; ++k) {
+            max_errf = max(max_errf, fabs(y[k].Re - data[k].Re) + fabs(y[k].Im - data[k].Im));
+        }
+        cpipe->release_spectrum();
+    }
+    if (cpipe->acquire_spectrum() || !cpipe->acquire_input()) {
+        throw runtime_error("FFT pipeline did not drain");
+    }
+    if (max_errf > 1e-5) {
+        throw runtime_error("single-precision FFT pipeline complex spectrum mismatch");
+    }
+    
+    cout << "  Max error vs CompactRealFFT: " << scientific << setprecision(2) << max_err
+         << " (complex float vs ComplexFFT " << max_errf << ")" << endl;
+    cout << "  Transform thread " << (pipe->pinned() ? "pinned to CPU 0" : "not pinned")
+         << ", mean submit-to-consume latency: " << fixed << setprecision(2) << total_us / blocks << " μs" << endl;
+}
+
+// Test the DCT/DST family and the MDCT against their direct sums
+void test_r2r_transforms(int N) {
+    cout << "\n--- Testing DCT/DST I-IV and MDCT (N=" << N << ") ---" << endl;
+    
+    const char* names[] = {"DCT-I", "DCT-II", "DCT-III", "DCT-IV", "DST-I", "DST-II", "DST-III", "DST-IV"};
+    // FFTW's REDFT/RODFT definitions; type I runs at N+1 (DCT) and N-1 (DST)
+    auto direct = [](OTFFT::R2RKind kind, const vector<double>& x, int k) {
+        const int n = int(x.size());
+        double s = 0.0;
+        switch (kind) {
+        case OTFFT::DCT_I:
+            s = x[0] + (k % 2 ? -x[n - 1] : x[n - 1]);
+            for (int j = 1; j < n - 1; ++j) s += 2 * x[j] * cos(M_PI * j * k / (n - 1));
+            break;
+        case OTFFT::DCT_II:
+            for (int j = 0; j < n; ++j) s += 2 * x[j] * cos(M_PI * (2 * j + 1) * k / (2.0 * n));
+            break;
+        case OTFFT::DCT_III:
+            s = x[0];
+            for (int j = 1; j < n; ++j) s += 2 * x[j] * cos(M_PI * j * (2 * k + 1) / (2.0 * n));
+            break;
+        case OTFFT::DCT_IV:
+            for (int j = 0; j < n; ++j) s += 2 * x[j] * cos(M_PI * (2 * j + 1) * (2 * k + 1) / (4.0 * n));
+            break;
+        case OTFFT::DST_I:
+            for (int j = 0; j < n; ++j) s += 2 * x[j] * sin(M_PI * (j + 1) * (k + 1) / (n + 1.0));
+            break;
+        case OTFFT::DST_II:
+            for (int j = 0; j < n; ++j) s += 2 * x[j] * sin(M_PI * (2 * j + 1) * (k + 1) / (2.0 * n));
+            break;
+        case OTFFT::DST_III:
+            s = k % 2 ? -x[n - 1] : x[n - 1];
+            for (int j = 0; j < n - 1; ++j) s += 2 * x[j] * sin(M_PI * (j + 1) * (2 * k + 1) / (2.0 * n));
+            break;
+        case OTFFT::DST_IV:
+            for (int j = 0; j < n; ++j) s += 2 * x[j] * sin(M_PI * (2 * j + 1) * (2 * k + 1) / (4.0 * n));
+            break;
+        }
+        return s;
+    };
+    
+    double max_err = 0.0, max_errf = 0.0;
+    for (int kind = OTFFT::DCT_I; kind <= OTFFT::DST_IV; ++kind) {
+        const OTFFT::R2RKind r2r = OTFFT::R2RKind(kind);
+        const int n = r2r == OTFFT::DCT_I ? N + 1 : r2r == OTFFT::DST_I ? N - 1 : N;
+        auto t = OTFFT::FactoryExt::createR2R(n, r2r);
+        auto tf = OTFFT::FactoryExt::createR2Rf(n, r2r);
+        vector<double> x(n), y(n), z(n);
+        vector<float> xf(n), yf(n);
+        for (int i = 0; i < n; ++i) {
+            x[i] = z[i] = sin(0.37 * i) + 0.1 * (i % 7);
+            xf[i] = float(x[i]);
+        }
+        t->execute(x.data(), y.data());
+        t->execute(z.data(), z.data());
+        tf->execute(xf.data(), yf.data());
+        double err = 0.0, errf = 0.0, scale = 0.0;
+        for (int k = 0; k < n; ++k) {
+            const double ref = direct(r2r, x, k);
+            scale = max(scale, fabs(ref));
+            err = max(err, max(fabs(y[k] - ref), fabs(z[k] - ref)));
+            errf = max(errf, fabs(yf[k] - ref));
+        }
+        if (err > 1e-11 * scale) {
+            throw runtime_error(string(names[kind]) + " mismatch");
+        }
+        if (errf > 1e-5 * scale) {
+            throw runtime_error(string("single-precision ") + names[kind] + " mismatch");
+        }
+        max_err = max(max_err, err / scale);
+        max_errf = max(max_errf, errf / scale);
+    }
+    
+    // Sine-windowed MDCT blocks with a hop of N overlap-add back to the signal
+    auto mdct = OTFFT::FactoryExt::createMDCT(N);
+    const int blocks = 8;
+    vector<double> signal((blocks + 1) * N), out((blocks + 1) * N, 0.0), coef(N), block(2 * N);
+    for (size_t i = 0; i < signal.size(); ++i) signal[i] = sin(0.37 * i) + 0.1 * (i % 7);
+    for (int b = 0; b < blocks; ++b) {
+        mdct->fwd(signal.data() + b * N, coef.data());
+        mdct->inv(coef.data(), block.data());
+        for (int i = 0; i < 2 * N; ++i) out[b * N + i] += block[i];
+    }
+    double max_tdac = 0.0;
+    for (int i = N; i < blocks * N; ++i) max_tdac = max(max_tdac, fabs(out[i] - signal[i]));
+    // One coefficient against the direct sum
+    mdct->fwd(signal.data(), coef.data());
+    double x1 = 0.0;
+    for (int i = 0; i < 2 * N; ++i) {
+        x1 += sin(M_PI * (i + 0.5) / (2.0 * N)) * signal[i] * cos(M_PI / N * (i + 0.5 + N / 2.0) * 1.5);
+    }
+    if (max_tdac > 1e-12 || fabs(coef[1] - x1) > 1e-9) {
+        throw runtime_error("MDCT mismatch");
+    }
+    
+    auto dct2 = OTFFT::FactoryExt::createR2R(N, OTFFT::DCT_II);
+    vector<double> y(N);
+    double dct_time = measure_time([&]() {
+        dct2->execute(signal.data(), y.data());
+    });
+    double mdct_time = measure_time([&]() {
+        mdct->fwd(signal.data(), coef.data());
+    });
+    
+    cout << "  Max relative error vs direct sums: " << scientific << setprecision(2) << max_err
+         << " (float " << max_errf << ", MDCT overlap-add " << max_tdac << ")" << endl;
+    cout << "  DCT-II: " << fixed << setprecision(2) << dct_time << " μs, MDCT fwd (2N samples): "
+         << mdct_time << " μs" << endl;
+}
+
+// Test a compile-time size codelet against a direct DFT
+template <int N>
+void test_fixed_fft() {
+    cout << "\n--- Testing FixedFFT<" << N << "> ---" << endl;
+    
+    complex_t data[N], out[N], back[N];
+    OTFFT::complexf_t dataf[N];
+    for (int i = 0; i < N; ++i) {
+        data[i] = complex_t(sin(0.37 * i) + 0.1 * (i % 7), cos(0.011 * i * i));
+        dataf[i] = OTFFT::complexf_t(float(data[i].Re), float(data[i].Im));
+    }
+    OTFFT::FixedFFT<N>::fwd(data, out);
+    OTFFT::FixedFFT<N>::fwd(dataf);
+    for (int i = 0; i < N; ++i) back[i] = out[i];
+    OTFFT::FixedFFT<N>::inv(back);
+    
+    double max_err = 0.0, max_errf = 0.0;
+    for (int k = 0; k < N; ++k) {
+        double re = 0.0, im = 0.0;
+        for (int i = 0; i < N; ++i) {
+            const double t = -2.0 * M_PI * double(i * k % N) / N;
+            re += data[i].Re * cos(t) - data[i].Im * sin(t);
+            im += data[i].Re * sin(t) + data[i].Im * cos(t);
+        }
+        max_err = max(max_err, fabs(out[k].Re - re / N) + fabs(out[k].Im - im / N));
+        max_errf = max(max_errf, fabs(dataf[k].Re - re / N) + fabs(dataf[k].Im - im / N));
+        max_err = max(max_err, fabs(back[k].Re - data[k].Re) + fabs(back[k].Im - data[k].Im));
+    }
+    if (max_err > 1e-12) {
+        throw runtime_error("FixedFFT mismatch");
+    }
+    if (max_errf > 1e-5) {
+        throw runtime_error("single-precision FixedFFT mismatch");
+    }
+    
+    double fixed_time = measure_time([&]() {
+        OTFFT::FixedFFT<N>::fwd(data, out);
+    });
+    cout << "  Max error vs direct DFT: " << scientific << setprecision(2) << max_err
+         << " (float " << max_errf << ")" << endl;
+    cout << "  FixedFFT fwd:   " << fixed << setprecision(3) << fixed_time << " μs" << endl;
+    if ((N & (N - 1)) == 0) {
+        auto fft = OTFFT::Factory::createComplexFFT(N);
+        double fft_time = measure_time([&]() {
+            for (int i = 0; i < N; ++i) out[i] = data[i];
+            fft->fwd(out);
+        });
+        cout << "  ComplexFFT fwd: " << fixed << setprecision(3) << fft_time << " μs" << endl;
+    }
+}
+
 int main() {
     cout << "========================================" << endl;
     cout << "OTFFT Performance Test Suite" << endl;
@@ -121,6 +1313,129 @@ int main() {
             test_real_fft(N);
         }
         
+        // Test single-precision FFT for all sizes
+        cout << "\n========== FLOAT FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_float_fft(N);
+        }
+        
+        // Test batched FFT for all sizes
+        cout << "\n========== BATCHED FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_batch_fft(N);
+        }
+        
+        // Test plan cache for all sizes
+        cout << "\n========== PLAN CACHE TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_plan_cache(N);
+        }
+        
+        // Test CPU dispatch for all sizes
+        cout << "\n========== CPU DISPATCH TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_cpu_dispatch(N);
+        }
+        
+        // Test streaming STFT for all sizes
+        cout << "\n========== STFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_stft(N);
+        }
+        
+        // Test partitioned convolution for all sizes
+        cout << "\n========== CONVOLUTION TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_convolution(N);
+        }
+        
+        // Test 2D/3D FFT for all sizes
+        cout << "\n========== MULTI-DIMENSIONAL FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_fft_nd(N);
+        }
+        
+        // Test split-complex FFT for all sizes
+        cout << "\n========== SPLIT FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_split_fft(N);
+        }
+        
+        // Test half-spectrum real FFT for all sizes
+        cout << "\n========== COMPACT REAL FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_compact_real_fft(N);
+        }
+        
+        // Test caller workspace and arena for all sizes
+        cout << "\n========== WORKSPACE TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_workspace(N);
+        }
+        
+        // Test parallel FFT for all sizes
+        cout << "\n========== PARALLEL FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_parallel_fft(N);
+        }
+        
+        // Test mixed-radix FFT for all sizes
+        cout << "\n========== MIXED-RADIX FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_mixed_radix_fft(N);
+        }
+        
+        // Test partial-output FFT for all sizes
+        cout << "\n========== PARTIAL FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_partial_fft(N);
+        }
+        
+        // Test sliding DFT for all sizes
+        cout << "\n========== SLIDING DFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_sliding_dft(N);
+        }
+        
+        // Test fixed-size codelets: radix 2 and 4, unrolled and looped primes
+        cout << "\n========== FIXED-SIZE FFT TESTS ==========" << endl;
+        test_fixed_fft<2>();
+        test_fixed_fft<3>();
+        test_fixed_fft<7>();
+        test_fixed_fft<8>();
+        test_fixed_fft<12>();
+        test_fixed_fft<16>();
+        test_fixed_fft<31>();
+        test_fixed_fft<32>();
+        test_fixed_fft<60>();
+        test_fixed_fft<64>();
+        
+        // Test the measuring planner for all sizes
+        cout << "\n========== TUNED FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_tuned_fft(N);
+        }
+        
+#ifdef OTFFT_EXT_HAS_OUT_OF_CORE
+        // Test the file-to-file transform for all sizes
+        cout << "\n========== OUT-OF-CORE FFT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_out_of_core_fft(N);
+        }
+#endif
+        
+        // Test the threaded block pipeline for all sizes
+        cout << "\n========== FFT PIPELINE TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_fft_pipeline(N);
+        }
+        
+        // Test the DCT/DST family and the MDCT for all sizes
+        cout << "\n========== DCT/DST AND MDCT TESTS ==========" << endl;
+        for (int N : sizes) {
+            test_r2r_transforms(N);
+        }
+        
         cout << "\n========================================" << endl;
         cout << "All tests completed successfully!" << endl;
         cout << "========================================" << endl;